@@ -89,6 +89,7 @@ function(build_erf_lib erf_lib_name)
        ${SRC_DIR}/Derive.cpp
        ${SRC_DIR}/ERF.cpp
        ${SRC_DIR}/ERF_make_new_level.cpp
+       ${SRC_DIR}/ERF_LoadBalance.cpp
        ${SRC_DIR}/ERF_Tagging.cpp
        ${SRC_DIR}/Advection/AdvectionSrcForMom.cpp
        ${SRC_DIR}/Advection/AdvectionSrcForState.cpp
@@ -106,6 +107,7 @@ function(build_erf_lib erf_lib_name)
        ${SRC_DIR}/BoundaryConditions/ERF_PhysBCFunct.cpp
        ${SRC_DIR}/Diffusion/DiffusionSrcForMom_N.cpp
        ${SRC_DIR}/Diffusion/DiffusionSrcForMom_T.cpp
+       ${SRC_DIR}/Diffusion/DiffusionSrcForMomMatrixFree_N.cpp
        ${SRC_DIR}/Diffusion/DiffusionSrcForState_N.cpp
        ${SRC_DIR}/Diffusion/DiffusionSrcForState_T.cpp
        ${SRC_DIR}/Diffusion/ComputeStress_N.cpp
@@ -113,6 +115,7 @@ function(build_erf_lib erf_lib_name)
        ${SRC_DIR}/Diffusion/ComputeStrain_N.cpp
        ${SRC_DIR}/Diffusion/ComputeStrain_T.cpp
        ${SRC_DIR}/Diffusion/ComputeTurbulentViscosity.cpp
+       ${SRC_DIR}/Diffusion/ImplicitVertDiffusion.cpp
        ${SRC_DIR}/Diffusion/NumericalDiffusion.cpp
        ${SRC_DIR}/Diffusion/PBLModels.cpp
        ${SRC_DIR}/Initialization/ERF_init_custom.cpp
@@ -157,11 +160,9 @@ function(build_erf_lib erf_lib_name)
        ${SRC_DIR}/Microphysics/Kessler/Init_Kessler.cpp
        ${SRC_DIR}/Microphysics/Kessler/Kessler.cpp
        ${SRC_DIR}/Microphysics/Kessler/Diagnose_Kessler.cpp
-       ${SRC_DIR}/Microphysics/Kessler/Update_Kessler.cpp
        ${SRC_DIR}/Microphysics/FastEddy/Init_FE.cpp
        ${SRC_DIR}/Microphysics/FastEddy/FastEddy.cpp
        ${SRC_DIR}/Microphysics/FastEddy/Diagnose_FE.cpp
-       ${SRC_DIR}/Microphysics/FastEddy/Update_FE.cpp
   )
 
   if(NOT "${erf_exe_name}" STREQUAL "erf_unit_tests")
@@ -63,6 +63,8 @@ ABLMost::update_fluxes (const int& lev,
 
 /**
  * Function to compute the fluxes (u^star and t^star) for Monin Obukhov similarity theory.
+ * Each surface cell iterates independently in registers and exits as soon as it has converged.
+ * If most.report_iterations is set we also reduce and print the iteration counts.
  *
  * @param[in] lev Current level
  * @param[in] max_iters maximum iterations to use
@@ -74,11 +76,22 @@ ABLMost::compute_fluxes (const int& lev,
                          const int& max_iters,
                          const FluxIter& most_flux)
 {
+    BL_PROFILE("ABLMost::compute_fluxes()");
+
     // Pointers to the computed averages
     const auto *const tm_ptr  = m_ma.get_average(lev,2);
     const auto *const umm_ptr = m_ma.get_average(lev,3);
 
-    for (MFIter mfi(*u_star[lev]); mfi.isValid(); ++mfi)
+    // Iteration statistics: number of cells, total iterations, max iterations, unconverged cells
+    ReduceOps<ReduceOpSum, ReduceOpSum, ReduceOpMax, ReduceOpSum> reduce_op;
+    ReduceData<Long, Long, int, Long> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+    const bool report_iters = m_report_iters;
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(*u_star[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
     {
         Box gtbx = mfi.growntilebox();
 
@@ -91,11 +104,37 @@ ABLMost::compute_fluxes (const int& lev,
         const auto umm_arr = umm_ptr->array(mfi);
         const auto z0_arr  = z_0[lev].array();
 
-        ParallelFor(gtbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
-        {
-            most_flux.iterate_flux(i, j, k, max_iters, z0_arr, umm_arr, tm_arr,
-                                   u_star_arr, t_star_arr, t_surf_arr, olen_arr);
-        });
+        if (report_iters) {
+            reduce_op.eval(gtbx, reduce_data,
+            [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept -> ReduceTuple
+            {
+                int iter = most_flux.iterate_flux(i, j, k, max_iters, z0_arr, umm_arr, tm_arr,
+                                                  u_star_arr, t_star_arr, t_surf_arr, olen_arr);
+                return { 1, iter, iter, (iter > max_iters) ? 1 : 0 };
+            });
+        } else {
+            ParallelFor(gtbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
+            {
+                most_flux.iterate_flux(i, j, k, max_iters, z0_arr, umm_arr, tm_arr,
+                                       u_star_arr, t_star_arr, t_surf_arr, olen_arr);
+            });
+        }
+    }
+
+    if (report_iters) {
+        ReduceTuple hv = reduce_data.value(reduce_op);
+        Long ncells      = amrex::get<0>(hv);
+        Long iters_sum   = amrex::get<1>(hv);
+        int  iters_max   = amrex::get<2>(hv);
+        Long unconverged = amrex::get<3>(hv);
+        ParallelDescriptor::ReduceLongSum(ncells);
+        ParallelDescriptor::ReduceLongSum(iters_sum);
+        ParallelDescriptor::ReduceIntMax(iters_max);
+        ParallelDescriptor::ReduceLongSum(unconverged);
+        amrex::Print() << "MOST iterations at level " << lev << ": mean "
+                       << static_cast<Real>(iters_sum) / static_cast<Real>(amrex::max(ncells,Long(1)))
+                       << ", max " << iters_max << ", unconverged cells " << unconverged
+                       << " of " << ncells << std::endl;
     }
 }
 
@@ -1,4 +1,5 @@
 #include <ERF_FillPatcher.H>
+#include <algorithm>
 
 using namespace amrex;
 
@@ -74,6 +75,8 @@ void ERFFillPatcher::Define (BoxArray const& fba, DistributionMapping const& fdm
     // Delete old MFs if they exist
     if (m_cf_crse_data_old) m_cf_crse_data_old.reset();
     if (m_cf_crse_data_new) m_cf_crse_data_new.reset();
+    if (m_cf_crse_data_interp) m_cf_crse_data_interp.reset();
+    if (m_cf_slopes) m_cf_slopes.reset();
     if (m_cf_mask) m_cf_mask.reset();
 
     // Index type for the BL/BA
@@ -95,9 +98,28 @@ void ERFFillPatcher::Define (BoxArray const& fba, DistributionMapping const& fdm
     // Box arrays for the coarse data
     BoxArray cf_cba(std::move(cbl));
 
-    // Two coarse patches to hold the data to be interpolated
-    m_cf_crse_data_old = std::make_unique<MultiFab> (cf_cba, fdm, m_ncomp, 0);
-    m_cf_crse_data_new = std::make_unique<MultiFab> (cf_cba, fdm, m_ncomp, 0);
+    // Two coarse patches to hold the data to be interpolated and one for
+    // the data interpolated in time
+    m_cf_crse_data_old    = std::make_unique<MultiFab> (cf_cba, fdm, m_ncomp, 0);
+    m_cf_crse_data_new    = std::make_unique<MultiFab> (cf_cba, fdm, m_ncomp, 0);
+    m_cf_crse_data_interp = std::make_unique<MultiFab> (cf_cba, fdm, m_ncomp, 0);
+
+    // Coarse slopes for cell cons linear interpolation
+    if (m_ixt.cellCentered()) {
+        BoxList sbl;
+        sbl.set(m_ixt);
+        sbl.reserve(cf_cba.size());
+        for (int i(0); i<cf_cba.size(); ++i) {
+            Box cslope_bx(cf_cba[i]);
+            for (int dim = 0; dim < AMREX_SPACEDIM; dim++) {
+                if (m_ratio[dim] > 1) {
+                    cslope_bx.grow(dim,-1);
+                }
+            }
+            sbl.push_back(cslope_bx);
+        }
+        m_cf_slopes = std::make_unique<MultiFab> (BoxArray(std::move(sbl)), fdm, m_ncomp*AMREX_SPACEDIM, 0);
+    }
 
     // Integer masking array
     m_cf_mask = std::make_unique<iMultiFab> (fba, fdm, 1, 0);
@@ -110,6 +132,9 @@ void ERFFillPatcher::Define (BoxArray const& fba, DistributionMapping const& fdm
         m_cf_mask->setVal(m_relax_mask);
     }
     BuildMask(fba,nghost,m_relax_mask-1);
+
+    // Cache the cells to be filled for each mask value
+    BuildIndexLists();
 }
 
 void ERFFillPatcher::BuildMask (BoxArray const& fba,
@@ -155,6 +180,63 @@ void ERFFillPatcher::BuildMask (BoxArray const& fba,
     }
 }
 
+/*
+ * Build the lists of fine cells in the set and relax regions of each box
+ * (and, for cell-centered data, the coarse cells whose slopes they need) so that
+ * the fills only touch these cells rather than sweeping the whole fine box.
+ * This is only done when the grids change.
+ */
+void ERFFillPatcher::BuildIndexLists ()
+{
+    const bool is_cell = m_fba.ixType().cellCentered();
+
+    for (int m(0); m<2; ++m) {
+        m_fine_cells[m].define(m_fba, m_fdm);
+        m_crse_cells[m].define(m_fba, m_fdm);
+    }
+
+    for (MFIter mfi(*m_cf_mask); mfi.isValid(); ++mfi) {
+        const Box& vbx = mfi.validbox();
+
+        // Host copy of the mask on this box
+        BaseFab<int> hmask(vbx, 1, The_Pinned_Arena());
+        hmask.copy<RunOn::Device>((*m_cf_mask)[mfi], vbx, 0, vbx, 0, 1);
+        Gpu::streamSynchronize();
+        const auto& hmask_arr = hmask.const_array();
+
+        for (int m(0); m<2; ++m) {
+            const int mask_val = m + 1; // relax or set
+
+            Vector<IntVect> fine_list;
+            amrex::LoopOnCpu(vbx, [&] (int i, int j, int k) noexcept
+            {
+                if (hmask_arr(i,j,k) == mask_val) fine_list.push_back(IntVect(AMREX_D_DECL(i,j,k)));
+            });
+
+            Vector<IntVect> crse_list;
+            if (is_cell) {
+                BaseFab<int> cmark((*m_cf_slopes)[mfi].box(), 1, The_Cpu_Arena());
+                cmark.setVal<RunOn::Host>(0);
+                for (auto const& iv : fine_list) {
+                    IntVect civ = amrex::coarsen(iv, m_ratio);
+                    if (cmark(civ) == 0) {
+                        cmark(civ) = 1;
+                        crse_list.push_back(civ);
+                    }
+                }
+            }
+
+            auto& fine_cells = m_fine_cells[m][mfi];
+            auto& crse_cells = m_crse_cells[m][mfi];
+            fine_cells.resize(fine_list.size());
+            crse_cells.resize(crse_list.size());
+            Gpu::copyAsync(Gpu::hostToDevice, fine_list.begin(), fine_list.end(), fine_cells.begin());
+            Gpu::copyAsync(Gpu::hostToDevice, crse_list.begin(), crse_list.end(), crse_cells.begin());
+            Gpu::streamSynchronize();
+        }
+    }
+}
+
 /*
  * Register the coarse data to be used by the ERFFillPatcher
  *
@@ -192,28 +274,36 @@ void ERFFillPatcher::InterpFace (MultiFab& fine,
 {
   int ncomp = m_ncomp;
   IntVect ratio = m_ratio;
+  int m = mask_val - 1;
 
   for (MFIter mfi(fine); mfi.isValid(); ++mfi) {
       Box const& fbx = mfi.validbox();
 
       Array4<Real> const&       fine_arr = fine.array(mfi);
       Array4<Real const> const& crse_arr = crse.const_array(mfi);
-      Array4<int const> const&  mask_arr = m_cf_mask->const_array(mfi);
+
+      const auto& fine_cells = m_fine_cells[m][mfi];
+      const int nfine = static_cast<int>(fine_cells.size());
+      if (nfine == 0) continue;
+      const IntVect* fine_iv = fine_cells.data();
 
       if (fbx.type(0) == IndexType::NODE) {
-          AMREX_HOST_DEVICE_PARALLEL_FOR_4D_FLAG(RunOn::Gpu,fbx,ncomp,i,j,k,n,
+          ParallelFor(nfine, [=] AMREX_GPU_DEVICE (int idx) noexcept
           {
-              if (mask_arr(i,j,k) == mask_val) face_linear_interp_x(i,j,k,n,fine_arr,crse_arr,ratio);
+              const IntVect& iv = fine_iv[idx];
+              for (int n(0); n<ncomp; ++n) face_linear_interp_x(iv[0],iv[1],iv[2],n,fine_arr,crse_arr,ratio);
           });
       } else if (fbx.type(1) == IndexType::NODE) {
-          AMREX_HOST_DEVICE_PARALLEL_FOR_4D_FLAG(RunOn::Gpu,fbx,ncomp,i,j,k,n,
+          ParallelFor(nfine, [=] AMREX_GPU_DEVICE (int idx) noexcept
           {
-              if (mask_arr(i,j,k) == mask_val) face_linear_interp_y(i,j,k,n,fine_arr,crse_arr,ratio);
+              const IntVect& iv = fine_iv[idx];
+              for (int n(0); n<ncomp; ++n) face_linear_interp_y(iv[0],iv[1],iv[2],n,fine_arr,crse_arr,ratio);
           });
       } else {
-          AMREX_HOST_DEVICE_PARALLEL_FOR_4D_FLAG(RunOn::Gpu,fbx,ncomp,i,j,k,n,
+          ParallelFor(nfine, [=] AMREX_GPU_DEVICE (int idx) noexcept
           {
-              if (mask_arr(i,j,k) == mask_val) face_linear_interp_z(i,j,k,n,fine_arr,crse_arr,ratio);
+              const IntVect& iv = fine_iv[idx];
+              for (int n(0); n<ncomp; ++n) face_linear_interp_z(iv[0],iv[1],iv[2],n,fine_arr,crse_arr,ratio);
           });
       } // IndexType::NODE
   } // MFiter
@@ -226,53 +316,51 @@ void ERFFillPatcher::InterpCell (MultiFab& fine,
 {
   int ncomp = m_ncomp;
   IntVect ratio = m_ratio;
+  int m = mask_val - 1;
   IndexType m_ixt = fine.boxArray().ixType();
   Box const& cdomain = amrex::convert(m_cgeom.Domain(), m_ixt);
 
-  for (MFIter mfi(fine); mfi.isValid(); ++mfi) {
-      Box const& fbx = mfi.validbox();
+  // The BCs only change if the caller passes different ones, so we keep a device copy
+  if (m_bcr_h.size() != bcr.size() || !std::equal(bcr.begin(), bcr.end(), m_bcr_h.begin())) {
+      m_bcr_h = bcr;
+      m_bcr_d.resize(bcr.size());
+      Gpu::copyAsync(Gpu::hostToDevice, bcr.begin(), bcr.end(), m_bcr_d.begin());
+      Gpu::streamSynchronize();
+  }
+  BCRec const* bcrp = m_bcr_d.data();
 
+  for (MFIter mfi(fine); mfi.isValid(); ++mfi) {
       Array4<Real> const&       fine_arr = fine.array(mfi);
       Array4<Real const> const& crse_arr = crse.const_array(mfi);
-      Array4<int const> const&  mask_arr = m_cf_mask->const_array(mfi);
-
-      bool run_on_gpu = Gpu::inLaunchRegion();
-      amrex::ignore_unused(run_on_gpu);
-
-      amrex::ignore_unused(m_fgeom);
-
-      const Box& crse_region = m_interp->CoarseBox(fbx,ratio);
-      Box cslope_bx(crse_region);
-      for (int dim = 0; dim < AMREX_SPACEDIM; dim++) {
-          if (ratio[dim] > 1) {
-              cslope_bx.grow(dim,-1);
-          }
-      }
-
-      FArrayBox ccfab(cslope_bx, ncomp*AMREX_SPACEDIM);
-      Array4<Real> const& tmp = ccfab.array();
-      Array4<Real const> const& ctmp = ccfab.const_array();
 
-#ifdef AMREX_USE_GPU
-      AsyncArray<BCRec> async_bcr(bcr.data(), (run_on_gpu) ? ncomp : 0);
-      BCRec const* bcrp = (run_on_gpu) ? async_bcr.data() : bcr.data();
+      const auto& fine_cells = m_fine_cells[m][mfi];
+      const auto& crse_cells = m_crse_cells[m][mfi];
+      const int nfine = static_cast<int>(fine_cells.size());
+      const int ncrse = static_cast<int>(crse_cells.size());
+      if (nfine == 0) continue;
+      const IntVect* fine_iv = fine_cells.data();
+      const IntVect* crse_iv = crse_cells.data();
 
-      Elixir cceli;
-      if (run_on_gpu) { cceli = ccfab.elixir(); }
-#else
-      BCRec const* bcrp = bcr.data();
-#endif
+      Array4<Real> const& tmp = m_cf_slopes->array(mfi);
+      Array4<Real const> const& ctmp = m_cf_slopes->const_array(mfi);
 
-      AMREX_HOST_DEVICE_PARALLEL_FOR_4D_FLAG(RunOn::Gpu, cslope_bx, ncomp, i, j, k, n,
+      // Slopes are only needed under the cells we fill
+      ParallelFor(ncrse, [=] AMREX_GPU_DEVICE (int idx) noexcept
       {
-          mf_cell_cons_lin_interp_mcslope(i,j,k,n, tmp, crse_arr, 0, ncomp,
-                                          cdomain, ratio, bcrp);
+          const IntVect& iv = crse_iv[idx];
+          for (int n(0); n<ncomp; ++n) {
+              mf_cell_cons_lin_interp_mcslope(iv[0],iv[1],iv[2],n, tmp, crse_arr, 0, ncomp,
+                                              cdomain, ratio, bcrp);
+          }
       });
 
-      AMREX_HOST_DEVICE_PARALLEL_FOR_4D_FLAG(RunOn::Gpu, fbx, ncomp, i, j, k, n,
+      ParallelFor(nfine, [=] AMREX_GPU_DEVICE (int idx) noexcept
       {
-          if (mask_arr(i,j,k) == mask_val) mf_cell_cons_lin_interp(i,j,k,n, fine_arr, 0, ctmp,
-                                                                   crse_arr, 0, ncomp, ratio);
+          const IntVect& iv = fine_iv[idx];
+          for (int n(0); n<ncomp; ++n) {
+              mf_cell_cons_lin_interp(iv[0],iv[1],iv[2],n, fine_arr, 0, ctmp,
+                                      crse_arr, 0, ncomp, ratio);
+          }
       });
   } // MFIter
 }
@@ -523,7 +523,8 @@ MOSTAverage::compute_averages(int lev)
 
 
 /**
- * Function to compute average over a plane.
+ * Function to compute average over a plane. All the averaged quantities (u, v, theta and |U|)
+ * are gathered in a single kernel per tile and reduced with a single collective.
  *
  * @param[in] lev Current level
  */
@@ -557,14 +558,6 @@ MOSTAverage::compute_plane_averages(int lev)
         d_fact_old = 0.0;
     }
 
-    // GPU array to accumulate averages into
-    Gpu::DeviceVector<Real> pavg(plane_average.size(), 0.0);
-    Real* plane_avg = pavg.data();
-
-    // Vectors for normalization and buffer storage
-    Vector<Real> denom(plane_average.size(),0.0);
-    Vector<Real> val_old(plane_average.size(),0.0);
-
     // Averages over all the fields
     //----------------------------------------------------------
     Box domain = geom.Domain();
@@ -574,134 +567,121 @@ MOSTAverage::compute_plane_averages(int lev)
         if (geom.isPeriodic(idim)) is_per[idim] = 1;
     }
 
-    for (int imf(0); imf < m_nvar; ++imf) {
-        denom[imf]   = 1.0 / (Real)ncell_plane[imf];
-        val_old[imf] = plane_average[imf]*d_fact_old;
+    const bool use_interp = m_interp;
+    const auto plo   = geom.ProbLoArray();
+    const auto dxInv = geom.InvCellSizeArray();
+
+    ReduceOps<ReduceOpSum, ReduceOpSum, ReduceOpSum, ReduceOpSum> reduce_op;
+    ReduceData<Real, Real, Real, Real> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
 
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
-        for (MFIter mfi(*fields[imf], TileNoZ()); mfi.isValid(); ++mfi) {
-            Box vbx = mfi.validbox(); // This is the grid (not tile)
-            Box pbx = mfi.tilebox();  // This is the tile (not grid)
-            pbx.setSmall(2,0); pbx.setBig(2,0);
-
-            // Avoid double counting nodal data by changing the high end when we are
-            //     at the high side of the grid (not just of the tile)
-            IndexType ixt = averages[imf]->boxArray().ixType();
-            for (int idim(0); idim < AMREX_SPACEDIM-1; ++idim) {
-                if ( ixt.nodeCentered(idim)  && (pbx.bigEnd(idim) == vbx.bigEnd(idim)) ) {
-                    int dom_hi = domain.bigEnd(idim)+1;
-                    if (pbx.bigEnd(idim) < dom_hi || is_per[idim]) {
-                        pbx.growHi(idim,-1);
-                    }
-                }
-            }
+    for (MFIter mfi(*averages[2], TileNoZ()); mfi.isValid(); ++mfi)
+    {
+        Box vbx = mfi.validbox(); // This is the grid (not tile)
+        Box cbx = mfi.tilebox();  // This is the tile (not grid)
+        Box xbx = mfi.tilebox(IntVect(1,0,0));
+        Box ybx = mfi.tilebox(IntVect(0,1,0));
 
-            auto mf_arr = fields[imf]->const_array(mfi);
-
-            if (m_interp) {
-                const auto plo   = geom.ProbLoArray();
-                const auto dxInv = geom.InvCellSizeArray();
-                const auto z_phys_arr = z_phys->const_array(mfi);
-                auto x_pos_arr = x_pos->array(mfi);
-                auto y_pos_arr = y_pos->array(mfi);
-                auto z_pos_arr = z_pos->array(mfi);
-                ParallelFor(Gpu::KernelInfo().setReduction(true), pbx, [=]
-                AMREX_GPU_DEVICE(int i, int j, int k, Gpu::Handler const& handler) noexcept
-                {
-                    Real interp{0};
-                    trilinear_interp_T(x_pos_arr(i,j,k), y_pos_arr(i,j,k), z_pos_arr(i,j,k),
-                                       &interp, mf_arr, z_phys_arr, plo, dxInv, 1);
-                    Real val = interp;
-                    Gpu::deviceReduceSum(&plane_avg[imf], val, handler);
-                });
-            } else {
-                auto k_arr  = k_indx->const_array(mfi);
-                auto j_arr  = j_indx ? j_indx->const_array(mfi) : Array4<const int> {};
-                auto i_arr  = i_indx ? i_indx->const_array(mfi) : Array4<const int> {};
-                ParallelFor(Gpu::KernelInfo().setReduction(true), pbx, [=]
-                AMREX_GPU_DEVICE(int i, int j, int k, Gpu::Handler const& handler) noexcept
-                {
-                    int mk = k_arr(i,j,k);
-                    int mj = j_arr ? j_arr(i,j,k) : j;
-                    int mi = i_arr ? i_arr(i,j,k) : i;
-                    Real val = mf_arr(mi,mj,mk);
-                    Gpu::deviceReduceSum(&plane_avg[imf], val, handler);
-                });
+        // Avoid double counting nodal data by changing the high end when we are
+        //     at the high side of the grid (not just of the tile)
+        for (int idim(0); idim < AMREX_SPACEDIM-1; ++idim) {
+            Box& nbx = (idim == 0) ? xbx : ybx;
+            if (nbx.bigEnd(idim) == vbx.bigEnd(idim)+1) {
+                int dom_hi = domain.bigEnd(idim)+1;
+                if (nbx.bigEnd(idim) < dom_hi || is_per[idim]) {
+                    nbx.growHi(idim,-1);
+                }
             }
         }
-    }
 
-    //
-    //------------------------------------------------------------------------
-    // Averages for the tangential velocity magnitude
-    // (This is cell-centered so we don't need to worry about double-counting)
-    //------------------------------------------------------------------------
-    //
-    {
-        int imf  = 0;
-        int iavg = m_navg - 1;
-        denom[iavg]   = 1.0 / (Real)ncell_plane[iavg];
-        val_old[iavg] = plane_average[iavg]*d_fact_old;
+        // We loop over the union of the three boxes and mask each contribution
+        Box bbx = cbx;
+        bbx.setBig(0, xbx.bigEnd(0));
+        bbx.setBig(1, ybx.bigEnd(1));
+        const int ihi_c = cbx.bigEnd(0); const int jhi_c = cbx.bigEnd(1);
+        const int ihi_u = xbx.bigEnd(0); const int jhi_v = ybx.bigEnd(1);
+
+        auto u_mf_arr = fields[0]->const_array(mfi);
+        auto v_mf_arr = fields[1]->const_array(mfi);
+        auto t_mf_arr = fields[2]->const_array(mfi);
+
+        if (use_interp) {
+            const auto z_phys_arr = z_phys->const_array(mfi);
+            const auto x_pos_arr  = x_pos->const_array(mfi);
+            const auto y_pos_arr  = y_pos->const_array(mfi);
+            const auto z_pos_arr  = z_pos->const_array(mfi);
+            reduce_op.eval(bbx, reduce_data,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept -> ReduceTuple
+            {
+                const bool in_c = (i <= ihi_c && j <= jhi_c);
+                const bool in_u = (i <= ihi_u && j <= jhi_c);
+                const bool in_v = (i <= ihi_c && j <= jhi_v);
 
-#ifdef _OPENMP
-#pragma omp parallel if (Gpu::notInLaunchRegion())
-#endif
-        for (MFIter mfi(*averages[iavg], TileNoZ()); mfi.isValid(); ++mfi)
-        {
-            Box pbx = mfi.tilebox();
-            pbx.setSmall(2,0); pbx.setBig(2,0);
-
-            // Last element is Umag and always cell centered
-            auto u_mf_arr = fields[imf  ]->const_array(mfi);
-            auto v_mf_arr = fields[imf+1]->const_array(mfi);
-
-            if (m_interp) {
-                const auto plo   = m_geom[lev].ProbLoArray();
-                const auto dxInv = m_geom[lev].InvCellSizeArray();
-                const auto z_phys_arr = z_phys->const_array(mfi);
-                auto x_pos_arr = x_pos->array(mfi);
-                auto y_pos_arr = y_pos->array(mfi);
-                auto z_pos_arr = z_pos->array(mfi);
-                ParallelFor(Gpu::KernelInfo().setReduction(true), pbx, [=]
-                AMREX_GPU_DEVICE(int i, int j, int k, Gpu::Handler const& handler) noexcept
-                {
-                    Real u_interp{0};
-                    Real v_interp{0};
-                    trilinear_interp_T(x_pos_arr(i,j,k), y_pos_arr(i,j,k), z_pos_arr(i,j,k),
-                                            &u_interp, u_mf_arr, z_phys_arr, plo, dxInv, 1);
-                    trilinear_interp_T(x_pos_arr(i,j,k), y_pos_arr(i,j,k), z_pos_arr(i,j,k),
-                                            &v_interp, v_mf_arr, z_phys_arr, plo, dxInv, 1);
-                    const Real val   = std::sqrt(u_interp*u_interp + v_interp*v_interp);
-                    Gpu::deviceReduceSum(&plane_avg[iavg], val, handler);
-                });
-            } else {
-                auto k_arr = k_indx->const_array(mfi);
-                auto j_arr = j_indx ? j_indx->const_array(mfi) : Array4<const int> {};
-                auto i_arr = i_indx ? i_indx->const_array(mfi) : Array4<const int> {};
-                ParallelFor(Gpu::KernelInfo().setReduction(true), pbx, [=]
-                AMREX_GPU_DEVICE(int i, int j, int k, Gpu::Handler const& handler) noexcept
-                {
-                    int mk = k_arr(i,j,k);
-                    int mj = j_arr ? j_arr(i,j,k) : j;
-                    int mi = i_arr ? i_arr(i,j,k) : i;
+                const Real xp = x_pos_arr(i,j,k);
+                const Real yp = y_pos_arr(i,j,k);
+                const Real zp = z_pos_arr(i,j,k);
+
+                Real u_interp{0}; Real v_interp{0}; Real t_interp{0};
+                if (in_u || in_c) trilinear_interp_T(xp, yp, zp, &u_interp, u_mf_arr, z_phys_arr, plo, dxInv, 1);
+                if (in_v || in_c) trilinear_interp_T(xp, yp, zp, &v_interp, v_mf_arr, z_phys_arr, plo, dxInv, 1);
+                if (in_c)         trilinear_interp_T(xp, yp, zp, &t_interp, t_mf_arr, z_phys_arr, plo, dxInv, 1);
+
+                const Real mag = std::sqrt(u_interp*u_interp + v_interp*v_interp);
+
+                return { (in_u) ? u_interp : 0.0,
+                         (in_v) ? v_interp : 0.0,
+                         (in_c) ? t_interp : 0.0,
+                         (in_c) ? mag      : 0.0 };
+            });
+        } else {
+            auto k_arr = k_indx->const_array(mfi);
+            auto j_arr = j_indx ? j_indx->const_array(mfi) : Array4<const int> {};
+            auto i_arr = i_indx ? i_indx->const_array(mfi) : Array4<const int> {};
+            reduce_op.eval(bbx, reduce_data,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept -> ReduceTuple
+            {
+                const bool in_c = (i <= ihi_c && j <= jhi_c);
+                const bool in_u = (i <= ihi_u && j <= jhi_c);
+                const bool in_v = (i <= ihi_c && j <= jhi_v);
+
+                int mk = k_arr(i,j,k);
+                int mj = j_arr ? j_arr(i,j,k) : j;
+                int mi = i_arr ? i_arr(i,j,k) : i;
+
+                Real t_val{0}; Real mag{0};
+                if (in_c) {
+                    t_val = t_mf_arr(mi,mj,mk);
                     const Real u_val = 0.5 * (u_mf_arr(mi,mj,mk) + u_mf_arr(mi+1,mj  ,mk));
                     const Real v_val = 0.5 * (v_mf_arr(mi,mj,mk) + v_mf_arr(mi  ,mj+1,mk));
-                    const Real val   = std::sqrt(u_val*u_val + v_val*v_val);
-                    Gpu::deviceReduceSum(&plane_avg[iavg], val, handler);
-                });
-            }
+                    mag = std::sqrt(u_val*u_val + v_val*v_val);
+                }
+
+                return { (in_u) ? u_mf_arr(mi,mj,mk) : 0.0,
+                         (in_v) ? v_mf_arr(mi,mj,mk) : 0.0,
+                         t_val,
+                         mag };
+            });
         }
     }
 
-    // Copy to host and sum across procs
-    Gpu::copy(Gpu::deviceToHost, pavg.begin(), pavg.end(), plane_average.begin());
+    // Old values for the time filter
+    Vector<Real> val_old(plane_average.size(),0.0);
+    for (int iavg(0); iavg < m_navg; ++iavg) val_old[iavg] = plane_average[iavg]*d_fact_old;
+
+    // Copy to host and sum across procs (one collective for all averages)
+    ReduceTuple hv = reduce_data.value(reduce_op);
+    plane_average[0] = amrex::get<0>(hv);
+    plane_average[1] = amrex::get<1>(hv);
+    plane_average[2] = amrex::get<2>(hv);
+    plane_average[3] = amrex::get<3>(hv);
     ParallelDescriptor::ReduceRealSum(plane_average.data(), plane_average.size());
 
     // No spatial variation with plane averages
     for (int iavg(0); iavg < m_navg; ++iavg){
-        plane_average[iavg] *= denom[iavg]*d_fact_new;
+        plane_average[iavg] *= d_fact_new / (Real)ncell_plane[iavg];
         plane_average[iavg] += val_old[iavg];
         averages[iavg]->setVal(plane_average[iavg]);
     }
@@ -709,7 +689,8 @@ MOSTAverage::compute_plane_averages(int lev)
 
 
 /**
- * Function to compute average over local region.
+ * Function to compute average over local region. All the averaged quantities are computed
+ * in a single launch per tile and the time filter is applied in place.
  *
  * @param[in] lev Current level
  */
@@ -748,148 +729,128 @@ MOSTAverage::compute_region_averages(int lev)
 
     // Averages over all the fields
     //----------------------------------------------------------
-    for (int imf(0); imf < m_nvar; ++imf) {
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
-        for (MFIter mfi(*fields[imf], TileNoZ()); mfi.isValid(); ++mfi) {
-            Box pbx = mfi.tilebox(); pbx.setSmall(2,0); pbx.setBig(2,0);
-
-            auto mf_arr = fields[imf]->const_array(mfi);
-            auto ma_arr = averages[imf]->array(mfi);
-
-            if (m_interp) {
-                const auto plo   = geom.ProbLoArray();
-                const auto dx    = geom.CellSizeArray();
-                const auto dxInv = geom.InvCellSizeArray();
-                const auto z_phys_arr = z_phys->const_array(mfi);
-                auto x_pos_arr = x_pos->array(mfi);
-                auto y_pos_arr = y_pos->array(mfi);
-                auto z_pos_arr = z_pos->array(mfi);
-                ParallelFor(pbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
-                {
-                    ma_arr(i,j,k) *= d_fact_old;
-
-                    Real met_h_zeta = Compute_h_zeta_AtCellCenter(i,j,k,dxInv,z_phys_arr);
-                    for (int lk(-d_radius); lk <= (d_radius); ++lk) {
-                      for (int lj(-d_radius); lj <= (d_radius); ++lj) {
-                        for (int li(-d_radius); li <= (d_radius); ++li) {
-                            Real interp{0};
-                            Real xp = x_pos_arr(i,j,k) + li*dx[0];
-                            Real yp = y_pos_arr(i,j,k) + lj*dx[1];
-                            Real zp = z_pos_arr(i,j,k) + met_h_zeta*lk*dx[2];
-                            trilinear_interp_T(xp, yp, zp, &interp, mf_arr, z_phys_arr, plo, dxInv, 1);
-                            Real val = denom * interp * d_fact_new;
-                            ma_arr(i,j,k) += val;
-                        }
-                      }
-                    }
-                });
-            } else {
-                auto k_arr = k_indx->const_array(mfi);
-                auto j_arr = j_indx ? j_indx->const_array(mfi) : Array4<const int> {};
-                auto i_arr = i_indx ? i_indx->const_array(mfi) : Array4<const int> {};
-                ParallelFor(pbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
-                {
-                    ma_arr(i,j,k) *= d_fact_old;
-
-                    int mk = k_arr(i,j,k);
-                    int mj = j_arr ? j_arr(i,j,k) : j;
-                    int mi = i_arr ? i_arr(i,j,k) : i;
-                    for (int lk(mk-d_radius); lk <= (mk+d_radius); ++lk) {
-                      for (int lj(mj-d_radius); lj <= (mj+d_radius); ++lj) {
-                        for (int li(mi-d_radius); li <= (mi+d_radius); ++li) {
-                            Real val = denom * mf_arr(li, lj, lk) * d_fact_new;
-                            ma_arr(i,j,k) += val;
-                        }
-                      }
-                    }
-                });
-            }
-        }
-
-        // Fill interior ghost cells and any ghost cells outside a periodic domain
-        //***********************************************************************************
-        averages[imf]->FillBoundary(geom.periodicity());
-    }
-
-    // Averages for the tangential velocity magnitude
-    //----------------------------------------------------------
+    for (MFIter mfi(*averages[2], TileNoZ()); mfi.isValid(); ++mfi)
     {
-        int imf  = 0;
-        int iavg = m_navg - 1;
-
-#ifdef _OPENMP
-#pragma omp parallel if (Gpu::notInLaunchRegion())
-#endif
-        for (MFIter mfi(*averages[iavg], TileNoZ()); mfi.isValid(); ++mfi) {
-            Box pbx = mfi.tilebox(); pbx.setSmall(2,0); pbx.setBig(2,0);
-
-            auto u_mf_arr = fields[imf]->const_array(mfi);
-            auto v_mf_arr = fields[imf+1]->const_array(mfi);
-            auto ma_arr   = averages[iavg]->array(mfi);
-
-            if (m_interp) {
-                const auto plo   = geom.ProbLoArray();
-                const auto dx    = geom.CellSizeArray();
-                const auto dxInv = geom.InvCellSizeArray();
-                const auto z_phys_arr = z_phys->const_array(mfi);
-                auto x_pos_arr = x_pos->array(mfi);
-                auto y_pos_arr = y_pos->array(mfi);
-                auto z_pos_arr = z_pos->array(mfi);
-                ParallelFor(pbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
-                {
-                    ma_arr(i,j,k) *= d_fact_old;
-
-                    Real met_h_zeta = Compute_h_zeta_AtCellCenter(i,j,k,dxInv,z_phys_arr);
-                    for (int lk(-d_radius); lk <= (d_radius); ++lk) {
-                      for (int lj(-d_radius); lj <= (d_radius); ++lj) {
-                        for (int li(-d_radius); li <= (d_radius); ++li) {
-                            Real u_interp{0};
-                            Real v_interp{0};
-                            Real xp = x_pos_arr(i,j,k) + li*dx[0];
-                            Real yp = y_pos_arr(i,j,k) + lj*dx[1];
-                            Real zp = z_pos_arr(i,j,k) + met_h_zeta*lk*dx[2];
-                            trilinear_interp_T(xp, yp, zp, &u_interp, u_mf_arr, z_phys_arr, plo, dxInv, 1);
-                            trilinear_interp_T(xp, yp, zp, &v_interp, v_mf_arr, z_phys_arr, plo, dxInv, 1);
-                            Real mag = std::sqrt(u_interp*u_interp + v_interp*v_interp);
-                            Real val = denom * mag * d_fact_new;
-                            ma_arr(i,j,k) += val;
-                        }
-                      }
+        Box cbx = mfi.tilebox();
+        Box xbx = mfi.tilebox(IntVect(1,0,0));
+        Box ybx = mfi.tilebox(IntVect(0,1,0));
+
+        // We loop over the union of the three boxes and mask each average
+        Box bbx = cbx;
+        bbx.setBig(0, xbx.bigEnd(0));
+        bbx.setBig(1, ybx.bigEnd(1));
+        const int ihi_c = cbx.bigEnd(0); const int jhi_c = cbx.bigEnd(1);
+
+        auto u_mf_arr = fields[0]->const_array(mfi);
+        auto v_mf_arr = fields[1]->const_array(mfi);
+        auto t_mf_arr = fields[2]->const_array(mfi);
+
+        auto u_ma_arr = averages[0]->array(mfi);
+        auto v_ma_arr = averages[1]->array(mfi);
+        auto t_ma_arr = averages[2]->array(mfi);
+        auto m_ma_arr = averages[m_navg-1]->array(mfi);
+
+        if (m_interp) {
+            const auto plo   = geom.ProbLoArray();
+            const auto dx    = geom.CellSizeArray();
+            const auto dxInv = geom.InvCellSizeArray();
+            const auto z_phys_arr = z_phys->const_array(mfi);
+            auto x_pos_arr = x_pos->array(mfi);
+            auto y_pos_arr = y_pos->array(mfi);
+            auto z_pos_arr = z_pos->array(mfi);
+            ParallelFor(bbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
+            {
+                const bool in_u = (j <= jhi_c);
+                const bool in_v = (i <= ihi_c);
+                const bool in_c = (in_u && in_v);
+
+                Real u_avg = (in_u) ? u_ma_arr(i,j,k) * d_fact_old : 0.0;
+                Real v_avg = (in_v) ? v_ma_arr(i,j,k) * d_fact_old : 0.0;
+                Real t_avg = (in_c) ? t_ma_arr(i,j,k) * d_fact_old : 0.0;
+                Real m_avg = (in_c) ? m_ma_arr(i,j,k) * d_fact_old : 0.0;
+
+                Real met_h_zeta = Compute_h_zeta_AtCellCenter(i,j,k,dxInv,z_phys_arr);
+                for (int lk(-d_radius); lk <= (d_radius); ++lk) {
+                  for (int lj(-d_radius); lj <= (d_radius); ++lj) {
+                    for (int li(-d_radius); li <= (d_radius); ++li) {
+                        Real u_interp{0};
+                        Real v_interp{0};
+                        Real t_interp{0};
+                        Real xp = x_pos_arr(i,j,k) + li*dx[0];
+                        Real yp = y_pos_arr(i,j,k) + lj*dx[1];
+                        Real zp = z_pos_arr(i,j,k) + met_h_zeta*lk*dx[2];
+                        if (in_u) trilinear_interp_T(xp, yp, zp, &u_interp, u_mf_arr, z_phys_arr, plo, dxInv, 1);
+                        if (in_v) trilinear_interp_T(xp, yp, zp, &v_interp, v_mf_arr, z_phys_arr, plo, dxInv, 1);
+                        if (in_c) trilinear_interp_T(xp, yp, zp, &t_interp, t_mf_arr, z_phys_arr, plo, dxInv, 1);
+                        u_avg += denom * u_interp * d_fact_new;
+                        v_avg += denom * v_interp * d_fact_new;
+                        t_avg += denom * t_interp * d_fact_new;
+                        m_avg += denom * std::sqrt(u_interp*u_interp + v_interp*v_interp) * d_fact_new;
                     }
-                });
-            } else {
-                auto k_arr = k_indx->const_array(mfi);
-                auto j_arr = j_indx ? j_indx->const_array(mfi) : Array4<const int> {};
-                auto i_arr = i_indx ? i_indx->const_array(mfi) : Array4<const int> {};
-                ParallelFor(pbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
-                {
-                    ma_arr(i,j,k) *= d_fact_old;
-
-                    int mk = k_arr(i,j,k);
-                    int mj = j_arr ? j_arr(i,j,k) : j;
-                    int mi = i_arr ? i_arr(i,j,k) : i;
-                    for (int lk(mk-d_radius); lk <= (mk+d_radius); ++lk) {
-                      for (int lj(mj-d_radius); lj <= (mj+d_radius); ++lj) {
-                        for (int li(mi-d_radius); li <= (mi+d_radius); ++li) {
+                  }
+                }
+
+                if (in_u) u_ma_arr(i,j,k) = u_avg;
+                if (in_v) v_ma_arr(i,j,k) = v_avg;
+                if (in_c) {
+                    t_ma_arr(i,j,k) = t_avg;
+                    m_ma_arr(i,j,k) = m_avg;
+                }
+            });
+        } else {
+            auto k_arr = k_indx->const_array(mfi);
+            auto j_arr = j_indx ? j_indx->const_array(mfi) : Array4<const int> {};
+            auto i_arr = i_indx ? i_indx->const_array(mfi) : Array4<const int> {};
+            ParallelFor(bbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
+            {
+                const bool in_u = (j <= jhi_c);
+                const bool in_v = (i <= ihi_c);
+                const bool in_c = (in_u && in_v);
+
+                Real u_avg = (in_u) ? u_ma_arr(i,j,k) * d_fact_old : 0.0;
+                Real v_avg = (in_v) ? v_ma_arr(i,j,k) * d_fact_old : 0.0;
+                Real t_avg = (in_c) ? t_ma_arr(i,j,k) * d_fact_old : 0.0;
+                Real m_avg = (in_c) ? m_ma_arr(i,j,k) * d_fact_old : 0.0;
+
+                int mk = k_arr(i,j,k);
+                int mj = j_arr ? j_arr(i,j,k) : j;
+                int mi = i_arr ? i_arr(i,j,k) : i;
+                for (int lk(mk-d_radius); lk <= (mk+d_radius); ++lk) {
+                  for (int lj(mj-d_radius); lj <= (mj+d_radius); ++lj) {
+                    for (int li(mi-d_radius); li <= (mi+d_radius); ++li) {
+                        if (in_u) u_avg += denom * u_mf_arr(li, lj, lk) * d_fact_new;
+                        if (in_v) v_avg += denom * v_mf_arr(li, lj, lk) * d_fact_new;
+                        if (in_c) {
+                            t_avg += denom * t_mf_arr(li, lj, lk) * d_fact_new;
                             const Real u_val = 0.5 * (u_mf_arr(li,lj,lk) + u_mf_arr(li+1,lj  ,lk));
                             const Real v_val = 0.5 * (v_mf_arr(li,lj,lk) + v_mf_arr(li  ,lj+1,lk));
-                            const Real mag   = std::sqrt(u_val*u_val + v_val*v_val);
-                            Real val = denom * mag * d_fact_new;
-                            ma_arr(i,j,k) += val;
+                            m_avg += denom * std::sqrt(u_val*u_val + v_val*v_val) * d_fact_new;
                         }
-                      }
                     }
-                });
-            }
+                  }
+                }
 
-            // Fill interior ghost cells and any ghost cells outside a periodic domain
-            //***********************************************************************************
-            averages[iavg]->FillBoundary(geom.periodicity());
+                if (in_u) u_ma_arr(i,j,k) = u_avg;
+                if (in_v) v_ma_arr(i,j,k) = v_avg;
+                if (in_c) {
+                    t_ma_arr(i,j,k) = t_avg;
+                    m_ma_arr(i,j,k) = m_avg;
+                }
+            });
         }
     }
 
+    // Fill interior ghost cells and any ghost cells outside a periodic domain
+    // (all the averages are exchanged together)
+    //***********************************************************************************
+    {
+        Vector<FabArray<FArrayBox>*> avg_ptrs(m_navg);
+        for (int iavg(0); iavg < m_navg; ++iavg) avg_ptrs[iavg] = averages[iavg].get();
+        amrex::FillBoundary(avg_ptrs, geom.periodicity());
+    }
 
     // Need to fill ghost cells outside the domain if not periodic
     bool not_per_x = !(geom.periodicity().isPeriodic(0));
@@ -23,6 +23,7 @@ using namespace amrex;
  * @param[out] tau31 31 strain
  * @param[out] tau32 32 strain
  * @param[in] z_nd nodal array of physical z heights
+ * @param[in] met cached metrics at cell centers and edges (null arrays without a cache)
  * @param[in] bc_ptr container with boundary condition types
  * @param[in] dxInv inverse cell size array
  * @param[in] mf_u map factor at x-face
@@ -36,6 +37,7 @@ ComputeStrain_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz,
                  Array4<Real>& tau21, Array4<Real>& tau23,
                  Array4<Real>& tau31, Array4<Real>& tau32,
                  const Array4<const Real>& z_nd  ,
+                 const TerrainMetricArrays& met,
                  const BCRec* bc_ptr, const GpuArray<Real, AMREX_SPACEDIM>& dxInv,
                  const Array4<const Real>& /*mf_m*/,
                  const Array4<const Real>& mf_u,
@@ -87,9 +89,9 @@ ComputeStrain_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz,
                                              -v(i  ,j  ,k-1)/mf_v(i,j,0) - v(i-1,j  ,k-1)/mf_v(i-1,j,0) );
 
             Real met_h_xi,met_h_eta,met_h_zeta;
-            met_h_xi   = Compute_h_xi_AtEdgeCenterK  (i,j,k,dxInv,z_nd);
-            met_h_eta  = Compute_h_eta_AtEdgeCenterK (i,j,k,dxInv,z_nd);
-            met_h_zeta = Compute_h_zeta_AtEdgeCenterK(i,j,k,dxInv,z_nd);
+            met_h_xi   = Get_h_AtEdgeCenterK(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.ek);
+            met_h_eta  = Get_h_AtEdgeCenterK(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.ek);
+            met_h_zeta = Get_h_AtEdgeCenterK(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ek);
 
             tau12(i,j,k) = 0.5 * ( (u(i, j, k)/mf_u(i,j,0) - u(i, j-1, k)/mf_u(i,j-1,0))*dxInv[1]
                                + (-(8./3.) * v(i-1,j,k)/mf_v(i-1,j,0) + 3. * v(i,j,k)/mf_v(i,j,0) - (1./3.) * v(i+1,j,k)/mf_v(i+1,j,0))*dxInv[0]
@@ -108,9 +110,9 @@ ComputeStrain_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz,
                                              -v(i  ,j  ,k-1)/mf_v(i,j,0) - v(i-1,j  ,k-1)/mf_v(i-1,j,0) );
 
             Real met_h_xi,met_h_eta,met_h_zeta;
-            met_h_xi   = Compute_h_xi_AtEdgeCenterK  (i,j,k,dxInv,z_nd);
-            met_h_eta  = Compute_h_eta_AtEdgeCenterK (i,j,k,dxInv,z_nd);
-            met_h_zeta = Compute_h_zeta_AtEdgeCenterK(i,j,k,dxInv,z_nd);
+            met_h_xi   = Get_h_AtEdgeCenterK(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.ek);
+            met_h_eta  = Get_h_AtEdgeCenterK(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.ek);
+            met_h_zeta = Get_h_AtEdgeCenterK(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ek);
 
             tau12(i,j,k) = 0.5 * ( (u(i, j, k)/mf_u(i,j,0) - u(i, j-1, k)/mf_u(i,j-1,0))*dxInv[1]
                                - (-(8./3.) * v(i,j,k)/mf_v(i,j,0) + 3. * v(i-1,j,k)/mf_v(i-1,j,0) - (1./3.) * v(i-2,j,k)/mf_v(i-2,j,0))*dxInv[0]
@@ -129,8 +131,8 @@ ComputeStrain_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz,
                                             - w(i  ,j  ,k-1) - w(i-1,j  ,k-1) );
 
             Real met_h_xi,met_h_zeta;
-            met_h_xi   = Compute_h_xi_AtEdgeCenterJ  (i,j,k,dxInv,z_nd);
-            met_h_zeta = Compute_h_zeta_AtEdgeCenterJ(i,j,k,dxInv,z_nd);
+            met_h_xi   = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.ej);
+            met_h_zeta = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ej);
 
             tau13(i,j,k) = 0.5 * ( (u(i, j, k) - u(i, j, k-1))*dxInv[2]/met_h_zeta
                                  + ( (-(8./3.) * w(i-1,j,k) + 3. * w(i,j,k) - (1./3.) * w(i+1,j,k))*dxInv[0]
@@ -147,8 +149,8 @@ ComputeStrain_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz,
                                             - w(i  ,j  ,k-1) - w(i-1,j  ,k-1) );
 
             Real met_h_xi,met_h_zeta;
-            met_h_xi   = Compute_h_xi_AtEdgeCenterJ  (i,j,k,dxInv,z_nd);
-            met_h_zeta = Compute_h_zeta_AtEdgeCenterJ(i,j,k,dxInv,z_nd);
+            met_h_xi   = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.ej);
+            met_h_zeta = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ej);
 
             tau13(i,j,k) = 0.5 * ( (u(i, j, k) - u(i, j, k-1))*dxInv[2]/met_h_zeta
                                  - ( (-(8./3.) * w(i,j,k) + 3. * w(i-1,j,k) - (1./3.) * w(i-2,j,k))*dxInv[0]
@@ -169,9 +171,9 @@ ComputeStrain_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz,
                                              -v(i  ,j  ,k-1)/mf_v(i,j,0) - v(i-1,j  ,k-1)/mf_v(i-1,j,0) );
 
             Real met_h_xi,met_h_eta,met_h_zeta;
-            met_h_xi   = Compute_h_xi_AtEdgeCenterK  (i,j,k,dxInv,z_nd);
-            met_h_eta  = Compute_h_eta_AtEdgeCenterK (i,j,k,dxInv,z_nd);
-            met_h_zeta = Compute_h_zeta_AtEdgeCenterK(i,j,k,dxInv,z_nd);
+            met_h_xi   = Get_h_AtEdgeCenterK(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.ek);
+            met_h_eta  = Get_h_AtEdgeCenterK(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.ek);
+            met_h_zeta = Get_h_AtEdgeCenterK(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ek);
 
             tau12(i,j,k) = 0.5 * ( (-(8./3.) * u(i,j-1,k)/mf_u(i,j-1,0) + 3. * u(i,j,k)/mf_u(i,j,0) - (1./3.) * u(i,j+1,k)/mf_u(i,j+1,0))*dxInv[1]
                                + (v(i, j, k)/mf_v(i,j,0) - v(i-1, j, k)/mf_v(i,j,0))*dxInv[0]
@@ -190,9 +192,9 @@ ComputeStrain_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz,
                                              -v(i  ,j  ,k-1)/mf_v(i,j,0) - v(i-1,j  ,k-1)/mf_v(i-1,j,0) );
 
             Real met_h_xi,met_h_eta,met_h_zeta;
-            met_h_xi   = Compute_h_xi_AtEdgeCenterK  (i,j,k,dxInv,z_nd);
-            met_h_eta  = Compute_h_eta_AtEdgeCenterK (i,j,k,dxInv,z_nd);
-            met_h_zeta = Compute_h_zeta_AtEdgeCenterK(i,j,k,dxInv,z_nd);
+            met_h_xi   = Get_h_AtEdgeCenterK(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.ek);
+            met_h_eta  = Get_h_AtEdgeCenterK(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.ek);
+            met_h_zeta = Get_h_AtEdgeCenterK(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ek);
 
             tau12(i,j,k) = 0.5 * ( -(-(8./3.) * u(i,j,k)/mf_u(i,j,0) + 3. * u(i,j-1,k)/mf_u(i,j-1,0) - (1./3.) * u(i,j-2,k)/mf_u(i,j-2,0))*dxInv[1] +
                                + (v(i, j, k)/mf_v(i,j,0) - v(i-1, j, k)/mf_v(i-1,j,0))*dxInv[0]
@@ -211,8 +213,8 @@ ComputeStrain_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz,
                                             - w(i  ,j  ,k-1) - w(i  ,j-1,k-1) );
 
              Real met_h_eta,met_h_zeta;
-             met_h_eta  = Compute_h_eta_AtEdgeCenterI (i,j,k,dxInv,z_nd);
-             met_h_zeta = Compute_h_zeta_AtEdgeCenterI(i,j,k,dxInv,z_nd);
+             met_h_eta  = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.ei);
+             met_h_zeta = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ei);
 
             tau23(i,j,k) = 0.5 * ( (v(i, j, k) - v(i, j, k-1))*dxInv[2]/met_h_zeta
                                  + ( (-(8./3.) * w(i,j-1,k) + 3. * w(i,j  ,k) - (1./3.) * w(i,j+1,k))*dxInv[1]*mf_v(i,j,0)
@@ -229,8 +231,8 @@ ComputeStrain_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz,
                                              - w(i  ,j  ,k-1) - w(i  ,j-1,k-1) );
 
              Real met_h_eta,met_h_zeta;
-             met_h_eta  = Compute_h_eta_AtEdgeCenterI (i,j,k,dxInv,z_nd);
-             met_h_zeta = Compute_h_zeta_AtEdgeCenterI(i,j,k,dxInv,z_nd);
+             met_h_eta  = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.ei);
+             met_h_zeta = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ei);
 
             tau23(i,j,k) = 0.5 * ( (v(i, j, k) - v(i, j, k-1))*dxInv[2]/met_h_zeta
                                  - ( (-(8./3.) * w(i,j  ,k) + 3. * w(i,j-1,k) - (1./3.) * w(i,j-2,k))*dxInv[1]
@@ -249,8 +251,8 @@ ComputeStrain_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz,
                                             - w(i  ,j  ,k  ) - w(i-1,j  ,k  ) );
 
             Real met_h_xi,met_h_zeta;
-            met_h_xi   = Compute_h_xi_AtEdgeCenterJ  (i,j,k,dxInv,z_nd);
-            met_h_zeta = Compute_h_zeta_AtEdgeCenterJ(i,j,k,dxInv,z_nd);
+            met_h_xi   = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.ej);
+            met_h_zeta = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ej);
 
             tau13(i,j,k) = 0.5 * ( (-(8./3.) * u(i,j,k-1) + 3. * u(i,j,k) - (1./3.) * u(i,j,k+1))*dxInv[2]/met_h_zeta
                                  + ( (w(i, j, k) - w(i-1, j, k))*dxInv[0]
@@ -263,7 +265,7 @@ ComputeStrain_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz,
         tbxxz.growHi(2,-1);
         amrex::ParallelFor(planexz,[=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
             Real met_h_zeta;
-            met_h_zeta = Compute_h_zeta_AtEdgeCenterJ(i,j,k,dxInv,z_nd);
+            met_h_zeta = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ej);
 
             tau13(i,j,k) = 0.5 * ( -(-(8./3.) * u(i,j,k) + 3. * u(i,j,k-1) - (1./3.) * u(i,j,k-2))*dxInv[2]/met_h_zeta
                                + (w(i, j, k) - w(i-1, j, k))*dxInv[0]*mf_u(i,j,0) );
@@ -279,8 +281,8 @@ ComputeStrain_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz,
                                             - w(i  ,j  ,k  ) - w(i  ,j-1,k  ) );
 
             Real met_h_eta,met_h_zeta;
-            met_h_eta  = Compute_h_eta_AtEdgeCenterI (i,j,k,dxInv,z_nd);
-            met_h_zeta = Compute_h_zeta_AtEdgeCenterI(i,j,k,dxInv,z_nd);
+            met_h_eta  = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.ei);
+            met_h_zeta = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ei);
 
             tau23(i,j,k) = 0.5 * ( (-(8./3.) * v(i,j,k-1) + 3. * v(i,j,k  ) - (1./3.) * v(i,j,k+1))*dxInv[2]/met_h_zeta
                                  + ( (w(i, j, k) - w(i, j-1, k))*dxInv[1]
@@ -293,7 +295,7 @@ ComputeStrain_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz,
         tbxyz.growHi(2,-1);
         amrex::ParallelFor(planeyz,[=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
             Real met_h_zeta;
-            met_h_zeta = Compute_h_zeta_AtEdgeCenterI(i,j,k,dxInv,z_nd);
+            met_h_zeta = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ei);
 
             tau23(i,j,k) = 0.5 * ( -(-(8./3.) * v(i,j,k  ) + 3. * v(i,j,k-1) - (1./3.) * v(i,j,k-2))*dxInv[2]/met_h_zeta
                                  + (w(i, j, k) - w(i, j-1, k))*dxInv[1]*mf_v(i,j,0) );
@@ -312,9 +314,9 @@ ComputeStrain_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz,
                                            + (-(8./3.) * v(i,j-1,k-1) + 3. * v(i,j-1,k) - (1./3.) * v(i,j-1,k+1)) );
 
             Real met_h_xi,met_h_eta,met_h_zeta;
-            met_h_xi   = Compute_h_xi_AtCellCenter  (i,j,k,dxInv,z_nd);
-            met_h_eta  = Compute_h_eta_AtCellCenter (i,j,k,dxInv,z_nd);
-            met_h_zeta = Compute_h_zeta_AtCellCenter(i,j,k,dxInv,z_nd);
+            met_h_xi   = Get_h_AtCellCenter(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.cc);
+            met_h_eta  = Get_h_AtCellCenter(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.cc);
+            met_h_zeta = Get_h_AtCellCenter(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.cc);
 
             tau11(i,j,k) = ( (u(i+1, j, k)/mf_u(i+1,j,0) - u(i, j, k)/mf_u(i,j,0))*dxInv[0]
                            - (met_h_xi/met_h_zeta)*GradUz ) * mf_u(i,j,0)*mf_u(i,j,0);
@@ -332,9 +334,9 @@ ComputeStrain_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz,
                                            + (-(8./3.) * v(i-1,j,k-1) + 3. * v(i-1,j,k) - (1./3.) * v(i-1,j,k+1)) );
 
             Real met_h_xi,met_h_eta,met_h_zeta;
-            met_h_xi   = Compute_h_xi_AtEdgeCenterK  (i,j,k,dxInv,z_nd);
-            met_h_eta  = Compute_h_eta_AtEdgeCenterK (i,j,k,dxInv,z_nd);
-            met_h_zeta = Compute_h_zeta_AtEdgeCenterK(i,j,k,dxInv,z_nd);
+            met_h_xi   = Get_h_AtEdgeCenterK(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.ek);
+            met_h_eta  = Get_h_AtEdgeCenterK(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.ek);
+            met_h_zeta = Get_h_AtEdgeCenterK(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ek);
 
             tau12(i,j,k) = 0.5 * ( (u(i, j, k)/mf_u(i,j,0) - u(i  , j-1, k)/mf_u(i,j-1,0))*dxInv[1]
                                  + (v(i, j, k)/mf_v(i,j,0) - v(i-1, j  , k)/mf_v(i-1,j,0))*dxInv[0]
@@ -354,8 +356,8 @@ ComputeStrain_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz,
                                             - w(i  ,j  ,k  ) - w(i-1,j  ,k  ) );
 
             Real met_h_xi,met_h_zeta;
-            met_h_xi   = Compute_h_xi_AtEdgeCenterJ  (i,j,k,dxInv,z_nd);
-            met_h_zeta = Compute_h_zeta_AtEdgeCenterJ(i,j,k,dxInv,z_nd);
+            met_h_xi   = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.ej);
+            met_h_zeta = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ej);
 
             tau13(i,j,k) = 0.5 * ( (u(i, j, k) - u(i  , j, k-1))*dxInv[2]/met_h_zeta
                                  + ( (w(i, j, k) - w(i-1, j, k  ))*dxInv[0]
@@ -371,8 +373,8 @@ ComputeStrain_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz,
                                             - w(i  ,j  ,k  ) - w(i  ,j-1,k  ) );
 
             Real met_h_eta,met_h_zeta;
-            met_h_eta  = Compute_h_eta_AtEdgeCenterI (i,j,k,dxInv,z_nd);
-            met_h_zeta = Compute_h_zeta_AtEdgeCenterI(i,j,k,dxInv,z_nd);
+            met_h_eta  = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.ei);
+            met_h_zeta = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ei);
 
             tau23(i,j,k) = 0.5 * ( (v(i, j, k) - v(i, j  , k-1))*dxInv[2]/met_h_zeta
                                  + ( (w(i, j, k) - w(i, j-1, k  ))*dxInv[1]
@@ -388,7 +390,7 @@ ComputeStrain_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz,
         tbxxz.growHi(2,-1);
         amrex::ParallelFor(planexz,[=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
             Real met_h_zeta;
-            met_h_zeta = Compute_h_zeta_AtEdgeCenterJ(i,j,k,dxInv,z_nd);
+            met_h_zeta = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ej);
 
             tau13(i,j,k) = 0.5 * ( (u(i, j, k) - u(i  , j, k-1))*dxInv[2]/met_h_zeta
                                  + (w(i, j, k) - w(i-1, j, k  ))*dxInv[0]*mf_u(i,j,0) );
@@ -400,7 +402,7 @@ ComputeStrain_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz,
         tbxyz.growHi(2,-1);
         amrex::ParallelFor(planeyz,[=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
             Real met_h_zeta;
-            met_h_zeta = Compute_h_zeta_AtEdgeCenterI(i,j,k,dxInv,z_nd);
+            met_h_zeta = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ei);
 
             tau23(i,j,k) = 0.5 * ( (v(i, j, k) - v(i, j  , k-1))*dxInv[2]/met_h_zeta
                                  + (w(i, j, k) - w(i, j-1, k  ))*dxInv[1]*mf_v(i,j,0) );
@@ -418,9 +420,9 @@ ComputeStrain_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz,
                                          -v(i  ,j  ,k-1)/mf_v(i,j,0) - v(i  ,j-1,k-1)/mf_v(i,j-1,0) );
 
         Real met_h_xi,met_h_eta,met_h_zeta;
-        met_h_xi   = Compute_h_xi_AtCellCenter  (i,j,k,dxInv,z_nd);
-        met_h_eta  = Compute_h_eta_AtCellCenter (i,j,k,dxInv,z_nd);
-        met_h_zeta = Compute_h_zeta_AtCellCenter(i,j,k,dxInv,z_nd);
+        met_h_xi   = Get_h_AtCellCenter(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.cc);
+        met_h_eta  = Get_h_AtCellCenter(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.cc);
+        met_h_zeta = Get_h_AtCellCenter(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.cc);
 
         tau11(i,j,k) = ( (u(i+1, j, k)/mf_u(i+1,j,0) - u(i, j, k)/mf_u(i,j,0))*dxInv[0]
                        - (met_h_xi/met_h_zeta)*GradUz ) * mf_u(i,j,0)*mf_u(i,j,0);
@@ -438,9 +440,9 @@ ComputeStrain_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz,
                                          -v(i  ,j  ,k-1)/mf_v(i,j,0) - v(i-1,j  ,k-1)/mf_v(i-1,j,0) );
 
         Real met_h_xi,met_h_eta,met_h_zeta;
-        met_h_xi   = Compute_h_xi_AtEdgeCenterK  (i,j,k,dxInv,z_nd);
-        met_h_eta  = Compute_h_eta_AtEdgeCenterK (i,j,k,dxInv,z_nd);
-        met_h_zeta = Compute_h_zeta_AtEdgeCenterK(i,j,k,dxInv,z_nd);
+        met_h_xi   = Get_h_AtEdgeCenterK(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.ek);
+        met_h_eta  = Get_h_AtEdgeCenterK(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.ek);
+        met_h_zeta = Get_h_AtEdgeCenterK(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ek);
 
         tau12(i,j,k) = 0.5 * ( (u(i, j, k)/mf_u(i,j,0) - u(i  , j-1, k)/mf_u(i,j-1,0))*dxInv[1]
                              + (v(i, j, k)/mf_v(i,j,0) - v(i-1, j  , k)/mf_v(i-1,j,0))*dxInv[0]
@@ -453,8 +455,8 @@ ComputeStrain_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz,
                                         - w(i  ,j  ,k-1) - w(i-1,j  ,k-1) );
 
         Real met_h_xi,met_h_zeta;
-        met_h_xi   = Compute_h_xi_AtEdgeCenterJ  (i,j,k,dxInv,z_nd);
-        met_h_zeta = Compute_h_zeta_AtEdgeCenterJ(i,j,k,dxInv,z_nd);
+        met_h_xi   = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.ej);
+        met_h_zeta = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ej);
 
         tau13(i,j,k) = 0.5 * ( (u(i, j, k) - u(i  , j, k-1))*dxInv[2]/met_h_zeta
                              + ( (w(i, j, k) - w(i-1, j, k  ))*dxInv[0]
@@ -466,8 +468,8 @@ ComputeStrain_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz,
                                         - w(i  ,j  ,k-1) - w(i  ,j-1,k-1) );
 
         Real met_h_eta,met_h_zeta;
-        met_h_eta  = Compute_h_eta_AtEdgeCenterI (i,j,k,dxInv,z_nd);
-        met_h_zeta = Compute_h_zeta_AtEdgeCenterI(i,j,k,dxInv,z_nd);
+        met_h_eta  = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.ei);
+        met_h_zeta = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ei);
 
         tau23(i,j,k) = 0.5 * ( (v(i, j, k) - v(i, j  , k-1))*dxInv[2]/met_h_zeta
                              + ( (w(i, j, k) - w(i, j-1, k  ))*dxInv[1]
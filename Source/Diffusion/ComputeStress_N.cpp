@@ -64,16 +64,25 @@ ComputeStressConsVisc_N (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
  * @param[in,out] tau13 13 strain -> stress
  * @param[in,out] tau23 23 strain -> stress
  * @param[in] er_arr expansion rate
+ * @param[in] implicit_vert leave the turbulent part of tau_13 and tau_23 on the
+ *            interior z-faces to ImplicitVertDiffusion
+ * @param[in] domain box of the whole domain
  */
 void
 ComputeStressVarVisc_N (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
                         const Array4<const Real>& mu_turb,
                         Array4<Real>& tau11, Array4<Real>& tau22, Array4<Real>& tau33,
                         Array4<Real>& tau12, Array4<Real>& tau13, Array4<Real>& tau23,
-                        const Array4<const Real>& er_arr)
+                        const Array4<const Real>& er_arr,
+                        const bool implicit_vert,
+                        const Box& domain)
 {
     Real OneThird   = (1./3.);
 
+    // Bottom and top faces of the domain
+    const int klo = domain.smallEnd(2);
+    const int khi = domain.bigEnd(2) + 1;
+
     // Cell centered strains
     amrex::ParallelFor(bxcc, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
         Real mu_11 = mu_eff + 2.0 * mu_turb(i, j, k, EddyDiff::Mom_h);
@@ -95,12 +104,14 @@ ComputeStressVarVisc_N (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
     [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
         Real mu_bar = 0.25*( mu_turb(i-1, j, k  , EddyDiff::Mom_v) + mu_turb(i, j, k  , EddyDiff::Mom_v)
                            + mu_turb(i-1, j, k-1, EddyDiff::Mom_v) + mu_turb(i, j, k-1, EddyDiff::Mom_v) );
+        if (implicit_vert && k > klo && k < khi) mu_bar = 0.0;
         Real mu_13  = mu_eff + 2.0*mu_bar;
         tau13(i,j,k) *= -mu_13;
     },
     [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
         Real mu_bar = 0.25*( mu_turb(i, j-1, k  , EddyDiff::Mom_v) + mu_turb(i, j, k  , EddyDiff::Mom_v)
                            + mu_turb(i, j-1, k-1, EddyDiff::Mom_v) + mu_turb(i, j, k-1, EddyDiff::Mom_v) );
+        if (implicit_vert && k > klo && k < khi) mu_bar = 0.0;
         Real mu_23  = mu_eff + 2.0*mu_bar;
         tau23(i,j,k) *= -mu_23;
     });
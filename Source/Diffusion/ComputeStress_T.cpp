@@ -22,6 +22,7 @@ using namespace amrex;
  * @param[in,out] tau32 32 strain -> stress
  * @param[in]  er_arr expansion rate
  * @param[in]  z_nd nodal array of physical z heights
+ * @param[in]  met cached metrics at cell centers and edges (null arrays without a cache)
  * @param[in]  dxInv inverse cell size array
  */
 void
@@ -32,6 +33,7 @@ ComputeStressConsVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
                          Array4<Real>& tau31, Array4<Real>& tau32,
                          const Array4<const Real>& er_arr,
                          const Array4<const Real>& z_nd  ,
+                         const TerrainMetricArrays& met,
                          const GpuArray<Real, AMREX_SPACEDIM>& dxInv)
 {
     //***********************************************************************************
@@ -59,8 +61,8 @@ ComputeStressConsVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
     [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
     {
         Real met_h_xi,met_h_eta;
-        met_h_xi   = Compute_h_xi_AtCellCenter  (i,j,k,dxInv,z_nd);
-        met_h_eta  = Compute_h_eta_AtCellCenter (i,j,k,dxInv,z_nd);
+        met_h_xi   = Get_h_AtCellCenter(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.cc);
+        met_h_eta  = Get_h_AtCellCenter(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.cc);
 
         Real tau31bar = 0.25 * ( tau31(i  , j  , k  ) + tau31(i+1, j  , k  )
                                + tau31(i  , j  , k+1) + tau31(i+1, j  , k+1) );
@@ -83,9 +85,9 @@ ComputeStressConsVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
         amrex::ParallelFor(planexz,[=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
             Real met_h_xi,met_h_eta,met_h_zeta;
-            met_h_xi   = Compute_h_xi_AtEdgeCenterJ  (i,j,k,dxInv,z_nd);
-            met_h_eta  = Compute_h_eta_AtEdgeCenterJ (i,j,k,dxInv,z_nd);
-            met_h_zeta = Compute_h_zeta_AtEdgeCenterJ(i,j,k,dxInv,z_nd);
+            met_h_xi   = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.ej);
+            met_h_eta  = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.ej);
+            met_h_zeta = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ej);
 
             Real tau11lo  = 0.5 * ( tau11(i  , j  , k  ) + tau11(i-1, j  , k  ) );
             Real tau11hi  = 0.5 * ( tau11(i  , j  , k+1) + tau11(i-1, j  , k+1) );
@@ -108,9 +110,9 @@ ComputeStressConsVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
         amrex::ParallelFor(planeyz,[=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
             Real met_h_xi,met_h_eta,met_h_zeta;
-            met_h_xi   = Compute_h_xi_AtEdgeCenterI  (i,j,k,dxInv,z_nd);
-            met_h_eta  = Compute_h_eta_AtEdgeCenterI (i,j,k,dxInv,z_nd);
-            met_h_zeta = Compute_h_zeta_AtEdgeCenterI(i,j,k,dxInv,z_nd);
+            met_h_xi   = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.ei);
+            met_h_eta  = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.ei);
+            met_h_zeta = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ei);
 
             Real tau21lo  = 0.5 * ( tau21(i  , j  , k  ) + tau21(i+1, j  , k  ) );
             Real tau21hi  = 0.5 * ( tau21(i  , j  , k+1) + tau21(i+1, j  , k+1) );
@@ -135,9 +137,9 @@ ComputeStressConsVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
         amrex::ParallelFor(planexz,[=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
             Real met_h_xi,met_h_eta,met_h_zeta;
-            met_h_xi   = Compute_h_xi_AtEdgeCenterJ  (i,j,k,dxInv,z_nd);
-            met_h_eta  = Compute_h_eta_AtEdgeCenterJ (i,j,k,dxInv,z_nd);
-            met_h_zeta = Compute_h_zeta_AtEdgeCenterJ(i,j,k,dxInv,z_nd);
+            met_h_xi   = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.ej);
+            met_h_eta  = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.ej);
+            met_h_zeta = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ej);
 
             Real tau11lo  = 0.5 * ( tau11(i  , j  , k-2) + tau11(i-1, j  , k-2) );
             Real tau11hi  = 0.5 * ( tau11(i  , j  , k-1) + tau11(i-1, j  , k-1) );
@@ -160,9 +162,9 @@ ComputeStressConsVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
         amrex::ParallelFor(planeyz,[=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
             Real met_h_xi,met_h_eta,met_h_zeta;
-            met_h_xi   = Compute_h_xi_AtEdgeCenterI  (i,j,k,dxInv,z_nd);
-            met_h_eta  = Compute_h_eta_AtEdgeCenterI (i,j,k,dxInv,z_nd);
-            met_h_zeta = Compute_h_zeta_AtEdgeCenterI(i,j,k,dxInv,z_nd);
+            met_h_xi   = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.ei);
+            met_h_eta  = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.ei);
+            met_h_zeta = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ei);
 
             Real tau21lo  = 0.5 * ( tau21(i  , j  , k-2) + tau21(i+1, j  , k-2) );
             Real tau21hi  = 0.5 * ( tau21(i  , j  , k-1) + tau21(i+1, j  , k-1) );
@@ -189,9 +191,9 @@ ComputeStressConsVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
     [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
     {
         Real met_h_xi,met_h_eta,met_h_zeta;
-        met_h_xi   = Compute_h_xi_AtEdgeCenterJ  (i,j,k,dxInv,z_nd);
-        met_h_eta  = Compute_h_eta_AtEdgeCenterJ (i,j,k,dxInv,z_nd);
-        met_h_zeta = Compute_h_zeta_AtEdgeCenterJ(i,j,k,dxInv,z_nd);
+        met_h_xi   = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.ej);
+        met_h_eta  = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.ej);
+        met_h_zeta = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ej);
 
         Real tau11bar = 0.25 * ( tau11(i  , j  , k  ) + tau11(i-1, j  , k  )
                                + tau11(i  , j  , k-1) + tau11(i-1, j  , k-1) );
@@ -207,9 +209,9 @@ ComputeStressConsVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
     [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
     {
         Real met_h_xi,met_h_eta,met_h_zeta;
-        met_h_xi   = Compute_h_xi_AtEdgeCenterI  (i,j,k,dxInv,z_nd);
-        met_h_eta  = Compute_h_eta_AtEdgeCenterI (i,j,k,dxInv,z_nd);
-        met_h_zeta = Compute_h_zeta_AtEdgeCenterI(i,j,k,dxInv,z_nd);
+        met_h_xi   = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.ei);
+        met_h_eta  = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.ei);
+        met_h_zeta = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ei);
 
         Real tau21bar = 0.25 * ( tau21(i  , j  , k  ) + tau21(i+1, j  , k  )
                                + tau21(i  , j  , k-1) + tau21(i+1, j  , k-1) );
@@ -229,7 +231,7 @@ ComputeStressConsVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
     [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
     {
         Real met_h_zeta;
-        met_h_zeta = Compute_h_zeta_AtCellCenter(i,j,k,dxInv,z_nd);
+        met_h_zeta = Get_h_AtCellCenter(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.cc);
         Real mu_tot = mu_eff;
 
         tau11(i,j,k) *= -mu_tot*met_h_zeta;
@@ -238,7 +240,7 @@ ComputeStressConsVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
     [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
     {
         Real met_h_zeta;
-        met_h_zeta = Compute_h_zeta_AtEdgeCenterK(i,j,k,dxInv,z_nd);
+        met_h_zeta = Get_h_AtEdgeCenterK(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ek);
 
         Real mu_tot = mu_eff;
 
@@ -267,7 +269,11 @@ ComputeStressConsVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
  * @param[in,out] tau32 32 strain -> stress
  * @param[in]  er_arr expansion rate
  * @param[in]  z_nd nodal array of physical z heights
+ * @param[in]  met cached metrics at cell centers and edges (null arrays without a cache)
  * @param[in]  dxInv inverse cell size array
+ * @param[in]  implicit_vert leave the turbulent part of tau_13 and tau_23 on the
+ *             interior z-faces to ImplicitVertDiffusion
+ * @param[in]  domain box of the whole domain
  */
 void
 ComputeStressVarVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
@@ -278,8 +284,15 @@ ComputeStressVarVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
                         Array4<Real>& tau31, Array4<Real>& tau32,
                         const Array4<const Real>& er_arr,
                         const Array4<const Real>& z_nd  ,
-                        const GpuArray<Real, AMREX_SPACEDIM>& dxInv)
+                        const TerrainMetricArrays& met,
+                        const GpuArray<Real, AMREX_SPACEDIM>& dxInv,
+                        const bool implicit_vert,
+                        const Box& domain)
 {
+    // Bottom and top faces of the domain
+    const int klo = domain.smallEnd(2);
+    const int khi = domain.bigEnd(2) + 1;
+
     //***********************************************************************************
     // NOTE: The first  block computes (S-D).
     //       The second block computes 2mu*JT*(S-D)
@@ -305,8 +318,8 @@ ComputeStressVarVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
     [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
     {
         Real met_h_xi,met_h_eta;
-        met_h_xi   = Compute_h_xi_AtCellCenter  (i,j,k,dxInv,z_nd);
-        met_h_eta  = Compute_h_eta_AtCellCenter (i,j,k,dxInv,z_nd);
+        met_h_xi   = Get_h_AtCellCenter(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.cc);
+        met_h_eta  = Get_h_AtCellCenter(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.cc);
 
         Real tau31bar = 0.25 * ( tau31(i  , j  , k  ) + tau31(i+1, j  , k  )
                                + tau31(i  , j  , k+1) + tau31(i+1, j  , k+1) );
@@ -330,9 +343,9 @@ ComputeStressVarVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
         amrex::ParallelFor(planexz,[=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
             Real met_h_xi,met_h_eta,met_h_zeta;
-            met_h_xi   = Compute_h_xi_AtEdgeCenterJ  (i,j,k,dxInv,z_nd);
-            met_h_eta  = Compute_h_eta_AtEdgeCenterJ (i,j,k,dxInv,z_nd);
-            met_h_zeta = Compute_h_zeta_AtEdgeCenterJ(i,j,k,dxInv,z_nd);
+            met_h_xi   = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.ej);
+            met_h_eta  = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.ej);
+            met_h_zeta = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ej);
 
             Real tau11lo  = 0.5 * ( tau11(i  , j  , k  ) + tau11(i-1, j  , k  ) );
             Real tau11hi  = 0.5 * ( tau11(i  , j  , k+1) + tau11(i-1, j  , k+1) );
@@ -344,6 +357,7 @@ ComputeStressVarVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
 
             Real mu_bar = 0.25*( mu_turb(i-1, j, k  , EddyDiff::Mom_v) + mu_turb(i, j, k  , EddyDiff::Mom_v)
                                + mu_turb(i-1, j, k-1, EddyDiff::Mom_v) + mu_turb(i, j, k-1, EddyDiff::Mom_v) );
+            if (implicit_vert && k > klo && k < khi) mu_bar = 0.0;
             Real mu_tot = mu_eff + 2.0*mu_bar;
 
             tau13(i,j,k) -= met_h_xi*tau11bar + met_h_eta*tau12bar;
@@ -357,9 +371,9 @@ ComputeStressVarVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
         amrex::ParallelFor(planeyz,[=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
             Real met_h_xi,met_h_eta,met_h_zeta;
-            met_h_xi   = Compute_h_xi_AtEdgeCenterI  (i,j,k,dxInv,z_nd);
-            met_h_eta  = Compute_h_eta_AtEdgeCenterI (i,j,k,dxInv,z_nd);
-            met_h_zeta = Compute_h_zeta_AtEdgeCenterI(i,j,k,dxInv,z_nd);
+            met_h_xi   = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.ei);
+            met_h_eta  = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.ei);
+            met_h_zeta = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ei);
 
             Real tau21lo  = 0.5 * ( tau21(i  , j  , k  ) + tau21(i+1, j  , k  ) );
             Real tau21hi  = 0.5 * ( tau21(i  , j  , k+1) + tau21(i+1, j  , k+1) );
@@ -371,6 +385,7 @@ ComputeStressVarVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
 
             Real mu_bar = 0.25*( mu_turb(i, j-1, k  , EddyDiff::Mom_v) + mu_turb(i, j, k  , EddyDiff::Mom_v)
                                + mu_turb(i, j-1, k-1, EddyDiff::Mom_v) + mu_turb(i, j, k-1, EddyDiff::Mom_v) );
+            if (implicit_vert && k > klo && k < khi) mu_bar = 0.0;
             Real mu_tot = mu_eff + 2.0*mu_bar;
 
             tau23(i,j,k) -= met_h_xi*tau21bar + met_h_eta*tau22bar;
@@ -386,9 +401,9 @@ ComputeStressVarVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
         amrex::ParallelFor(planexz,[=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
             Real met_h_xi,met_h_eta,met_h_zeta;
-            met_h_xi   = Compute_h_xi_AtEdgeCenterJ  (i,j,k,dxInv,z_nd);
-            met_h_eta  = Compute_h_eta_AtEdgeCenterJ (i,j,k,dxInv,z_nd);
-            met_h_zeta = Compute_h_zeta_AtEdgeCenterJ(i,j,k,dxInv,z_nd);
+            met_h_xi   = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.ej);
+            met_h_eta  = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.ej);
+            met_h_zeta = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ej);
 
             Real tau11lo  = 0.5 * ( tau11(i  , j  , k-2) + tau11(i-1, j  , k-2) );
             Real tau11hi  = 0.5 * ( tau11(i  , j  , k-1) + tau11(i-1, j  , k-1) );
@@ -400,6 +415,7 @@ ComputeStressVarVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
 
             Real mu_bar = 0.25*( mu_turb(i-1, j, k  , EddyDiff::Mom_v) + mu_turb(i, j, k  , EddyDiff::Mom_v)
                                + mu_turb(i-1, j, k-1, EddyDiff::Mom_v) + mu_turb(i, j, k-1, EddyDiff::Mom_v) );
+            if (implicit_vert && k > klo && k < khi) mu_bar = 0.0;
             Real mu_tot = mu_eff + 2.0*mu_bar;
 
             tau13(i,j,k) -= met_h_xi*tau11bar + met_h_eta*tau12bar;
@@ -413,9 +429,9 @@ ComputeStressVarVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
         amrex::ParallelFor(planeyz,[=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
             Real met_h_xi,met_h_eta,met_h_zeta;
-            met_h_xi   = Compute_h_xi_AtEdgeCenterI  (i,j,k,dxInv,z_nd);
-            met_h_eta  = Compute_h_eta_AtEdgeCenterI (i,j,k,dxInv,z_nd);
-            met_h_zeta = Compute_h_zeta_AtEdgeCenterI(i,j,k,dxInv,z_nd);
+            met_h_xi   = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.ei);
+            met_h_eta  = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.ei);
+            met_h_zeta = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ei);
 
             Real tau21lo  = 0.5 * ( tau21(i  , j  , k-2) + tau21(i+1, j  , k-2) );
             Real tau21hi  = 0.5 * ( tau21(i  , j  , k-1) + tau21(i+1, j  , k-1) );
@@ -427,6 +443,7 @@ ComputeStressVarVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
 
             Real mu_bar = 0.25*( mu_turb(i, j-1, k  , EddyDiff::Mom_v) + mu_turb(i, j, k  , EddyDiff::Mom_v)
                                + mu_turb(i, j-1, k-1, EddyDiff::Mom_v) + mu_turb(i, j, k-1, EddyDiff::Mom_v) );
+            if (implicit_vert && k > klo && k < khi) mu_bar = 0.0;
             Real mu_tot = mu_eff + 2.0*mu_bar;
 
             tau23(i,j,k) -= met_h_xi*tau21bar + met_h_eta*tau22bar;
@@ -444,9 +461,9 @@ ComputeStressVarVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
     [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
     {
         Real met_h_xi,met_h_eta,met_h_zeta;
-        met_h_xi   = Compute_h_xi_AtEdgeCenterJ  (i,j,k,dxInv,z_nd);
-        met_h_eta  = Compute_h_eta_AtEdgeCenterJ (i,j,k,dxInv,z_nd);
-        met_h_zeta = Compute_h_zeta_AtEdgeCenterJ(i,j,k,dxInv,z_nd);
+        met_h_xi   = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.ej);
+        met_h_eta  = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.ej);
+        met_h_zeta = Get_h_AtEdgeCenterJ(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ej);
 
         Real tau11bar = 0.25 * ( tau11(i  , j  , k  ) + tau11(i-1, j  , k  )
                                + tau11(i  , j  , k-1) + tau11(i-1, j  , k-1) );
@@ -455,6 +472,7 @@ ComputeStressVarVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
 
         Real mu_bar = 0.25 * ( mu_turb(i-1, j  , k  , EddyDiff::Mom_v) + mu_turb(i  , j  , k  , EddyDiff::Mom_v)
                               + mu_turb(i-1, j  , k-1, EddyDiff::Mom_v) + mu_turb(i  , j  , k-1, EddyDiff::Mom_v) );
+        if (implicit_vert && k > klo && k < khi) mu_bar = 0.0;
         Real mu_tot = mu_eff + 2.0*mu_bar;
 
         tau13(i,j,k) -= met_h_xi*tau11bar + met_h_eta*tau12bar;
@@ -465,9 +483,9 @@ ComputeStressVarVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
     [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
     {
         Real met_h_xi,met_h_eta,met_h_zeta;
-        met_h_xi   = Compute_h_xi_AtEdgeCenterI  (i,j,k,dxInv,z_nd);
-        met_h_eta  = Compute_h_eta_AtEdgeCenterI (i,j,k,dxInv,z_nd);
-        met_h_zeta = Compute_h_zeta_AtEdgeCenterI(i,j,k,dxInv,z_nd);
+        met_h_xi   = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_xi  ,dxInv,z_nd,met.ei);
+        met_h_eta  = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_eta ,dxInv,z_nd,met.ei);
+        met_h_zeta = Get_h_AtEdgeCenterI(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ei);
 
         Real tau21bar = 0.25 * ( tau21(i  , j  , k  ) + tau21(i+1, j  , k  )
                                + tau21(i  , j  , k-1) + tau21(i+1, j  , k-1) );
@@ -476,6 +494,7 @@ ComputeStressVarVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
 
         Real mu_bar = 0.25 * ( mu_turb(i  , j-1, k  , EddyDiff::Mom_v) + mu_turb(i  , j  , k  , EddyDiff::Mom_v)
                              + mu_turb(i  , j-1, k-1, EddyDiff::Mom_v) + mu_turb(i  , j  , k-1, EddyDiff::Mom_v) );
+        if (implicit_vert && k > klo && k < khi) mu_bar = 0.0;
         Real mu_tot = mu_eff + 2.0*mu_bar;
 
         tau23(i,j,k) -= met_h_xi*tau21bar + met_h_eta*tau22bar;
@@ -490,7 +509,7 @@ ComputeStressVarVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
     [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
     {
         Real met_h_zeta;
-        met_h_zeta = Compute_h_zeta_AtCellCenter(i,j,k,dxInv,z_nd);
+        met_h_zeta = Get_h_AtCellCenter(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.cc);
 
         Real mu_tot = mu_eff + 2.0*mu_turb(i, j, k, EddyDiff::Mom_h);
 
@@ -500,7 +519,7 @@ ComputeStressVarVisc_T (Box bxcc, Box tbxxy, Box tbxxz, Box tbxyz, Real mu_eff,
     [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
     {
         Real met_h_zeta;
-        met_h_zeta = Compute_h_zeta_AtEdgeCenterK(i,j,k,dxInv,z_nd);
+        met_h_zeta = Get_h_AtEdgeCenterK(i,j,k,TerrMet::h_zeta,dxInv,z_nd,met.ek);
 
         Real mu_bar = 0.25*( mu_turb(i-1, j  , k, EddyDiff::Mom_h) + mu_turb(i, j  , k, EddyDiff::Mom_h)
                            + mu_turb(i-1, j-1, k, EddyDiff::Mom_h) + mu_turb(i, j-1, k, EddyDiff::Mom_h) );
@@ -3,7 +3,7 @@
 #include <ABLMost.H>
 #include <EddyViscosity.H>
 #include <Diffusion.H>
-#include <TileNoZ.H>
+#include <MatrixFreeStress.H>
 
 using namespace amrex;
 
@@ -17,11 +17,24 @@ ComputeTurbulentViscosityPBL (const amrex::MultiFab& xvel,
                               std::unique_ptr<ABLMost>& most,
                               const amrex::BCRec* bc_ptr,
                               bool /*vert_only*/,
-                              const std::unique_ptr<amrex::MultiFab>& z_phys_nd);
+                              const std::unique_ptr<amrex::MultiFab>& z_phys_nd,
+                              const int& level);
 
 /**
  * Function for computing the turbulent viscosity with LES.
  *
+ * A single kernel per tile evaluates the closure (strain magnitude for
+ * Smagorinsky; mixing length, SFS heat flux and dissipation for Deardorff),
+ * writes the eddy viscosity and all the diffusivities derived from it, and
+ * extrapolates them into the ghost cells: the lateral ghost cells outside a
+ * non-periodic domain take the closure of the nearest interior cell and the
+ * ghost cells below/above the box repeat the bottom/top cell. Without terrain
+ * the Smagorinsky strain is evaluated in the kernel (MatrixFreeStress_N), with
+ * terrain it is read from the strain stored in Tau.
+ *
+ * @param[in]  xvel velocity in x-dir
+ * @param[in]  yvel velocity in y-dir
+ * @param[in]  zvel velocity in z-dir
  * @param[in]  Tau11 11 strain
  * @param[in]  Tau22 22 strain
  * @param[in]  Tau33 33 strain
@@ -35,78 +48,76 @@ ComputeTurbulentViscosityPBL (const amrex::MultiFab& xvel,
  * @param[in]  Hfx3 heat flux in z-dir
  * @param[in]  Diss dissipation of turbulent kinetic energy
  * @param[in]  geom problem geometry
+ * @param[in]  mapfac_m map factor at cell center
  * @param[in]  mapfac_u map factor at x-face
  * @param[in]  mapfac_v map factor at y-face
  * @param[in]  turbChoice container with turbulence parameters
+ * @param[in]  const_grav gravitational acceleration
+ * @param[in]  use_terrain the strain is stored in Tau (terrain)
+ * @param[in]  bc_ptr_h container with boundary condition types (host)
  */
-void ComputeTurbulentViscosityLES (const amrex::MultiFab& Tau11, const amrex::MultiFab& Tau22, const amrex::MultiFab& Tau33,
-                                   const amrex::MultiFab& Tau12, const amrex::MultiFab& Tau13, const amrex::MultiFab& Tau23,
+void ComputeTurbulentViscosityLES (const amrex::MultiFab& xvel, const amrex::MultiFab& yvel, const amrex::MultiFab& zvel,
+                                   const amrex::MultiFab* Tau11, const amrex::MultiFab* Tau22, const amrex::MultiFab* Tau33,
+                                   const amrex::MultiFab* Tau12, const amrex::MultiFab* Tau13, const amrex::MultiFab* Tau23,
                                    const amrex::MultiFab& cons_in, amrex::MultiFab& eddyViscosity,
                                    amrex::MultiFab& Hfx1, amrex::MultiFab& Hfx2, amrex::MultiFab& Hfx3, amrex::MultiFab& Diss,
                                    const amrex::Geometry& geom,
+                                   const amrex::MultiFab& mapfac_m,
                                    const amrex::MultiFab& mapfac_u, const amrex::MultiFab& mapfac_v,
-                                   const TurbChoice& turbChoice, const Real const_grav)
+                                   const TurbChoice& turbChoice, const Real const_grav,
+                                   const bool& use_terrain, const amrex::BCRec* bc_ptr_h)
 {
     const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dxInv = geom.InvCellSizeArray();
     const Box& domain = geom.Domain();
 
-    // SMAGORINSKY: Fill Kturb for momentum in horizontal and vertical
-    //***********************************************************************************
-    if (turbChoice.les_type == LESType::Smagorinsky)
-    {
-      Real Cs = turbChoice.Cs;
-
-#ifdef _OPENMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
-      for (amrex::MFIter mfi(eddyViscosity,amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
-      {
-          // NOTE: This gets us the lateral ghost cells for lev>0; which
-          //       have been filled from FP Two Levels.
-          Box bxcc  = mfi.growntilebox() & domain;
+    // With terrain the Smagorinsky strain is read from Tau, otherwise it is evaluated here
+    const bool l_smag          = (turbChoice.les_type == LESType::Smagorinsky);
+    const bool l_strain_stored = use_terrain;
+    if (l_smag && l_strain_stored) {
+        AMREX_ALWAYS_ASSERT(Tau11 && Tau22 && Tau33 && Tau12 && Tau13 && Tau23);
+    }
 
-          const Array4<Real>& mu_turb = eddyViscosity.array(mfi);
-          const amrex::Array4<amrex::Real const > &cell_data = cons_in.array(mfi);
+    // SMAGORINSKY
+    const amrex::Real Cs           = turbChoice.Cs;
 
-          Array4<Real const> tau11 = Tau11.array(mfi);
-          Array4<Real const> tau22 = Tau22.array(mfi);
-          Array4<Real const> tau33 = Tau33.array(mfi);
-          Array4<Real const> tau12 = Tau12.array(mfi);
-          Array4<Real const> tau13 = Tau13.array(mfi);
-          Array4<Real const> tau23 = Tau23.array(mfi);
+    // DEARDORFF
+    const amrex::Real l_C_k        = turbChoice.Ck;
+    const amrex::Real l_C_e        = turbChoice.Ce;
+    const amrex::Real l_C_e_wall   = turbChoice.Ce_wall;
+    const amrex::Real Ce_lcoeff    = amrex::max(0.0, l_C_e - 1.9*l_C_k);
+    const amrex::Real l_abs_g      = const_grav;
+    const amrex::Real l_inv_theta0 = 1.0 / turbChoice.theta_ref;
 
-          Array4<Real const> mf_u = mapfac_u.array(mfi);
-          Array4<Real const> mf_v = mapfac_v.array(mfi);
+    // Diffusivities as multiples of the eddy viscosity (alpha = mu/Pr)
+    //***********************************************************************************
+    constexpr int offset = (EddyDiff::NumDiffs-1)/2;
+    Real inv_Pr_t    = turbChoice.Pr_t_inv;
+    Real inv_Sc_t    = turbChoice.Sc_t_inv;
+    Real inv_sigma_k = 1.0 / turbChoice.sigma_k;
+    // EddyDiff mapping :          Mom_h Theta_h   Scalar_h  KE_h         QKE_h        Q1_h      Q2_h      Q3_h
+    GpuArray<Real,offset> fac = {  1.0,  inv_Pr_t, inv_Sc_t, inv_sigma_k, inv_sigma_k, inv_Sc_t, inv_Sc_t, inv_Sc_t };
 
-          ParallelFor(bxcc, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-          {
-              Real SmnSmn = ComputeSmnSmn(i,j,k,tau11,tau22,tau33,tau12,tau13,tau23);
-              Real cellVolMsf = 1.0 / (dxInv[0] * mf_u(i,j,0) * dxInv[1] * mf_v(i,j,0) * dxInv[2]);
-              Real DeltaMsf   = std::pow(cellVolMsf,1.0/3.0);
-              Real CsDeltaSqrMsf = Cs*Cs*DeltaMsf*DeltaMsf;
+    bool use_KE  = (turbChoice.les_type == LESType::Deardorff);
+    bool use_QKE = (turbChoice.use_QKE && turbChoice.diffuse_QKE_3D);
 
-              mu_turb(i, j, k, EddyDiff::Mom_h) = CsDeltaSqrMsf * cell_data(i, j, k, Rho_comp) * std::sqrt(2.0*SmnSmn);
-              mu_turb(i, j, k, EddyDiff::Mom_v) = mu_turb(i, j, k, EddyDiff::Mom_h);
-          });
-      }
-    }
-    // DEARDORFF: Fill Kturb for momentum in horizontal and vertical
-    //***********************************************************************************
-    else if (turbChoice.les_type == LESType::Deardorff)
-    {
-      const amrex::Real l_C_k        = turbChoice.Ck;
-      const amrex::Real l_C_e        = turbChoice.Ce;
-      const amrex::Real l_C_e_wall   = turbChoice.Ce_wall;
-      const amrex::Real Ce_lcoeff    = amrex::max(0.0, l_C_e - 1.9*l_C_k);
-      const amrex::Real l_abs_g      = const_grav;
-      const amrex::Real l_inv_theta0 = 1.0 / turbChoice.theta_ref;
+    // Lateral ghost cells outside a non-periodic domain are extrapolated
+    const bool clamp_x = !geom.isPeriodic(0);
+    const bool clamp_y = !geom.isPeriodic(1);
+    const int dom_ilo = domain.smallEnd(0); const int dom_ihi = domain.bigEnd(0);
+    const int dom_jlo = domain.smallEnd(1); const int dom_jhi = domain.bigEnd(1);
 
 #ifdef _OPENMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
-      for ( amrex::MFIter mfi(eddyViscosity,amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
-      {
-          Box bxcc  = mfi.tilebox();
+    for ( amrex::MFIter mfi(eddyViscosity,amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        // NOTE: The lateral ghost cells of the box are included. Those inside the
+        //       domain are overwritten by FillBoundary below, except at coarse-fine
+        //       boundaries where they come from the data filled from the coarse level.
+        Box gbx = mfi.growntilebox(IntVect(1,1,0));
+        Box tbx = mfi.tilebox();
+        int k_lo = mfi.validbox().smallEnd(2);
+        int k_hi = mfi.validbox().bigEnd(2);
 
         const Array4<Real>& mu_turb = eddyViscosity.array(mfi);
         const Array4<Real>& hfx_x   = Hfx1.array(mfi);
@@ -116,225 +127,93 @@ void ComputeTurbulentViscosityLES (const amrex::MultiFab& Tau11, const amrex::Mu
 
         const amrex::Array4<amrex::Real const > &cell_data = cons_in.array(mfi);
 
+        Array4<Real const> mf_m = mapfac_m.array(mfi);
         Array4<Real const> mf_u = mapfac_u.array(mfi);
         Array4<Real const> mf_v = mapfac_v.array(mfi);
 
-        ParallelFor(bxcc, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-        {
-          Real cellVolMsf = 1.0 / (dxInv[0] * mf_u(i,j,0) * dxInv[1] * mf_v(i,j,0) * dxInv[2]);
-          Real DeltaMsf   = std::pow(cellVolMsf,1.0/3.0);
-
-          // Calculate stratification-dependent mixing length (Deardorff 1980)
-          Real eps       = std::numeric_limits<Real>::epsilon();
-          Real dtheta_dz = 0.5 * ( cell_data(i,j,k+1,RhoTheta_comp)/cell_data(i,j,k+1,Rho_comp)
-                                 - cell_data(i,j,k-1,RhoTheta_comp)/cell_data(i,j,k-1,Rho_comp) )*dxInv[2];
-          Real E         = cell_data(i,j,k,RhoKE_comp) / cell_data(i,j,k,Rho_comp);
-          Real strat     = l_abs_g * dtheta_dz * l_inv_theta0; // stratification
-          Real length;
-          if (strat <= eps) {
-              length = DeltaMsf;
-          } else {
-              length = 0.76 * std::sqrt(E / strat);
-              // mixing length should be _reduced_ for stable stratification
-              length = amrex::min(length, DeltaMsf);
-              // following WRF, make sure the mixing length isn't too small
-              length = amrex::max(length, 0.001 * DeltaMsf);
-          }
-
-          // Calculate eddy diffusivities
-          // K = rho * C_k * l * KE^(1/2)
-          mu_turb(i,j,k,EddyDiff::Mom_h) = cell_data(i,j,k,Rho_comp) * l_C_k * length * std::sqrt(E);
-          mu_turb(i,j,k,EddyDiff::Mom_v) = mu_turb(i,j,k,EddyDiff::Mom_h);
-          // KH = (1 + 2*l/delta) * mu_turb
-          mu_turb(i,j,k,EddyDiff::Theta_v) = (1.+2.*length/DeltaMsf) * mu_turb(i,j,k,EddyDiff::Mom_v);
-
-          // Calculate SFS quantities
-          // - dissipation
-          amrex::Real Ce;
-          if ((l_C_e_wall > 0) && (k==0))
-              Ce = l_C_e_wall;
-          else
-              Ce = 1.9*l_C_k + Ce_lcoeff*length / DeltaMsf;
-          diss(i,j,k) = cell_data(i,j,k,Rho_comp) * Ce * std::pow(E,1.5) / length;
-          // - heat flux
-          hfx_x(i,j,k) = 0.0;
-          hfx_y(i,j,k) = 0.0;
-          hfx_z(i,j,k) = -mu_turb(i,j,k,EddyDiff::Theta_v) * dtheta_dz; // (rho*w)' theta' [kg m^-2 s^-1 K]
-        });
-      }
-    }
-
-    // Extrapolate Kturb in x/y, fill remaining elements (relevent to lev==0)
-    //***********************************************************************************
-    int ngc(1);
-    Real inv_Pr_t    = turbChoice.Pr_t_inv;
-    Real inv_Sc_t    = turbChoice.Sc_t_inv;
-    Real inv_sigma_k = 1.0 / turbChoice.sigma_k;
-    // EddyDiff mapping :   Theta_h   Scalar_h  KE_h         QKE_h        Q1_h      Q2_h      Q3_h
-    Vector<Real> Factors = {inv_Pr_t, inv_Sc_t, inv_sigma_k, inv_sigma_k, inv_Sc_t, inv_Sc_t, inv_Sc_t}; // alpha = mu/Pr
-    Gpu::AsyncVector<Real> d_Factors; d_Factors.resize(Factors.size());
-    Gpu::copy(Gpu::hostToDevice, Factors.begin(), Factors.end(), d_Factors.begin());
-    Real* fac_ptr = d_Factors.data();
-
-    bool use_KE  = (turbChoice.les_type == LESType::Deardorff);
-    bool use_QKE = (turbChoice.use_QKE && turbChoice.diffuse_QKE_3D);
+        Array4<Real const> tau11 = (l_smag && l_strain_stored) ? Tau11->array(mfi) : Array4<Real const>{};
+        Array4<Real const> tau22 = (l_smag && l_strain_stored) ? Tau22->array(mfi) : Array4<Real const>{};
+        Array4<Real const> tau33 = (l_smag && l_strain_stored) ? Tau33->array(mfi) : Array4<Real const>{};
+        Array4<Real const> tau12 = (l_smag && l_strain_stored) ? Tau12->array(mfi) : Array4<Real const>{};
+        Array4<Real const> tau13 = (l_smag && l_strain_stored) ? Tau13->array(mfi) : Array4<Real const>{};
+        Array4<Real const> tau23 = (l_smag && l_strain_stored) ? Tau23->array(mfi) : Array4<Real const>{};
 
-#ifdef _OPENMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
-    for ( amrex::MFIter mfi(eddyViscosity,amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
-    {
-        Box bxcc   = mfi.tilebox();
-        Box planex = bxcc; planex.setSmall(0, 1); planex.setBig(0, ngc); planex.grow(1,1);
-        Box planey = bxcc; planey.setSmall(1, 1); planey.setBig(1, ngc); planey.grow(0,1);
-        int i_lo   = bxcc.smallEnd(0); int i_hi = bxcc.bigEnd(0);
-        int j_lo   = bxcc.smallEnd(1); int j_hi = bxcc.bigEnd(1);
-        bxcc.growLo(0,ngc); bxcc.growHi(0,ngc);
-        bxcc.growLo(1,ngc); bxcc.growHi(1,ngc);
-
-        const Array4<Real>& mu_turb = eddyViscosity.array(mfi);
+        MatrixFreeStress_N st{xvel.const_array(mfi), yvel.const_array(mfi), zvel.const_array(mfi),
+                              Array4<Real const>{}, mf_m, mf_u, mf_v, dxInv, 0.0, false};
+        st.set_bcs(bc_ptr_h, domain);
 
-        // Extrapolate outside the domain in lateral directions (planex owns corner cells)
-        if (i_lo == domain.smallEnd(0)) {
-            amrex::ParallelFor(planex, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-            {
-                int lj = amrex::min(amrex::max(j, domain.smallEnd(1)), domain.bigEnd(1));
-                mu_turb(i_lo-i, j, k, EddyDiff::Mom_h) = mu_turb(i_lo, lj, k, EddyDiff::Mom_h);
-                mu_turb(i_lo-i, j, k, EddyDiff::Mom_v) = mu_turb(i_lo, lj, k, EddyDiff::Mom_v);
-            });
-        }
-        if (i_hi == domain.bigEnd(0)) {
-            amrex::ParallelFor(planex, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-            {
-                int lj = amrex::min(amrex::max(j, domain.smallEnd(1)), domain.bigEnd(1));
-                mu_turb(i_hi+i, j, k, EddyDiff::Mom_h) = mu_turb(i_hi, lj, k, EddyDiff::Mom_h);
-                mu_turb(i_hi+i, j, k, EddyDiff::Mom_v) = mu_turb(i_hi, lj, k, EddyDiff::Mom_v);
-            });
-        }
-        if (j_lo == domain.smallEnd(1)) {
-            amrex::ParallelFor(planey, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-            {
-                int li = amrex::min(amrex::max(i, domain.smallEnd(0)), domain.bigEnd(0));
-                mu_turb(i, j_lo-j, k, EddyDiff::Mom_h) = mu_turb(li, j_lo, k, EddyDiff::Mom_h);
-                mu_turb(i, j_lo-j, k, EddyDiff::Mom_v) = mu_turb(li, j_lo, k, EddyDiff::Mom_v);
-            });
-        }
-        if (j_hi == domain.bigEnd(1)) {
-            amrex::ParallelFor(planey, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-            {
-                int li = amrex::min(amrex::max(i, domain.smallEnd(0)), domain.bigEnd(0));
-                mu_turb(i, j_hi+j, k, EddyDiff::Mom_h) = mu_turb(li, j_hi, k, EddyDiff::Mom_h);
-                mu_turb(i, j_hi+j, k, EddyDiff::Mom_v) = mu_turb(li, j_hi, k, EddyDiff::Mom_v);
-            });
-        }
+        ParallelFor(gbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            // Cell whose closure is written to (i,j,k)
+            int ii = (clamp_x) ? amrex::min(amrex::max(i, dom_ilo), dom_ihi) : i;
+            int jj = (clamp_y) ? amrex::min(amrex::max(j, dom_jlo), dom_jhi) : j;
+
+            Real cellVolMsf = 1.0 / (dxInv[0] * mf_u(ii,jj,0) * dxInv[1] * mf_v(ii,jj,0) * dxInv[2]);
+            Real DeltaMsf   = std::pow(cellVolMsf,1.0/3.0);
+
+            Real mu;
+            if (l_smag) {
+                // SMAGORINSKY: Kturb from the strain magnitude
+                Real SmnSmn = (l_strain_stored) ? ComputeSmnSmn(ii,jj,k,tau11,tau22,tau33,tau12,tau13,tau23)
+                                                : st.SmnSmn(ii,jj,k);
+                Real CsDeltaSqrMsf = Cs*Cs*DeltaMsf*DeltaMsf;
+
+                mu = CsDeltaSqrMsf * cell_data(ii, jj, k, Rho_comp) * std::sqrt(2.0*SmnSmn);
+            } else {
+                // DEARDORFF: Kturb from the SFS kinetic energy
+                // Calculate stratification-dependent mixing length (Deardorff 1980)
+                Real eps       = std::numeric_limits<Real>::epsilon();
+                Real dtheta_dz = 0.5 * ( cell_data(ii,jj,k+1,RhoTheta_comp)/cell_data(ii,jj,k+1,Rho_comp)
+                                       - cell_data(ii,jj,k-1,RhoTheta_comp)/cell_data(ii,jj,k-1,Rho_comp) )*dxInv[2];
+                Real E         = cell_data(ii,jj,k,RhoKE_comp) / cell_data(ii,jj,k,Rho_comp);
+                Real strat     = l_abs_g * dtheta_dz * l_inv_theta0; // stratification
+                Real length;
+                if (strat <= eps) {
+                    length = DeltaMsf;
+                } else {
+                    length = 0.76 * std::sqrt(E / strat);
+                    // mixing length should be _reduced_ for stable stratification
+                    length = amrex::min(length, DeltaMsf);
+                    // following WRF, make sure the mixing length isn't too small
+                    length = amrex::max(length, 0.001 * DeltaMsf);
+                }
 
-        // refactor the code to eliminate the need for ifdef's
-        for (auto n = 1; n < (EddyDiff::NumDiffs-1)/2; ++n) {
-            int offset = (EddyDiff::NumDiffs-1)/2;
-            switch (n)
-            {
-              case EddyDiff::QKE_h:
-                 // Populate element other than mom_h/v on the whole grid
-                 if(use_QKE) {
-                   ParallelFor(bxcc, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                   {
-                     int indx   = n;
-                     int indx_v = indx + offset;
-                     mu_turb(i,j,k,indx)   = mu_turb(i,j,k,EddyDiff::Mom_h) * fac_ptr[indx-1];
-                     mu_turb(i,j,k,indx_v) = mu_turb(i,j,k,indx);
-                  });
-                 }
-                 break;
-             case EddyDiff::KE_h:
-                if (use_KE) {
-                   ParallelFor(bxcc, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                   {
-                     int indx   = n;
-                     int indx_v = indx + offset;
-                     mu_turb(i,j,k,indx)   = mu_turb(i,j,k,EddyDiff::Mom_h) * fac_ptr[indx-1];
-                     mu_turb(i,j,k,indx_v) = mu_turb(i,j,k,indx);
-                   });
+                // Calculate eddy diffusivities
+                // K = rho * C_k * l * KE^(1/2)
+                mu = cell_data(ii,jj,k,Rho_comp) * l_C_k * length * std::sqrt(E);
+
+                // Calculate SFS quantities (valid cells only)
+                if (tbx.contains(i,j,k)) {
+                    // - dissipation
+                    amrex::Real Ce;
+                    if ((l_C_e_wall > 0) && (k==0))
+                        Ce = l_C_e_wall;
+                    else
+                        Ce = 1.9*l_C_k + Ce_lcoeff*length / DeltaMsf;
+                    diss(i,j,k) = cell_data(i,j,k,Rho_comp) * Ce * std::pow(E,1.5) / length;
+                    // - heat flux, with KH = (1 + 2*l/delta) * mu_turb
+                    Real KH = (1.+2.*length/DeltaMsf) * mu;
+                    hfx_x(i,j,k) = 0.0;
+                    hfx_y(i,j,k) = 0.0;
+                    hfx_z(i,j,k) = -KH * dtheta_dz; // (rho*w)' theta' [kg m^-2 s^-1 K]
                 }
-                break;
-            default:
-                ParallelFor(bxcc, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                  int indx   = n;
-                  int indx_v = indx + offset;
-                  mu_turb(i,j,k,indx)   = mu_turb(i,j,k,EddyDiff::Mom_h) * fac_ptr[indx-1];
-                  mu_turb(i,j,k,indx_v) = mu_turb(i,j,k,indx);
-                });
-                break;
-          }
-       }
+            }
+
+            // Horizontal and vertical diffusivities, repeated in the ghost cell below/above the box
+            for (int n = 0; n < offset; ++n) {
+                if ( (n == EddyDiff::KE_h  && !use_KE ) ||
+                     (n == EddyDiff::QKE_h && !use_QKE) ) { continue; }
+                Real val = mu * fac[n];
+                mu_turb(i,j,k,n) = val; mu_turb(i,j,k,n+offset) = val;
+                if (k == k_lo) { mu_turb(i,j,k-1,n) = val; mu_turb(i,j,k-1,n+offset) = val; }
+                if (k == k_hi) { mu_turb(i,j,k+1,n) = val; mu_turb(i,j,k+1,n+offset) = val; }
+            }
+        });
     }
 
     // Fill interior ghost cells and any ghost cells outside a periodic domain
     //***********************************************************************************
     eddyViscosity.FillBoundary(geom.periodicity());
-
-
-    // Extrapolate top & bottom
-    //***********************************************************************************
-#ifdef _OPENMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
-    for ( amrex::MFIter mfi(eddyViscosity,TileNoZ()); mfi.isValid(); ++mfi)
-    {
-        Box bxcc   = mfi.tilebox();
-        Box planez = bxcc; planez.setSmall(2, 1); planez.setBig(2, ngc);
-        int k_lo   = bxcc.smallEnd(2); int k_hi = bxcc.bigEnd(2);
-        planez.growLo(0,ngc); planez.growHi(0,ngc);
-        planez.growLo(1,ngc); planez.growHi(1,ngc);
-
-        const Array4<Real>& mu_turb = eddyViscosity.array(mfi);
-
-        // refactor the code to eliminate the need for ifdef's
-        for (auto n = 0; n < (EddyDiff::NumDiffs-1)/2; ++n) {
-            int offset = (EddyDiff::NumDiffs-1)/2;
-            switch (n)
-            {
-              case EddyDiff::QKE_h:
-                 // Extrap all components at top & bottom
-                 if(use_QKE) {
-                    ParallelFor(planez, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                    {
-                      int indx = n;
-                      int indx_v = indx + offset;
-                      mu_turb(i, j, k_lo-k, indx  ) = mu_turb(i, j, k_lo, indx  );
-                      mu_turb(i, j, k_hi+k, indx  ) = mu_turb(i, j, k_hi, indx  );
-                      mu_turb(i, j, k_lo-k, indx_v) = mu_turb(i, j, k_lo, indx_v);
-                      mu_turb(i, j, k_hi+k, indx_v) = mu_turb(i, j, k_hi, indx_v);
-                    });
-                 }
-                 break;
-              case EddyDiff::KE_h:
-                 if (use_KE) {
-                    ParallelFor(planez, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                    {
-                      int indx   = n;
-                      int indx_v = indx + offset;
-                      mu_turb(i, j, k_lo-k, indx  ) = mu_turb(i, j, k_lo, indx  );
-                      mu_turb(i, j, k_hi+k, indx  ) = mu_turb(i, j, k_hi, indx  );
-                      mu_turb(i, j, k_lo-k, indx_v) = mu_turb(i, j, k_lo, indx_v);
-                      mu_turb(i, j, k_hi+k, indx_v) = mu_turb(i, j, k_hi, indx_v);
-                    });
-                 }
-                 break;
-              default:
-                 ParallelFor(planez, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                 {
-                   int indx   = n ;
-                   int indx_v = indx + offset;
-                   mu_turb(i, j, k_lo-k, indx  ) = mu_turb(i, j, k_lo, indx  );
-                   mu_turb(i, j, k_hi+k, indx  ) = mu_turb(i, j, k_hi, indx  );
-                   mu_turb(i, j, k_lo-k, indx_v) = mu_turb(i, j, k_lo, indx_v);
-                   mu_turb(i, j, k_hi+k, indx_v) = mu_turb(i, j, k_hi, indx_v);
-                 });
-                 break;
-            }
-        }
-    }
 }
 
 /**
@@ -342,6 +221,7 @@ void ComputeTurbulentViscosityLES (const amrex::MultiFab& Tau11, const amrex::Mu
  *
  * @param[in]  xvel velocity in x-dir
  * @param[in]  yvel velocity in y-dir
+ * @param[in]  zvel velocity in z-dir
  * @param[in]  Tau11 11 strain
  * @param[in]  Tau22 22 strain
  * @param[in]  Tau33 33 strain
@@ -355,23 +235,32 @@ void ComputeTurbulentViscosityLES (const amrex::MultiFab& Tau11, const amrex::Mu
  * @param[in]  Hfx3 heat flux in z-dir
  * @param[in]  Diss dissipation of turbulent kinetic energy
  * @param[in]  geom problem geometry
+ * @param[in]  mapfac_m map factor at cell center
  * @param[in]  mapfac_u map factor at x-face
  * @param[in]  mapfac_v map factor at y-face
+ * @param[in]  z_phys_nd height coordinate at nodes (null without terrain)
  * @param[in]  turbChoice container with turbulence parameters
+ * @param[in]  const_grav gravitational acceleration
  * @param[in]  most pointer to Monin-Obukhov class if instantiated
+ * @param[in]  level AMR level
+ * @param[in]  bc_ptr_h container with boundary condition types (host)
+ * @param[in]  bc_ptr container with boundary condition types (device)
  * @param[in]  vert_only flag for vertical components of eddyViscosity
  */
-void ComputeTurbulentViscosity (const amrex::MultiFab& xvel , const amrex::MultiFab& yvel ,
-                                const amrex::MultiFab& Tau11, const amrex::MultiFab& Tau22, const amrex::MultiFab& Tau33,
-                                const amrex::MultiFab& Tau12, const amrex::MultiFab& Tau13, const amrex::MultiFab& Tau23,
+void ComputeTurbulentViscosity (const amrex::MultiFab& xvel , const amrex::MultiFab& yvel , const amrex::MultiFab& zvel ,
+                                const amrex::MultiFab* Tau11, const amrex::MultiFab* Tau22, const amrex::MultiFab* Tau33,
+                                const amrex::MultiFab* Tau12, const amrex::MultiFab* Tau13, const amrex::MultiFab* Tau23,
                                 const amrex::MultiFab& cons_in,
                                 amrex::MultiFab& eddyViscosity,
                                 amrex::MultiFab& Hfx1, amrex::MultiFab& Hfx2, amrex::MultiFab& Hfx3, amrex::MultiFab& Diss,
                                 const amrex::Geometry& geom,
+                                const amrex::MultiFab& mapfac_m,
                                 const amrex::MultiFab& mapfac_u, const amrex::MultiFab& mapfac_v,
                                 const std::unique_ptr<amrex::MultiFab>& z_phys_nd,
                                 const TurbChoice& turbChoice, const Real const_grav,
                                 std::unique_ptr<ABLMost>& most,
+                                const int& level,
+                                const amrex::BCRec* bc_ptr_h,
                                 const amrex::BCRec* bc_ptr,
                                 bool vert_only)
 {
@@ -398,17 +287,20 @@ void ComputeTurbulentViscosity (const amrex::MultiFab& xvel , const amrex::Multi
     }
 
     if (turbChoice.les_type != LESType::None) {
-        ComputeTurbulentViscosityLES(Tau11, Tau22, Tau33,
+        bool l_use_terrain = (z_phys_nd != nullptr);
+        ComputeTurbulentViscosityLES(xvel, yvel, zvel,
+                                     Tau11, Tau22, Tau33,
                                      Tau12, Tau13, Tau23,
                                      cons_in, eddyViscosity,
                                      Hfx1, Hfx2, Hfx3, Diss,
-                                     geom, mapfac_u, mapfac_v,
-                                     turbChoice, const_grav);
+                                     geom, mapfac_m, mapfac_u, mapfac_v,
+                                     turbChoice, const_grav,
+                                     l_use_terrain, bc_ptr_h);
     }
 
     if (turbChoice.pbl_type != PBLType::None) {
         // NOTE: state_new is passed in for Cons_old (due to ptr swap in advance)
         ComputeTurbulentViscosityPBL(xvel, yvel, cons_in, eddyViscosity,
-                                     geom, turbChoice, most, bc_ptr, vert_only, z_phys_nd);
+                                     geom, turbChoice, most, bc_ptr, vert_only, z_phys_nd, level);
     }
 }
@@ -0,0 +1,110 @@
+#include <AMReX.H>
+#include <Diffusion.H>
+#include <MatrixFreeStress.H>
+#include <IndexDefines.H>
+
+using namespace amrex;
+
+/**
+ * Function for computing the momentum RHS for diffusion operator without terrain,
+ * evaluating the strain, the stress and its divergence in a single pass.
+ *
+ * Unlike DiffusionSrcForMom_N, the stress tensor is not read from the Tau
+ * MultiFabs: every face evaluates the stresses on its bounding cells and edges
+ * from the velocities and the eddy viscosity (see MatrixFreeStress_N). This
+ * trades some recomputation for the memory traffic of storing and re-reading
+ * the tensor in every RK stage.
+ *
+ * @param[in]  bxx nodal x box for x-mom
+ * @param[in]  bxy nodal y box for y-mom
+ * @param[in]  bxz nodal z box for z-mom
+ * @param[out] rho_u_rhs RHS for x-mom
+ * @param[out] rho_v_rhs RHS for y-mom
+ * @param[out] rho_w_rhs RHS for z-mom
+ * @param[in]  u x-direction velocity
+ * @param[in]  v y-direction velocity
+ * @param[in]  w z-direction velocity
+ * @param[in]  cons conserved cell center quantities
+ * @param[in]  mu_turb turbulent viscosity (ignored if use_turb is false)
+ * @param[in]  diffChoice container with diffusion parameters
+ * @param[in]  dxInv inverse cell size array
+ * @param[in]  mf_m map factor at cell center
+ * @param[in]  mf_u map factor at x-face
+ * @param[in]  mf_v map factor at y-face
+ * @param[in]  use_turb flag for a variable (turbulent) viscosity
+ * @param[in]  implicit_vert leave the turbulent part of tau_13 and tau_23 on the
+ *             interior z-faces to ImplicitVertDiffusion
+ * @param[in]  domain box of the whole domain
+ * @param[in]  bc_ptr_h container with boundary condition types (host)
+ */
+void
+DiffusionSrcForMomMatrixFree_N (const Box& bxx, const Box& bxy , const Box& bxz,
+                                const Array4<Real>& rho_u_rhs  ,
+                                const Array4<Real>& rho_v_rhs  ,
+                                const Array4<Real>& rho_w_rhs  ,
+                                const Array4<const Real>& u    ,
+                                const Array4<const Real>& v    ,
+                                const Array4<const Real>& w    ,
+                                const Array4<const Real>& cons ,
+                                const Array4<const Real>& mu_turb,
+                                const DiffChoice& diffChoice,
+                                const GpuArray<Real, AMREX_SPACEDIM>& dxInv,
+                                const Array4<const Real>& mf_m,
+                                const Array4<const Real>& mf_u,
+                                const Array4<const Real>& mf_v,
+                                const bool& use_turb,
+                                const bool& implicit_vert,
+                                const Box& domain,
+                                const BCRec* bc_ptr_h)
+{
+    BL_PROFILE_VAR("DiffusionSrcForMomMatrixFree_N()",DiffusionSrcForMomMatrixFree_N);
+
+    auto dxinv = dxInv[0], dyinv = dxInv[1], dzinv = dxInv[2];
+
+    MatrixFreeStress_N st{u, v, w, mu_turb, mf_m, mf_u, mf_v, dxInv,
+                          2.0 * diffChoice.dynamicViscosity, use_turb};
+    st.set_bcs(bc_ptr_h, domain);
+    st.implicit_vert = implicit_vert;
+
+    // Only ConstantAlpha scales the stress divergence by the local density
+    bool l_const_alpha = (diffChoice.molec_diff_type == MolecDiffType::ConstantAlpha);
+    auto rho0_trans    = diffChoice.rho0_trans;
+
+    amrex::ParallelFor(bxx, bxy, bxz,
+    [=] AMREX_GPU_DEVICE (int i, int j, int k)
+    {
+        Real mf   = mf_m(i,j,0);
+
+        Real diffContrib  = ( (st.tau11(i  , j  , k  ) - st.tau11(i-1, j  ,k  )) * dxinv * mf   // Contribution to x-mom eqn from diffusive flux in x-dir
+                            + (st.tau12(i  , j+1, k  ) - st.tau12(i  , j  ,k  )) * dyinv * mf   // Contribution to x-mom eqn from diffusive flux in y-dir
+                            + (st.tau13(i  , j  , k+1) - st.tau13(i  , j  ,k  )) * dzinv );     // Contribution to x-mom eqn from diffusive flux in z-dir;
+        if (l_const_alpha) {
+            diffContrib  *= 0.5 * (cons(i,j,k,Rho_comp) + cons(i-1,j,k,Rho_comp))  / rho0_trans;
+        }
+        rho_u_rhs(i,j,k) -= diffContrib;
+    },
+    [=] AMREX_GPU_DEVICE (int i, int j, int k)
+    {
+        Real mf   = mf_m(i,j,0);
+
+        Real diffContrib  = ( (st.tau12(i+1, j  , k  ) - st.tau12(i  , j  , k  )) * dxinv * mf   // Contribution to y-mom eqn from diffusive flux in x-dir
+                            + (st.tau22(i  , j  , k  ) - st.tau22(i  , j-1, k  )) * dyinv * mf   // Contribution to y-mom eqn from diffusive flux in y-dir
+                            + (st.tau23(i  , j  , k+1) - st.tau23(i  , j  , k  )) * dzinv );     // Contribution to y-mom eqn from diffusive flux in z-dir;
+        if (l_const_alpha) {
+            diffContrib  *= 0.5 * (cons(i,j,k,Rho_comp) + cons(i,j-1,k,Rho_comp))  / rho0_trans;
+        }
+        rho_v_rhs(i,j,k) -= diffContrib;
+    },
+    [=] AMREX_GPU_DEVICE (int i, int j, int k)
+    {
+        Real mf   = mf_m(i,j,0);
+
+        Real diffContrib  = ( (st.tau13(i+1, j  , k  ) - st.tau13(i  , j  , k  )) * dxinv * mf   // Contribution to z-mom eqn from diffusive flux in x-dir
+                            + (st.tau23(i  , j+1, k  ) - st.tau23(i  , j  , k  )) * dyinv * mf   // Contribution to z-mom eqn from diffusive flux in y-dir
+                            + (st.tau33(i  , j  , k  ) - st.tau33(i  , j  , k-1)) * dzinv );     // Contribution to z-mom eqn from diffusive flux in z-dir;
+        if (l_const_alpha) {
+            diffContrib  *= 0.5 * (cons(i,j,k,Rho_comp) + cons(i,j,k-1,Rho_comp))  / rho0_trans;
+        }
+        rho_w_rhs(i,j,k) -= diffContrib;
+    });
+}
@@ -7,6 +7,13 @@ using namespace amrex;
 /**
  * Function for computing the scalar RHS for diffusion operator without terrain.
  *
+ * All the components are handled together: one pass computes the x-, y- and
+ * z-fluxes (the face density and the eddy diffusivity lookup are set up once
+ * per face), a second pass adds their divergence to the RHS together with the
+ * Deardorff TKE and MYNN QKE source terms. The TKE shear production evaluates
+ * the strain rate magnitude in that same pass (see MatrixFreeStress_N), so no
+ * strain field has to be kept between the RK stages.
+ *
  * @param[in]  bx cell center box to loop over
  * @param[in]  domain box of the whole domain
  * @param[in]  start_comp starting component index
@@ -20,7 +27,7 @@ using namespace amrex;
  * @param[in]  yflux flux in y-dir
  * @param[in]  zflux flux in z-dir
  * @param[in]  cellSizeInv inverse cell size array
- * @param[in]  SmnSmn_a strain rate magnitude
+ * @param[in]  ke_strain strain rates for the TKE shear production (unused without Deardorff)
  * @param[in]  mf_m map factor at cell center
  * @param[in]  mf_u map factor at x-face
  * @param[in]  mf_v map factor at y-face
@@ -45,7 +52,7 @@ DiffusionSrcForState_N (const amrex::Box& bx, const amrex::Box& domain,
                         const Array4<Real>& yflux,
                         const Array4<Real>& zflux,
                         const amrex::GpuArray<Real, AMREX_SPACEDIM>& cellSizeInv,
-                        const Array4<const Real>& SmnSmn_a,
+                        const MatrixFreeStress_N& ke_strain,
                         const Array4<const Real>& mf_m,
                         const Array4<const Real>& mf_u,
                         const Array4<const Real>& mf_v,
@@ -64,6 +71,7 @@ DiffusionSrcForState_N (const amrex::Box& bx, const amrex::Box& domain,
     const Real dy_inv = cellSizeInv[1];
     const Real dz_inv = cellSizeInv[2];
 
+    const auto& dom_lo = amrex::lbound(domain);
     const auto& dom_hi = amrex::ubound(domain);
 
     bool l_use_QKE       = turbChoice.use_QKE && turbChoice.advect_QKE;
@@ -74,7 +82,12 @@ DiffusionSrcForState_N (const amrex::Box& bx, const amrex::Box& domain,
     bool l_consA  = (diffChoice.molec_diff_type == MolecDiffType::ConstantAlpha);
     bool l_turb   = ( (turbChoice.les_type == LESType::Smagorinsky) ||
                       (turbChoice.les_type == LESType::Deardorff  ) ||
-                      (turbChoice.pbl_type == PBLType::MYNN25     ) );
+                      (turbChoice.pbl_type == PBLType::MYNN25     ) ||
+                      (turbChoice.pbl_type == PBLType::YSU        ) );
+
+    // The vertical eddy flux through interior faces is left to ImplicitVertDiffusion,
+    //    except for KE which it does not treat
+    bool l_vert_impl = (turbChoice.vert_implicit_fac > 0.0);
 
     const Box xbx = surroundingNodes(bx,0);
     const Box ybx = surroundingNodes(bx,1);
@@ -83,205 +96,60 @@ DiffusionSrcForState_N (const amrex::Box& bx, const amrex::Box& domain,
     const int end_comp   = start_comp + num_comp - 1;
     const int qty_offset = RhoTheta_comp;
 
-    // Theta, KE, QKE, Scalar
-    Vector<Real> alpha_eff(NVAR_max, 0.0);
-    if (l_consA) {
-        for (int i = 0; i < NVAR_max; ++i) {
-           switch (i) {
-               case PrimTheta_comp:
-                    alpha_eff[PrimTheta_comp] = diffChoice.alpha_T;
-                    break;
-               case PrimScalar_comp:
-                    alpha_eff[PrimScalar_comp] = diffChoice.alpha_C;
-                    break;
-               case PrimQ1_comp:
-                    alpha_eff[PrimQ1_comp] = diffChoice.alpha_C;
-                    break;
-               case PrimQ2_comp:
-                    alpha_eff[PrimQ2_comp] = diffChoice.alpha_C;
-                    break;
-               case PrimQ3_comp:
-                   alpha_eff[PrimQ3_comp] = diffChoice.alpha_C;
-                   break;
-               default:
-                    alpha_eff[i] = 0.0;
-                    break;
-          }
-       }
-    } else {
-        for (int i = 0; i < NVAR_max; ++i) {
-           switch (i) {
-               case PrimTheta_comp:
-                    alpha_eff[PrimTheta_comp] = diffChoice.rhoAlpha_T;
-                    break;
-               case PrimScalar_comp:
-                    alpha_eff[PrimScalar_comp] = diffChoice.rhoAlpha_C;
-                    break;
-               case PrimQ1_comp:
-                    alpha_eff[PrimQ1_comp] = diffChoice.rhoAlpha_C;
-                    break;
-               case PrimQ2_comp:
-                    alpha_eff[PrimQ2_comp] = diffChoice.rhoAlpha_C;
-                    break;
-               case PrimQ3_comp:
-                    alpha_eff[PrimQ3_comp] = diffChoice.rhoAlpha_C;
-                    break;
-               default:
-                    alpha_eff[i] = 0.0;
-                    break;
-          }
-       }
-    }
-    Vector<int> eddy_diff_idx{EddyDiff::Theta_h, EddyDiff::KE_h, EddyDiff::QKE_h, EddyDiff::Scalar_h, EddyDiff::Q1_h, EddyDiff::Q2_h, EddyDiff::Q3_h};
-    Vector<int> eddy_diff_idy{EddyDiff::Theta_h, EddyDiff::KE_h, EddyDiff::QKE_h, EddyDiff::Scalar_h, EddyDiff::Q1_h, EddyDiff::Q2_h, EddyDiff::Q3_h};
-    Vector<int> eddy_diff_idz{EddyDiff::Theta_v, EddyDiff::KE_v, EddyDiff::QKE_v, EddyDiff::Scalar_v, EddyDiff::Q1_v, EddyDiff::Q2_v, EddyDiff::Q3_h};
-
-    // Device vectors
-    Gpu::AsyncVector<Real> alpha_eff_d;
-    Gpu::AsyncVector<int>  eddy_diff_idx_d,eddy_diff_idy_d,eddy_diff_idz_d;
-    alpha_eff_d.resize(alpha_eff.size());
-    eddy_diff_idx_d.resize(eddy_diff_idx.size());
-    eddy_diff_idy_d.resize(eddy_diff_idy.size());
-    eddy_diff_idz_d.resize(eddy_diff_idz.size());
-
-    Gpu::copy(Gpu::hostToDevice, alpha_eff.begin()    , alpha_eff.end()    , alpha_eff_d.begin());
-    Gpu::copy(Gpu::hostToDevice, eddy_diff_idx.begin(), eddy_diff_idx.end(), eddy_diff_idx_d.begin());
-    Gpu::copy(Gpu::hostToDevice, eddy_diff_idy.begin(), eddy_diff_idy.end(), eddy_diff_idy_d.begin());
-    Gpu::copy(Gpu::hostToDevice, eddy_diff_idz.begin(), eddy_diff_idz.end(), eddy_diff_idz_d.begin());
-
-    // Capture pointers for device code
-    Real* d_alpha_eff     = alpha_eff_d.data();
-    int*  d_eddy_diff_idx = eddy_diff_idx_d.data();
-    int*  d_eddy_diff_idy = eddy_diff_idy_d.data();
-    int*  d_eddy_diff_idz = eddy_diff_idz_d.data();
-
-    // Compute fluxes at each face
-    if (l_consA && l_turb) {
-        amrex::ParallelFor(xbx, num_comp,[=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-        {
-            const int  qty_index = start_comp + n;
-            const int prim_index = qty_index - qty_offset;
-
-            Real rhoFace  = 0.5 * ( cell_data(i, j, k, Rho_comp) + cell_data(i-1, j, k, Rho_comp) );
-            Real rhoAlpha = rhoFace * d_alpha_eff[prim_index];
-            rhoAlpha += 0.5 * ( mu_turb(i  , j, k, d_eddy_diff_idx[prim_index])
-                              + mu_turb(i-1, j, k, d_eddy_diff_idx[prim_index]) );
-
-            xflux(i,j,k,qty_index) = rhoAlpha * (cell_prim(i, j, k, prim_index) - cell_prim(i-1, j, k, prim_index)) * dx_inv * mf_u(i,j,0);
-        });
-        amrex::ParallelFor(ybx, num_comp,[=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-        {
-            const int  qty_index = start_comp + n;
-            const int prim_index = qty_index - qty_offset;
-
-            Real rhoFace  = 0.5 * ( cell_data(i, j, k, Rho_comp) + cell_data(i, j-1, k, Rho_comp) );
-            Real rhoAlpha = rhoFace * d_alpha_eff[prim_index];
-            rhoAlpha += 0.5 * ( mu_turb(i, j  , k, d_eddy_diff_idy[prim_index])
-                              + mu_turb(i, j-1, k, d_eddy_diff_idy[prim_index]) );
-
-            yflux(i,j,k,qty_index) = rhoAlpha * (cell_prim(i, j, k, prim_index) - cell_prim(i, j-1, k, prim_index)) * dy_inv * mf_v(i,j,0);
-        });
-        amrex::ParallelFor(zbx, num_comp,[=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-        {
-            const int  qty_index = start_comp + n;
-            const int prim_index = qty_index - qty_offset;
+    // Theta, KE, QKE, Scalar, moisture
+    GpuArray<Real,NVAR_max> alpha_eff;
+    GpuArray<int ,NVAR_max> eddy_diff_idxy, eddy_diff_idz;
+    ScalarDiffusivityIndices(diffChoice, alpha_eff, eddy_diff_idxy, eddy_diff_idz);
 
-            Real rhoFace  = 0.5 * ( cell_data(i, j, k, Rho_comp) + cell_data(i, j, k-1, Rho_comp) );
-            Real rhoAlpha = rhoFace * d_alpha_eff[prim_index];
-            rhoAlpha += 0.5 * ( mu_turb(i, j, k  , d_eddy_diff_idz[prim_index])
-                              + mu_turb(i, j, k-1, d_eddy_diff_idz[prim_index]) );
-
-            bool ext_dir_on_zlo = ( (bc_ptr[BCVars::cons_bc+qty_index].lo(2) == ERFBCType::ext_dir) && k == 0);
-            bool ext_dir_on_zhi = ( (bc_ptr[BCVars::cons_bc+qty_index].lo(5) == ERFBCType::ext_dir) && k == dom_hi.z+1);
-            if (ext_dir_on_zlo) {
-                zflux(i,j,k,qty_index) = rhoAlpha * ( -(8./3.) * cell_prim(i, j, k-1, prim_index)
-                                                          + 3. * cell_prim(i, j, k  , prim_index)
-                                                     - (1./3.) * cell_prim(i, j, k+1, prim_index) ) * dz_inv;
-            } else if (ext_dir_on_zhi) {
-                zflux(i,j,k,qty_index) = rhoAlpha * (  (8./3.) * cell_prim(i, j, k-1, prim_index)
-                                                          - 3. * cell_prim(i, j, k  , prim_index)
-                                                     + (1./3.) * cell_prim(i, j, k+1, prim_index) ) * dz_inv;
-            } else {
-                zflux(i,j,k,qty_index) = rhoAlpha * (cell_prim(i, j, k, prim_index) - cell_prim(i, j, k-1, prim_index)) * dz_inv;
-            }
-        });
-    } else if (l_turb) {
-        amrex::ParallelFor(xbx, num_comp,[=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-        {
-            const int  qty_index = start_comp + n;
-            const int prim_index = qty_index - qty_offset;
-
-            Real Alpha = d_alpha_eff[prim_index];
-            Alpha += 0.5 * ( mu_turb(i  , j, k, d_eddy_diff_idx[prim_index])
-                           + mu_turb(i-1, j, k, d_eddy_diff_idx[prim_index]) );
-
-            xflux(i,j,k,qty_index) = Alpha * (cell_prim(i, j, k, prim_index) - cell_prim(i-1, j, k, prim_index)) * dx_inv * mf_u(i,j,0);
-        });
-        amrex::ParallelFor(ybx, num_comp,[=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-        {
-            const int  qty_index = start_comp + n;
-            const int prim_index = qty_index - qty_offset;
-
-            Real Alpha = d_alpha_eff[prim_index];
-            Alpha += 0.5 * ( mu_turb(i, j  , k, d_eddy_diff_idy[prim_index])
-                           + mu_turb(i, j-1, k, d_eddy_diff_idy[prim_index]) );
-
-            yflux(i,j,k,qty_index) = Alpha * (cell_prim(i, j, k, prim_index) - cell_prim(i, j-1, k, prim_index)) * dy_inv * mf_v(i,j,0);
-        });
-        amrex::ParallelFor(zbx, num_comp,[=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-        {
+    // Compute fluxes at each face: the face density is shared by all the components
+    amrex::ParallelFor(xbx, ybx, zbx,
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+    {
+        const Real rhoFace = (l_consA) ? 0.5 * ( cell_data(i, j, k, Rho_comp) + cell_data(i-1, j, k, Rho_comp) ) : 1.0;
+        for (int n = 0; n < num_comp; ++n) {
             const int  qty_index = start_comp + n;
             const int prim_index = qty_index - qty_offset;
 
-            Real Alpha = d_alpha_eff[prim_index];
-            Alpha += 0.5 * ( mu_turb(i, j, k  , d_eddy_diff_idz[prim_index])
-                           + mu_turb(i, j, k-1, d_eddy_diff_idz[prim_index]) );
-
-            bool ext_dir_on_zlo = ( (bc_ptr[BCVars::cons_bc+qty_index].lo(2) == ERFBCType::ext_dir) && k == 0);
-            bool ext_dir_on_zhi = ( (bc_ptr[BCVars::cons_bc+qty_index].lo(5) == ERFBCType::ext_dir) && k == dom_hi.z+1);
-            if (ext_dir_on_zlo) {
-                zflux(i,j,k,qty_index) = Alpha * ( -(8./3.) * cell_prim(i, j, k-1, prim_index)
-                                                       + 3. * cell_prim(i, j, k  , prim_index)
-                                                  - (1./3.) * cell_prim(i, j, k+1, prim_index) ) * dz_inv;
-            } else if (ext_dir_on_zhi) {
-                zflux(i,j,k,qty_index) = Alpha * (  (8./3.) * cell_prim(i, j, k-1, prim_index)
-                                                       - 3. * cell_prim(i, j, k  , prim_index)
-                                                  + (1./3.) * cell_prim(i, j, k+1, prim_index) ) * dz_inv;
-            } else {
-                zflux(i,j,k,qty_index) = Alpha * (cell_prim(i, j, k, prim_index) - cell_prim(i, j, k-1, prim_index)) * dz_inv;
+            Real rhoAlpha = rhoFace * alpha_eff[prim_index];
+            if (l_turb) {
+                rhoAlpha += 0.5 * ( mu_turb(i  , j, k, eddy_diff_idxy[prim_index])
+                                  + mu_turb(i-1, j, k, eddy_diff_idxy[prim_index]) );
             }
-        });
-    } else if(l_consA) {
-        amrex::ParallelFor(xbx, num_comp,[=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-        {
-            const int  qty_index = start_comp + n;
-            const int prim_index = qty_index - qty_offset;
-
-            Real rhoFace  = 0.5 * ( cell_data(i, j, k, Rho_comp) + cell_data(i-1, j, k, Rho_comp) );
-            Real rhoAlpha = rhoFace * d_alpha_eff[prim_index];
 
             xflux(i,j,k,qty_index) = rhoAlpha * (cell_prim(i, j, k, prim_index) - cell_prim(i-1, j, k, prim_index)) * dx_inv * mf_u(i,j,0);
-        });
-        amrex::ParallelFor(ybx, num_comp,[=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-        {
+        }
+    },
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+    {
+        const Real rhoFace = (l_consA) ? 0.5 * ( cell_data(i, j, k, Rho_comp) + cell_data(i, j-1, k, Rho_comp) ) : 1.0;
+        for (int n = 0; n < num_comp; ++n) {
             const int  qty_index = start_comp + n;
             const int prim_index = qty_index - qty_offset;
 
-            Real rhoFace  = 0.5 * ( cell_data(i, j, k, Rho_comp) + cell_data(i, j-1, k, Rho_comp) );
-            Real rhoAlpha = rhoFace * d_alpha_eff[prim_index];
+            Real rhoAlpha = rhoFace * alpha_eff[prim_index];
+            if (l_turb) {
+                rhoAlpha += 0.5 * ( mu_turb(i, j  , k, eddy_diff_idxy[prim_index])
+                                  + mu_turb(i, j-1, k, eddy_diff_idxy[prim_index]) );
+            }
 
             yflux(i,j,k,qty_index) = rhoAlpha * (cell_prim(i, j, k, prim_index) - cell_prim(i, j-1, k, prim_index)) * dy_inv * mf_v(i,j,0);
-        });
-        amrex::ParallelFor(zbx, num_comp,[=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-        {
+        }
+    },
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+    {
+        const Real rhoFace = (l_consA) ? 0.5 * ( cell_data(i, j, k, Rho_comp) + cell_data(i, j, k-1, Rho_comp) ) : 1.0;
+        for (int n = 0; n < num_comp; ++n) {
             const int  qty_index = start_comp + n;
             const int prim_index = qty_index - qty_offset;
 
-            Real rhoFace  = 0.5 * ( cell_data(i, j, k, Rho_comp) + cell_data(i, j, k-1, Rho_comp) );
-            Real rhoAlpha = rhoFace * d_alpha_eff[prim_index];
+            Real rhoAlpha = rhoFace * alpha_eff[prim_index];
+            if (l_turb && !(l_vert_impl && qty_index != RhoKE_comp && k > dom_lo.z && k <= dom_hi.z)) {
+                rhoAlpha += 0.5 * ( mu_turb(i, j, k  , eddy_diff_idz[prim_index])
+                                  + mu_turb(i, j, k-1, eddy_diff_idz[prim_index]) );
+            }
 
-            bool ext_dir_on_zlo = ( (bc_ptr[BCVars::cons_bc+qty_index].lo(2) == ERFBCType::ext_dir) && k == 0);
-            bool ext_dir_on_zhi = ( (bc_ptr[BCVars::cons_bc+qty_index].lo(5) == ERFBCType::ext_dir) && k == dom_hi.z+1);
+            bool ext_dir_on_zlo = ( (k == 0)          && (bc_ptr[BCVars::cons_bc+qty_index].lo(2) == ERFBCType::ext_dir) );
+            bool ext_dir_on_zhi = ( (k == dom_hi.z+1) && (bc_ptr[BCVars::cons_bc+qty_index].lo(5) == ERFBCType::ext_dir) );
             if (ext_dir_on_zlo) {
                 zflux(i,j,k,qty_index) = rhoAlpha * ( -(8./3.) * cell_prim(i, j, k-1, prim_index)
                                                           + 3. * cell_prim(i, j, k  , prim_index)
@@ -293,69 +161,55 @@ DiffusionSrcForState_N (const amrex::Box& bx, const amrex::Box& domain,
             } else {
                 zflux(i,j,k,qty_index) = rhoAlpha * (cell_prim(i, j, k, prim_index) - cell_prim(i, j, k-1, prim_index)) * dz_inv;
             }
-        });
-    } else {
-        amrex::ParallelFor(xbx, num_comp,[=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-        {
-            const int  qty_index = start_comp + n;
-            const int prim_index = qty_index - qty_offset;
-
-            Real Alpha = d_alpha_eff[prim_index];
-
-            xflux(i,j,k,qty_index) = Alpha * (cell_prim(i, j, k, prim_index) - cell_prim(i-1, j, k, prim_index)) * dx_inv * mf_u(i,j,0);
-        });
-        amrex::ParallelFor(ybx, num_comp,[=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-        {
-            const int  qty_index = start_comp + n;
-            const int prim_index = qty_index - qty_offset;
-
-            Real Alpha = d_alpha_eff[prim_index];
-
-            yflux(i,j,k,qty_index) = Alpha * (cell_prim(i, j, k, prim_index) - cell_prim(i, j-1, k, prim_index)) * dy_inv * mf_v(i,j,0);
-        });
-        amrex::ParallelFor(zbx, num_comp,[=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-        {
-            const int  qty_index = start_comp + n;
-            const int prim_index = qty_index - qty_offset;
-
-            Real Alpha = d_alpha_eff[prim_index];
-
-            bool ext_dir_on_zlo = ( (bc_ptr[BCVars::cons_bc+qty_index].lo(2) == ERFBCType::ext_dir) && k == 0);
-            bool ext_dir_on_zhi = ( (bc_ptr[BCVars::cons_bc+qty_index].lo(5) == ERFBCType::ext_dir) && k == dom_hi.z+1);
-            if (ext_dir_on_zlo) {
-                zflux(i,j,k,qty_index) = Alpha * ( -(8./3.) * cell_prim(i, j, k-1, prim_index)
-                                                       + 3. * cell_prim(i, j, k  , prim_index)
-                                                  - (1./3.) * cell_prim(i, j, k+1, prim_index) ) * dz_inv;
-            } else if (ext_dir_on_zhi) {
-                zflux(i,j,k,qty_index) = Alpha * (  (8./3.) * cell_prim(i, j, k-1, prim_index)
-                                                       - 3. * cell_prim(i, j, k  , prim_index)
-                                                  + (1./3.) * cell_prim(i, j, k+1, prim_index) ) * dz_inv;
-            } else {
-                zflux(i,j,k,qty_index) = Alpha * (cell_prim(i, j, k, prim_index) - cell_prim(i, j, k-1, prim_index)) * dz_inv;
-            }
-        });
+        }
+    });
+
+    // Source terms of the turbulence closures that are part of this update
+    bool l_KE_src  = (l_use_deardorff && start_comp <= RhoKE_comp  && end_comp >= RhoKE_comp );
+    bool l_QKE_src = (l_use_QKE       && start_comp <= RhoQKE_comp && end_comp >= RhoQKE_comp);
+
+    auto pbl_B1_l = turbChoice.pbl_B1;
+    bool c_ext_dir_on_zlo = false, c_ext_dir_on_zhi = false;
+    bool u_ext_dir_on_zlo = false, u_ext_dir_on_zhi = false;
+    bool v_ext_dir_on_zlo = false, v_ext_dir_on_zhi = false;
+    if (l_QKE_src) {
+        c_ext_dir_on_zlo = ( (bc_ptr[BCVars::cons_bc].lo(2) == ERFBCType::ext_dir) );
+        c_ext_dir_on_zhi = ( (bc_ptr[BCVars::cons_bc].lo(5) == ERFBCType::ext_dir) );
+        u_ext_dir_on_zlo = ( (bc_ptr[BCVars::xvel_bc].lo(2) == ERFBCType::ext_dir) );
+        u_ext_dir_on_zhi = ( (bc_ptr[BCVars::xvel_bc].lo(5) == ERFBCType::ext_dir) );
+        v_ext_dir_on_zlo = ( (bc_ptr[BCVars::yvel_bc].lo(2) == ERFBCType::ext_dir) );
+        v_ext_dir_on_zhi = ( (bc_ptr[BCVars::yvel_bc].lo(5) == ERFBCType::ext_dir) );
     }
 
-    // Use fluxes to compute RHS
-    for (int n(0); n < num_comp; ++n)
+    // Use fluxes to compute RHS, then add the TKE/QKE sources in the same pass
+    amrex::ParallelFor(bx,[=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
     {
-        int qty_index = start_comp + n;
-        amrex::ParallelFor(bx,[=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-        {
+        for (int n = 0; n < num_comp; ++n) {
+            const int qty_index = start_comp + n;
 
             cell_rhs(i,j,k,qty_index) += (xflux(i+1,j  ,k  ,qty_index) - xflux(i, j, k, qty_index)) * dx_inv * mf_m(i,j,0)  // Diffusive flux in x-dir
                                         +(yflux(i  ,j+1,k  ,qty_index) - yflux(i, j, k, qty_index)) * dy_inv * mf_m(i,j,0)  // Diffusive flux in y-dir
                                         +(zflux(i  ,j  ,k+1,qty_index) - zflux(i, j, k, qty_index)) * dz_inv;               // Diffusive flux in z-dir
 
-            if (qty_index==RhoTheta_comp) hfx_z(i,j,k) = -0.5 * ( zflux(i, j, k, qty_index) + zflux(i, j, k+1, qty_index) );
-        });
-    }
+            if (qty_index==RhoTheta_comp) {
+                hfx_z(i,j,k) = -0.5 * ( zflux(i, j, k, qty_index) + zflux(i, j, k+1, qty_index) );
+                // The buoyancy production needs the full heat flux: add back the eddy part
+                //    on the interior faces that is left to ImplicitVertDiffusion
+                if (l_vert_impl && l_turb) {
+                    const int prim_th = RhoTheta_comp - qty_offset;
+                    const int idz_th  = eddy_diff_idz[prim_th];
+                    auto eddy_flux = [=] (int kk) -> Real {
+                        if (kk <= dom_lo.z || kk > dom_hi.z) return 0.0;
+                        return 0.5 * ( mu_turb(i, j, kk, idz_th) + mu_turb(i, j, kk-1, idz_th) )
+                                   * (cell_prim(i, j, kk, prim_th) - cell_prim(i, j, kk-1, prim_th)) * dz_inv;
+                    };
+                    hfx_z(i,j,k) -= 0.5 * ( eddy_flux(k) + eddy_flux(k+1) );
+                }
+            }
+        }
 
-    // Using Deardorff
-    if (l_use_deardorff && start_comp <= RhoKE_comp && end_comp >=RhoKE_comp) {
-        int qty_index = RhoKE_comp;
-        amrex::ParallelFor(bx,[=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-        {
+        // Using Deardorff
+        if (l_KE_src) {
             // Add Buoyancy Source
             // where the SGS buoyancy flux tau_{theta,i} = -KH * dtheta/dx_i,
             // such that for dtheta/dz < 0, there is a positive (upward) heat
@@ -367,38 +221,26 @@ DiffusionSrcForState_N (const amrex::Box& bx, const amrex::Box& domain,
             // **should** be a function of the water vapor and total water
             // mixing ratios, depending on whether conditions are saturated or
             // not (see the WRF model description, Skamarock et al 2019).
-            cell_rhs(i,j,k,qty_index) += l_abs_g * l_inv_theta0 * hfx_z(i,j,k);
+            cell_rhs(i,j,k,RhoKE_comp) += l_abs_g * l_inv_theta0 * hfx_z(i,j,k);
 
             // TKE shear production
             //   P = -tau_ij * S_ij = 2 * mu_turb * S_ij * S_ij
             // Note: This assumes that the horizontal and vertical diffusivities
             // of momentum are equal
-            cell_rhs(i,j,k,qty_index) += 2.0*mu_turb(i,j,k,EddyDiff::Mom_v) * SmnSmn_a(i,j,k);
+            cell_rhs(i,j,k,RhoKE_comp) += 2.0*mu_turb(i,j,k,EddyDiff::Mom_v) * ke_strain.SmnSmn(i,j,k);
 
             // TKE dissipation
-            cell_rhs(i,j,k,qty_index) -= diss(i,j,k);
-        });
-    }
-
-    // Using Deardorff
-    if (l_use_QKE && start_comp <= RhoQKE_comp && end_comp >=RhoQKE_comp) {
-        int qty_index = RhoQKE_comp;
-        auto pbl_B1_l = turbChoice.pbl_B1;
-        bool c_ext_dir_on_zlo = ( (bc_ptr[BCVars::cons_bc].lo(2) == ERFBCType::ext_dir) );
-        bool c_ext_dir_on_zhi = ( (bc_ptr[BCVars::cons_bc].lo(5) == ERFBCType::ext_dir) );
-        bool u_ext_dir_on_zlo = ( (bc_ptr[BCVars::xvel_bc].lo(2) == ERFBCType::ext_dir) );
-        bool u_ext_dir_on_zhi = ( (bc_ptr[BCVars::xvel_bc].lo(5) == ERFBCType::ext_dir) );
-        bool v_ext_dir_on_zlo = ( (bc_ptr[BCVars::yvel_bc].lo(2) == ERFBCType::ext_dir) );
-        bool v_ext_dir_on_zhi = ( (bc_ptr[BCVars::yvel_bc].lo(5) == ERFBCType::ext_dir) );
-        amrex::ParallelFor(bx,[=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-        {
-            cell_rhs(i, j, k, qty_index) += ComputeQKESourceTerms(i,j,k,u,v,cell_data,cell_prim,
-                                                                  mu_turb,cellSizeInv,domain,
-                                                                  pbl_B1_l,tm_arr(i,j,0),
-                                                                  c_ext_dir_on_zlo, c_ext_dir_on_zhi,
-                                                                  u_ext_dir_on_zlo, u_ext_dir_on_zhi,
-                                                                  v_ext_dir_on_zlo, v_ext_dir_on_zhi);
-        });
-    }
-
+            cell_rhs(i,j,k,RhoKE_comp) -= diss(i,j,k);
+        }
+
+        // Using MYNN2.5
+        if (l_QKE_src) {
+            cell_rhs(i, j, k, RhoQKE_comp) += ComputeQKESourceTerms(i,j,k,u,v,cell_data,cell_prim,
+                                                                    mu_turb,cellSizeInv,domain,
+                                                                    pbl_B1_l,tm_arr(i,j,0),
+                                                                    c_ext_dir_on_zlo, c_ext_dir_on_zhi,
+                                                                    u_ext_dir_on_zlo, u_ext_dir_on_zhi,
+                                                                    v_ext_dir_on_zlo, v_ext_dir_on_zhi);
+        }
+    });
 }
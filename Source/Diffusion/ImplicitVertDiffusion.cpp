@@ -0,0 +1,240 @@
+#include <Diffusion.H>
+#include <TerrainMetrics.H>
+#include <TileNoZ.H>
+
+using namespace amrex;
+
+namespace {
+
+// Components of the column scratch
+enum ImplScr { lo_coef = 0, hi_coef, cp, dp, NumScr };
+
+/**
+ * Theta-weighted solve of the vertical diffusion equation in one column
+ *
+ *   phi^{n+1}_k - phi*_k = a_k [ theta (phi^{n+1}_{k-1} - phi^{n+1}_k) + (1-theta) (phi*_{k-1} - phi*_k) ]
+ *                        + c_k [ theta (phi^{n+1}_{k+1} - phi^{n+1}_k) + (1-theta) (phi*_{k+1} - phi*_k) ]
+ *
+ * with the Thomas algorithm. The couplings a_k (face below) and c_k (face above) must
+ * already be stored in the scratch; they vanish on the bottom and top faces.
+ *
+ * @param[in]  i,j      column indices
+ * @param[in]  klo,khi  first and last cell of the column
+ * @param[in]  theta    weight of the new time level
+ * @param[in]  scr      column scratch (ImplScr components)
+ * @param[in]  phi      functor returning the current value at level k
+ * @param[in]  store    functor storing the new value at level k
+ */
+template <typename Phi, typename Store>
+AMREX_GPU_DEVICE AMREX_FORCE_INLINE
+void
+ThetaSolveColumn (int i, int j, int klo, int khi, Real theta,
+                  const Array4<Real>& scr, Phi const& phi, Store const& store) noexcept
+{
+    // Forward elimination
+    for (int k = klo; k <= khi; ++k) {
+        Real a = scr(i,j,k,ImplScr::lo_coef);
+        Real c = scr(i,j,k,ImplScr::hi_coef);
+
+        Real phi_k = phi(k);
+        Real rhs   = phi_k;
+        if (k > klo) rhs += (1.0-theta) * a * (phi(k-1) - phi_k);
+        if (k < khi) rhs += (1.0-theta) * c * (phi(k+1) - phi_k);
+
+        Real lower = -theta * a;
+        Real diag  = 1.0 + theta * (a + c);
+        Real upper = -theta * c;
+        if (k > klo) {
+            Real denom = diag - lower * scr(i,j,k-1,ImplScr::cp);
+            scr(i,j,k,ImplScr::cp) = upper / denom;
+            scr(i,j,k,ImplScr::dp) = (rhs - lower * scr(i,j,k-1,ImplScr::dp)) / denom;
+        } else {
+            scr(i,j,k,ImplScr::cp) = upper / diag;
+            scr(i,j,k,ImplScr::dp) = rhs / diag;
+        }
+    }
+
+    // Back substitution
+    Real phi_new = scr(i,j,khi,ImplScr::dp);
+    store(khi, phi_new);
+    for (int k = khi-1; k >= klo; --k) {
+        phi_new = scr(i,j,k,ImplScr::dp) - scr(i,j,k,ImplScr::cp) * phi_new;
+        store(k, phi_new);
+    }
+}
+
+} // namespace
+
+/**
+ * Function for the implicit vertical eddy diffusion of the scalars and the
+ * horizontal momenta, applied once per time step after the explicit advance.
+ *
+ * The explicit diffusion operators skip the turbulent vertical flux through the
+ * interior z-faces when erf.vert_implicit_fac > 0; this routine adds it back with
+ * the new time level weighted by vert_implicit_fac (0.5 = Crank-Nicolson,
+ * 1 = backward Euler). Every column is solved by a single thread with the Thomas
+ * algorithm, with the density held fixed. The bottom and top faces, and hence the
+ * surface fluxes imposed by MOST through the ghost cells, stay explicit.
+ *
+ * The eddy diffusivities and the metric terms are those of the explicit
+ * operators: the mean of the cell values on the face for the scalars and the
+ * four-point edge average of Mom_v for the momenta.
+ *
+ * @param[in]    dt time step
+ * @param[in]    geom geometry of this level
+ * @param[inout] cons conserved cell center quantities (ghost cells filled)
+ * @param[inout] xmom x-momentum
+ * @param[inout] ymom y-momentum
+ * @param[in]    eddyDiffs turbulent diffusivities (ghost cells filled)
+ * @param[in]    z_phys_nd height at nodes (nullptr without terrain)
+ * @param[in]    detJ Jacobian at cell centers (nullptr without terrain)
+ * @param[in]    diffChoice container with diffusion parameters
+ * @param[in]    turbChoice container with turbulence parameters
+ */
+void
+ImplicitVertDiffusion (const Real dt,
+                       const Geometry& geom,
+                       MultiFab& cons,
+                       MultiFab& xmom,
+                       MultiFab& ymom,
+                       const MultiFab& eddyDiffs,
+                       const MultiFab* z_phys_nd,
+                       const MultiFab* detJ,
+                       const DiffChoice& diffChoice,
+                       const TurbChoice& turbChoice)
+{
+    BL_PROFILE_VAR("ImplicitVertDiffusion()",ImplicitVertDiffusion);
+
+    const Real theta = turbChoice.vert_implicit_fac;
+    const bool l_use_terrain = (z_phys_nd != nullptr);
+
+    const auto dxInv = geom.InvCellSizeArray();
+    const Real dz_inv_sq = dxInv[2] * dxInv[2];
+
+    // Scalars treated implicitly: KE is left to the LES closure
+    GpuArray<Real,NVAR_max> alpha_eff;
+    GpuArray<int ,NVAR_max> eddy_diff_idxy, eddy_diff_idz;
+    ScalarDiffusivityIndices(diffChoice, alpha_eff, eddy_diff_idxy, eddy_diff_idz);
+
+    GpuArray<int,NVAR_max> comps{};
+    int num_comp = 0;
+    comps[num_comp++] = RhoTheta_comp;
+    if (turbChoice.use_QKE && turbChoice.advect_QKE) comps[num_comp++] = RhoQKE_comp;
+    for (int n = RhoScalar_comp; n < cons.nComp(); ++n) comps[num_comp++] = n;
+
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(cons, TileNoZ()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx  = mfi.tilebox();
+        const Box& tbx = mfi.nodaltilebox(0);
+        const Box& tby = mfi.nodaltilebox(1);
+
+        // Every tile spans the domain in z (checked in update_diffusive_arrays),
+        //    so klo and khi are the bottom and top cells of the domain
+        const int klo  = bx.smallEnd(2);
+        const int khi  = bx.bigEnd(2);
+        AMREX_ASSERT(klo == geom.Domain().smallEnd(2) && khi == geom.Domain().bigEnd(2));
+
+        const Array4<Real>& cell_data = cons.array(mfi);
+        const Array4<Real>& rho_u     = xmom.array(mfi);
+        const Array4<Real>& rho_v     = ymom.array(mfi);
+        const Array4<const Real>& mu_turb = eddyDiffs.const_array(mfi);
+
+        const Array4<const Real>& z_nd   = l_use_terrain ? z_phys_nd->const_array(mfi) : Array4<const Real>{};
+        const Array4<const Real>& detJ_a = l_use_terrain ?      detJ->const_array(mfi) : Array4<const Real>{};
+
+        // Column scratch from the asynchronous arena: no host allocation or
+        //    synchronization per tile
+        FArrayBox scr_c(bx , ImplScr::NumScr, The_Async_Arena());
+        FArrayBox scr_u(tbx, ImplScr::NumScr, The_Async_Arena());
+        FArrayBox scr_v(tby, ImplScr::NumScr, The_Async_Arena());
+        const Array4<Real>& sc = scr_c.array();
+        const Array4<Real>& su = scr_u.array();
+        const Array4<Real>& sv = scr_v.array();
+
+        Box bx2d(bx);   bx2d.setRange(2,0);
+        Box tbx2d(tbx); tbx2d.setRange(2,0);
+        Box tby2d(tby); tby2d.setRange(2,0);
+
+        ParallelFor(bx2d, tbx2d, tby2d,
+        [=] AMREX_GPU_DEVICE (int i, int j, int) noexcept
+        {
+            for (int m = 0; m < num_comp; ++m) {
+                const int n    = comps[m];
+                const int qty  = eddy_diff_idz[n-1];
+
+                for (int k = klo; k <= khi; ++k) {
+                    Real hz_lo = 1.0, hz_hi = 1.0, J = 1.0;
+                    if (l_use_terrain) {
+                        hz_lo = Compute_h_zeta_AtKface(i,j,k  ,dxInv,z_nd);
+                        hz_hi = Compute_h_zeta_AtKface(i,j,k+1,dxInv,z_nd);
+                        J     = detJ_a(i,j,k);
+                    }
+                    Real fac = dt * dz_inv_sq / (cell_data(i,j,k,Rho_comp) * J);
+                    sc(i,j,k,ImplScr::lo_coef) = (k > klo) ?
+                        fac * 0.5 * (mu_turb(i,j,k,qty) + mu_turb(i,j,k-1,qty)) / hz_lo : 0.0;
+                    sc(i,j,k,ImplScr::hi_coef) = (k < khi) ?
+                        fac * 0.5 * (mu_turb(i,j,k+1,qty) + mu_turb(i,j,k,qty)) / hz_hi : 0.0;
+                }
+
+                ThetaSolveColumn(i, j, klo, khi, theta, sc,
+                    [=] (int k) { return cell_data(i,j,k,n) / cell_data(i,j,k,Rho_comp); },
+                    [=] (int k, Real phi) { cell_data(i,j,k,n) = cell_data(i,j,k,Rho_comp) * phi; });
+            }
+        },
+        [=] AMREX_GPU_DEVICE (int i, int j, int) noexcept
+        {
+            auto rho_face = [=] (int k) {
+                return 0.5 * (cell_data(i-1,j,k,Rho_comp) + cell_data(i,j,k,Rho_comp));
+            };
+            auto mu_edge = [=] (int k) {
+                return 0.25 * ( mu_turb(i-1, j, k  , EddyDiff::Mom_v) + mu_turb(i, j, k  , EddyDiff::Mom_v)
+                              + mu_turb(i-1, j, k-1, EddyDiff::Mom_v) + mu_turb(i, j, k-1, EddyDiff::Mom_v) );
+            };
+
+            for (int k = klo; k <= khi; ++k) {
+                Real hz_lo = 1.0, hz_hi = 1.0, J = 1.0;
+                if (l_use_terrain) {
+                    hz_lo = Compute_h_zeta_AtEdgeCenterJ(i,j,k  ,dxInv,z_nd);
+                    hz_hi = Compute_h_zeta_AtEdgeCenterJ(i,j,k+1,dxInv,z_nd);
+                    J     = 0.5 * (detJ_a(i,j,k) + detJ_a(i-1,j,k));
+                }
+                Real fac = dt * dz_inv_sq / (rho_face(k) * J);
+                su(i,j,k,ImplScr::lo_coef) = (k > klo) ? fac * mu_edge(k  ) / hz_lo : 0.0;
+                su(i,j,k,ImplScr::hi_coef) = (k < khi) ? fac * mu_edge(k+1) / hz_hi : 0.0;
+            }
+
+            ThetaSolveColumn(i, j, klo, khi, theta, su,
+                [=] (int k) { return rho_u(i,j,k) / rho_face(k); },
+                [=] (int k, Real vel) { rho_u(i,j,k) = rho_face(k) * vel; });
+        },
+        [=] AMREX_GPU_DEVICE (int i, int j, int) noexcept
+        {
+            auto rho_face = [=] (int k) {
+                return 0.5 * (cell_data(i,j-1,k,Rho_comp) + cell_data(i,j,k,Rho_comp));
+            };
+            auto mu_edge = [=] (int k) {
+                return 0.25 * ( mu_turb(i, j-1, k  , EddyDiff::Mom_v) + mu_turb(i, j, k  , EddyDiff::Mom_v)
+                              + mu_turb(i, j-1, k-1, EddyDiff::Mom_v) + mu_turb(i, j, k-1, EddyDiff::Mom_v) );
+            };
+
+            for (int k = klo; k <= khi; ++k) {
+                Real hz_lo = 1.0, hz_hi = 1.0, J = 1.0;
+                if (l_use_terrain) {
+                    hz_lo = Compute_h_zeta_AtEdgeCenterI(i,j,k  ,dxInv,z_nd);
+                    hz_hi = Compute_h_zeta_AtEdgeCenterI(i,j,k+1,dxInv,z_nd);
+                    J     = 0.5 * (detJ_a(i,j,k) + detJ_a(i,j-1,k));
+                }
+                Real fac = dt * dz_inv_sq / (rho_face(k) * J);
+                sv(i,j,k,ImplScr::lo_coef) = (k > klo) ? fac * mu_edge(k  ) / hz_lo : 0.0;
+                sv(i,j,k,ImplScr::hi_coef) = (k < khi) ? fac * mu_edge(k+1) / hz_hi : 0.0;
+            }
+
+            ThetaSolveColumn(i, j, klo, khi, theta, sv,
+                [=] (int k) { return rho_v(i,j,k) / rho_face(k); },
+                [=] (int k, Real vel) { rho_v(i,j,k) = rho_face(k) * vel; });
+        });
+    }
+}
@@ -3,18 +3,104 @@
 using namespace amrex;
 
 /**
- * Function to compute 6th order numerical diffusion RHS.
+ * Limited 5th order derivative between data points i-1 and i, i.e. the face
+ * flux of the 6th order numerical diffusion. The flux is zeroed if it has the
+ * same sign as the local gradient (it would otherwise be anti-diffusive).
+ */
+AMREX_GPU_DEVICE
+AMREX_FORCE_INLINE
+Real
+NumDiffFlux (const Real dm3, const Real dm2, const Real dm1,
+             const Real d0 , const Real dp1, const Real dp2) noexcept
+{
+    Real flux = 10. * (d0  - dm1)
+               - 5. * (dp1 - dm2)
+                    + (dp2 - dm3);
+    if ( (flux * (d0 - dm1)) > 0.) flux = 0.;
+    return flux;
+}
+
+/**
+ * Function to compute 6th order numerical diffusion RHS for cell centered data.
+ *
+ * The x- and y-fluxes of all the components are computed once per face and
+ * stored in temporaries over the tile; the RHS is then incremented with their
+ * divergence in a second pass.
+ *
+ * @param[in]  bx box to loop over
+ * @param[in]  comps component indices to diffuse
+ * @param[in]  num_comp number of entries of comps
+ * @param[in]  dt time step
+ * @param[in]  num_diff_coeff
+ * @param[in]  data variables used to compute RHS
+ * @param[out] rhs store the right hand side
+ * @param[in]  mf_x map factor at x-face
+ * @param[in]  mf_y map factor at y-face
+ */
+void
+NumericalDiffusion (const Box& bx,
+                    const GpuArray<int,NVAR_max>& comps,
+                    const int  num_comp,
+                    const Real dt,
+                    const Real num_diff_coeff,
+                    const Array4<const Real>& data,
+                    const Array4<      Real>& rhs,
+                    const Array4<const Real>& mf_x,
+                    const Array4<const Real>& mf_y)
+{
+    BL_PROFILE_VAR("NumericalDiffusion()",NumericalDiffusion);
+
+    if (num_comp == 0) return;
+
+    // Face fluxes
+    Box xbx(bx); xbx.growHi(0,1);
+    Box ybx(bx); ybx.growHi(1,1);
+    FArrayBox xflux(xbx,num_comp);
+    FArrayBox yflux(ybx,num_comp);
+    Elixir xflux_eli = xflux.elixir();
+    Elixir yflux_eli = yflux.elixir();
+    const Array4<Real>& fx = xflux.array();
+    const Array4<Real>& fy = yflux.array();
+
+    amrex::ParallelFor(xbx, num_comp, ybx, num_comp,
+    [=] AMREX_GPU_DEVICE (int i, int j, int k, int m) noexcept
+    {
+        int n = comps[m];
+        fx(i,j,k,m) = NumDiffFlux(data(i-3,j,k,n), data(i-2,j,k,n), data(i-1,j,k,n),
+                                  data(i  ,j,k,n), data(i+1,j,k,n), data(i+2,j,k,n));
+    },
+    [=] AMREX_GPU_DEVICE (int i, int j, int k, int m) noexcept
+    {
+        int n = comps[m];
+        fy(i,j,k,m) = NumDiffFlux(data(i,j-3,k,n), data(i,j-2,k,n), data(i,j-1,k,n),
+                                  data(i,j  ,k,n), data(i,j+1,k,n), data(i,j+2,k,n));
+    });
+
+    // Capture diffusion coeff
+    Real coeff6 = num_diff_coeff / (2.0 * dt);
+
+    // Augment RHS with the flux divergence
+    amrex::ParallelFor(bx, num_comp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int m) noexcept
+    {
+        int n = comps[m];
+        rhs(i,j,k,n) += coeff6 * ( (fx(i+1,j,k,m) - fx(i,j,k,m)) * mf_x(i,j,0)
+                                 + (fy(i,j+1,k,m) - fy(i,j,k,m)) * mf_y(i,j,0) );
+    });
+}
+
+/**
+ * Function to compute 6th order numerical diffusion RHS for the contiguous
+ * components [start_comp, start_comp+num_comp) of cell centered data.
  *
  * @param[in]  bx box to loop over
  * @param[in]  start_comp staring component index
  * @param[in]  num_comp number of total components
+ * @param[in]  dt time step
  * @param[in]  num_diff_coeff
  * @param[in]  data variables used to compute RHS
- * @param[out] rhs stor the right hand side
+ * @param[out] rhs store the right hand side
  * @param[in]  mf_x map factor at x-face
  * @param[in]  mf_y map factor at y-face
- * @param[in]  avg_mf_x_y flag to average map factor x in y-dir
- * @param[in]  avg_mf_y_x flag to average map factor y in x-dir
  */
 void
 NumericalDiffusion (const Box& bx,
@@ -25,58 +111,120 @@ NumericalDiffusion (const Box& bx,
                     const Array4<const Real>& data,
                     const Array4<      Real>& rhs,
                     const Array4<const Real>& mf_x,
-                    const Array4<const Real>& mf_y,
-                    const bool avg_mf_x_y,
-                    const bool avg_mf_y_x)
+                    const Array4<const Real>& mf_y)
 {
-    BL_PROFILE_VAR("NumericalDiffusion()",NumericalDiffusion);
+    AMREX_ALWAYS_ASSERT(num_comp <= NVAR_max);
+    GpuArray<int,NVAR_max> comps{};
+    for (int m = 0; m < num_comp; ++m) comps[m] = start_comp + m;
+    NumericalDiffusion(bx, comps, num_comp, dt, num_diff_coeff, data, rhs, mf_x, mf_y);
+}
+
+/**
+ * Function to compute 6th order numerical diffusion RHS for the momenta.
+ *
+ * The three momentum components are handled together: one pass computes
+ * the x-fluxes, one the y-fluxes and one the flux divergence. The map
+ * factors are averaged to the faces of the staggered momenta on the fly.
+ *
+ * @param[in]  tbx box for x-momentum
+ * @param[in]  tby box for y-momentum
+ * @param[in]  tbz box for z-momentum
+ * @param[in]  dt time step
+ * @param[in]  num_diff_coeff
+ * @param[in]  rho_u x-momentum
+ * @param[in]  rho_v y-momentum
+ * @param[in]  rho_w z-momentum
+ * @param[out] rho_u_rhs RHS for x-momentum
+ * @param[out] rho_v_rhs RHS for y-momentum
+ * @param[out] rho_w_rhs RHS for z-momentum
+ * @param[in]  mf_m map factor at cell center
+ * @param[in]  mf_u map factor at x-face
+ * @param[in]  mf_v map factor at y-face
+ */
+void
+NumericalDiffusionMom (const Box& tbx, const Box& tby, const Box& tbz,
+                       const Real dt,
+                       const Real num_diff_coeff,
+                       const Array4<const Real>& rho_u,
+                       const Array4<const Real>& rho_v,
+                       const Array4<const Real>& rho_w,
+                       const Array4<      Real>& rho_u_rhs,
+                       const Array4<      Real>& rho_v_rhs,
+                       const Array4<      Real>& rho_w_rhs,
+                       const Array4<const Real>& mf_m,
+                       const Array4<const Real>& mf_u,
+                       const Array4<const Real>& mf_v)
+{
+    BL_PROFILE_VAR("NumericalDiffusionMom()",NumericalDiffusionMom);
 
-    // Average map factors to correct locations
-    Box planebx(bx); planebx.setSmall(2,0); planebx.setBig(2,0);
-    FArrayBox mf_x_bar; mf_x_bar.resize(planebx,1);
-    FArrayBox mf_y_bar; mf_y_bar.resize(planebx,1);
-    Elixir mfx_eli = mf_x_bar.elixir();
-    Elixir mfy_eli = mf_y_bar.elixir();
-    const Array4<Real>& mfx_arr  = mf_x_bar.array();
-    const Array4<Real>& mfy_arr  = mf_y_bar.array();
-    amrex::ParallelFor(planebx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+    // Face fluxes
+    Box xbx_u(tbx); xbx_u.growHi(0,1);
+    Box xbx_v(tby); xbx_v.growHi(0,1);
+    Box xbx_w(tbz); xbx_w.growHi(0,1);
+    Box ybx_u(tbx); ybx_u.growHi(1,1);
+    Box ybx_v(tby); ybx_v.growHi(1,1);
+    Box ybx_w(tbz); ybx_w.growHi(1,1);
+    FArrayBox xflux_u(xbx_u,1), xflux_v(xbx_v,1), xflux_w(xbx_w,1);
+    FArrayBox yflux_u(ybx_u,1), yflux_v(ybx_v,1), yflux_w(ybx_w,1);
+    Elixir xflux_u_eli = xflux_u.elixir(); Elixir xflux_v_eli = xflux_v.elixir(); Elixir xflux_w_eli = xflux_w.elixir();
+    Elixir yflux_u_eli = yflux_u.elixir(); Elixir yflux_v_eli = yflux_v.elixir(); Elixir yflux_w_eli = yflux_w.elixir();
+    const Array4<Real>& fxu = xflux_u.array(); const Array4<Real>& fxv = xflux_v.array(); const Array4<Real>& fxw = xflux_w.array();
+    const Array4<Real>& fyu = yflux_u.array(); const Array4<Real>& fyv = yflux_v.array(); const Array4<Real>& fyw = yflux_w.array();
+
+    amrex::ParallelFor(xbx_u, xbx_v, xbx_w,
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+    {
+        fxu(i,j,k) = NumDiffFlux(rho_u(i-3,j,k), rho_u(i-2,j,k), rho_u(i-1,j,k),
+                                 rho_u(i  ,j,k), rho_u(i+1,j,k), rho_u(i+2,j,k));
+    },
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
     {
-        if (avg_mf_x_y) {
-            mfx_arr(i,j,k) = 0.5 * ( mf_x(i,j-1,k) + mf_x(i,j,k) );
-        } else {
-            mfx_arr(i,j,k) = mf_x(i,j,k);
-        }
-        if (avg_mf_y_x) {
-            mfy_arr(i,j,k) = 0.5 * ( mf_y(i-1,j,k) + mf_y(i,j,k) );
-        } else {
-            mfy_arr(i,j,k) = mf_y(i,j,k);
-        }
+        fxv(i,j,k) = NumDiffFlux(rho_v(i-3,j,k), rho_v(i-2,j,k), rho_v(i-1,j,k),
+                                 rho_v(i  ,j,k), rho_v(i+1,j,k), rho_v(i+2,j,k));
+    },
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+    {
+        fxw(i,j,k) = NumDiffFlux(rho_w(i-3,j,k), rho_w(i-2,j,k), rho_w(i-1,j,k),
+                                 rho_w(i  ,j,k), rho_w(i+1,j,k), rho_w(i+2,j,k));
+    });
+
+    amrex::ParallelFor(ybx_u, ybx_v, ybx_w,
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+    {
+        fyu(i,j,k) = NumDiffFlux(rho_u(i,j-3,k), rho_u(i,j-2,k), rho_u(i,j-1,k),
+                                 rho_u(i,j  ,k), rho_u(i,j+1,k), rho_u(i,j+2,k));
+    },
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+    {
+        fyv(i,j,k) = NumDiffFlux(rho_v(i,j-3,k), rho_v(i,j-2,k), rho_v(i,j-1,k),
+                                 rho_v(i,j  ,k), rho_v(i,j+1,k), rho_v(i,j+2,k));
+    },
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+    {
+        fyw(i,j,k) = NumDiffFlux(rho_w(i,j-3,k), rho_w(i,j-2,k), rho_w(i,j-1,k),
+                                 rho_w(i,j  ,k), rho_w(i,j+1,k), rho_w(i,j+2,k));
     });
 
     // Capture diffusion coeff
     Real coeff6 = num_diff_coeff / (2.0 * dt);
 
-    // Compute 5th order derivative and augment RHS
-    amrex::ParallelFor(bx, num_comp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int m) noexcept
+    // Augment RHS with the flux divergence
+    amrex::ParallelFor(tbx, tby, tbz,
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+    {
+        Real mfy = 0.5 * ( mf_v(i-1,j,0) + mf_v(i,j,0) );
+        rho_u_rhs(i,j,k) += coeff6 * ( (fxu(i+1,j,k) - fxu(i,j,k)) * mf_m(i,j,0)
+                                     + (fyu(i,j+1,k) - fyu(i,j,k)) * mfy );
+    },
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+    {
+        Real mfx = 0.5 * ( mf_u(i,j-1,0) + mf_u(i,j,0) );
+        rho_v_rhs(i,j,k) += coeff6 * ( (fxv(i+1,j,k) - fxv(i,j,k)) * mfx
+                                     + (fyv(i,j+1,k) - fyv(i,j,k)) * mf_m(i,j,0) );
+    },
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
     {
-        int n = start_comp + m;
-        Real xflux_lo = 10. * (data(i  ,j,k,n) - data(i-1,j,k,n))
-                       - 5. * (data(i+1,j,k,n) - data(i-2,j,k,n))
-                            + (data(i+2,j,k,n) - data(i-3,j,k,n));
-        if ( (xflux_lo * (data(i,j,k,n) - data(i-1,j,k,n)) ) > 0.) xflux_lo = 0.;
-        Real xflux_hi = 10. * (data(i+1,j,k,n) - data(i  ,j,k,n))
-                       - 5. * (data(i+2,j,k,n) - data(i-1,j,k,n))
-                            + (data(i+3,j,k,n) - data(i-2,j,k,n));
-        if ( (xflux_hi * (data(i+1,j,k,n) - data(i,j,k,n)) ) > 0.) xflux_hi = 0.;
-        Real yflux_lo = 10. * (data(i,j  ,k,n) - data(i,j-1,k,n))
-                       - 5. * (data(i,j+1,k,n) - data(i,j-2,k,n))
-                            + (data(i,j+2,k,n) - data(i,j-3,k,n));
-        if ( (yflux_lo * (data(i,j,k,n) - data(i,j-1,k,n)) ) > 0.) yflux_lo = 0.;
-        Real yflux_hi = 10. * (data(i,j+1,k,n) - data(i,j  ,k,n))
-                       - 5. * (data(i,j+2,k,n) - data(i,j-1,k,n))
-                            + (data(i,j+3,k,n) - data(i,j-2,k,n));
-        if ( (yflux_hi * (data(i,j+1,k,n) - data(i,j,k,n)) ) > 0.) yflux_hi = 0.;
-        rhs(i,j,k,n) += coeff6 * ( (xflux_hi - xflux_lo) * mfx_arr(i,j,0)
-                                 + (yflux_hi - yflux_lo) * mfy_arr(i,j,0) );
+        rho_w_rhs(i,j,k) += coeff6 * ( (fxw(i+1,j,k) - fxw(i,j,k)) * mf_u(i,j,0)
+                                     + (fyw(i,j+1,k) - fyw(i,j,k)) * mf_v(i,j,0) );
     });
 }
@@ -17,6 +17,23 @@ using namespace amrex;
  * @param[in] geom problem geometry
  * @param[in] turbChoice container with turbulence parameters
  * @param[in] most pointer to Monin-Obukhov class if instantiated
+ * @param[in] bc_ptr container with boundary condition types
+ * @param[in] z_phys_nd height coordinate at nodes (null without terrain)
+ * @param[in] level AMR level (selects the MOST data)
+ *
+ * MYNN2.5 runs one thread per column: the vertical integrals of the master
+ * length scale are accumulated in registers in a first sweep over the column
+ * and the diffusivities are computed in a second sweep, so no scratch storage
+ * is needed.
+ *
+ * YSU (Hong, Noh & Dudhia 2006) is organized the same way. The PBL height is
+ * found from the bulk Richardson number (including the thermal excess of the
+ * surface parcel in convective conditions), then a single sweep evaluates the
+ * nonlocal K-profile below it, the entrainment at its top and a local
+ * Richardson number closure above it. The surface layer comes from MOST
+ * (u_star, t_star and the Obukhov length); YSU has no prognostic QKE. The
+ * explicit nonlocal (countergradient) heat flux of YSU is not included since
+ * only eddy diffusivities are passed to the diffusion operator.
  */
 void
 ComputeTurbulentViscosityPBL (const amrex::MultiFab& xvel,
@@ -28,10 +45,36 @@ ComputeTurbulentViscosityPBL (const amrex::MultiFab& xvel,
                               std::unique_ptr<ABLMost>& most,
                               const amrex::BCRec* bc_ptr,
                               bool /*vert_only*/,
-                              const std::unique_ptr<amrex::MultiFab>& z_phys_nd)
+                              const std::unique_ptr<amrex::MultiFab>& z_phys_nd,
+                              const int& level)
 {
     const bool use_terrain = (z_phys_nd != nullptr);
 
+    // Dirichlet flags to switch derivative stencil
+    bool c_ext_dir_on_zlo = ( (bc_ptr[BCVars::cons_bc].lo(2) == ERFBCType::ext_dir) );
+    bool c_ext_dir_on_zhi = ( (bc_ptr[BCVars::cons_bc].lo(5) == ERFBCType::ext_dir) );
+    bool u_ext_dir_on_zlo = ( (bc_ptr[BCVars::xvel_bc].lo(2) == ERFBCType::ext_dir) );
+    bool u_ext_dir_on_zhi = ( (bc_ptr[BCVars::xvel_bc].lo(5) == ERFBCType::ext_dir) );
+    bool v_ext_dir_on_zlo = ( (bc_ptr[BCVars::yvel_bc].lo(2) == ERFBCType::ext_dir) );
+    bool v_ext_dir_on_zhi = ( (bc_ptr[BCVars::yvel_bc].lo(5) == ERFBCType::ext_dir) );
+
+    // Epsilon
+    Real eps = std::numeric_limits<Real>::epsilon();
+
+    const amrex::GeometryData gdata = geom.data();
+    const auto& dxInv = geom.InvCellSizeArray();
+    Real dz_inv = geom.InvCellSize(2);
+    int izmin = geom.Domain().smallEnd(2);
+    int izmax = geom.Domain().bigEnd(2);
+
+    // Spatially varying MOST (on this level)
+    Real d_kappa   = KAPPA;
+    Real d_gravity = CONST_GRAV;
+
+    const auto& t_mean_mf = most->get_mac_avg(level,2); // TODO: IS THIS ACTUALLY RHOTHETA
+    const auto& u_star_mf = most->get_u_star(level);
+    const auto& t_star_mf = most->get_t_star(level);
+
     // MYNN Level 2.5 PBL Model
     if (turbChoice.pbl_type == PBLType::MYNN25) {
 
@@ -45,95 +88,22 @@ ComputeTurbulentViscosityPBL (const amrex::MultiFab& xvel,
         //const Real C4 = turbChoice.pbl_C4;
         const Real C5 = turbChoice.pbl_C5;
 
-        // Dirichlet flags to switch derivative stencil
-        bool c_ext_dir_on_zlo = ( (bc_ptr[BCVars::cons_bc].lo(2) == ERFBCType::ext_dir) );
-        bool c_ext_dir_on_zhi = ( (bc_ptr[BCVars::cons_bc].lo(5) == ERFBCType::ext_dir) );
-        bool u_ext_dir_on_zlo = ( (bc_ptr[BCVars::xvel_bc].lo(2) == ERFBCType::ext_dir) );
-        bool u_ext_dir_on_zhi = ( (bc_ptr[BCVars::xvel_bc].lo(5) == ERFBCType::ext_dir) );
-        bool v_ext_dir_on_zlo = ( (bc_ptr[BCVars::yvel_bc].lo(2) == ERFBCType::ext_dir) );
-        bool v_ext_dir_on_zhi = ( (bc_ptr[BCVars::yvel_bc].lo(5) == ERFBCType::ext_dir) );
-
-        // Epsilon
-        Real eps = std::numeric_limits<Real>::epsilon();
-
 #ifdef _OPENMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
         for ( amrex::MFIter mfi(eddyViscosity,amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
 
+            // Box includes one ghost cell in each direction
             const amrex::Box &bx = mfi.growntilebox(1);
             const amrex::Array4<Real const> &cell_data     = cons_in.array(mfi);
             const amrex::Array4<Real      > &K_turb = eddyViscosity.array(mfi);
             const amrex::Array4<Real const> &uvel = xvel.array(mfi);
             const amrex::Array4<Real const> &vvel = yvel.array(mfi);
 
-            // Compute some quantities that are constant in each column
-            // Sbox is shrunk to only include the interior of the domain in the vertical direction to compute integrals
-            // Box includes one ghost cell in each direction
-            const amrex::Box &dbx = geom.Domain();
-            amrex::Box sbx(bx.smallEnd(), bx.bigEnd());
-            sbx.grow(2,-1);
-            AMREX_ALWAYS_ASSERT(sbx.smallEnd(2) == dbx.smallEnd(2) && sbx.bigEnd(2) == dbx.bigEnd(2));
-
-            const amrex::GeometryData gdata = geom.data();
-
-            const amrex::Box xybx = PerpendicularBox<ZDir>(bx, amrex::IntVect{0,0,0});
-            amrex::FArrayBox qintegral(xybx,2);
-            qintegral.setVal<amrex::RunOn::Device>(0.0);
-            amrex::FArrayBox qturb(bx,1); amrex::FArrayBox qturb_old(bx,1);
-            const amrex::Array4<Real> qint = qintegral.array();
-            const amrex::Array4<Real> qvel = qturb.array();
-            const amrex::Array4<Real> qvel_old = qturb_old.array();
-
-            // vertical integrals to compute lengthscale
-            if (use_terrain) {
-                const amrex::Array4<Real const> &z_nd_arr = z_phys_nd->array(mfi);
-                const auto invCellSize = geom.InvCellSizeArray();
-                ParallelFor(amrex::Gpu::KernelInfo().setReduction(true), bx,
-                                   [=] AMREX_GPU_DEVICE (int i, int j, int k, amrex::Gpu::Handler const& handler) noexcept
-                {
-                    qvel(i,j,k)     = std::sqrt(cell_data(i,j,k,RhoQKE_comp) / cell_data(i,j,k,Rho_comp));
-                    qvel_old(i,j,k) = std::sqrt(cell_data(i,j,k,RhoQKE_comp) / cell_data(i,j,k,Rho_comp) + eps);
-                    AMREX_ASSERT_WITH_MESSAGE(qvel(i,j,k) > 0.0, "QKE must have a positive value");
-                    AMREX_ASSERT_WITH_MESSAGE(qvel_old(i,j,k) > 0.0, "Old QKE must have a positive value");
-
-                    if (sbx.contains(i,j,k)) {
-                        const Real Zval = Compute_Zrel_AtCellCenter(i,j,k,z_nd_arr);
-                        const Real dz = Compute_h_zeta_AtCellCenter(i,j,k,invCellSize,z_nd_arr);
-                        amrex::Gpu::deviceReduceSum(&qint(i,j,0,0), Zval*qvel(i,j,k)*dz, handler);
-                        amrex::Gpu::deviceReduceSum(&qint(i,j,0,1), qvel(i,j,k)*dz, handler);
-                    }
-                });
-            } else {
-                ParallelFor(amrex::Gpu::KernelInfo().setReduction(true), bx,
-                                   [=] AMREX_GPU_DEVICE (int i, int j, int k, amrex::Gpu::Handler const& handler) noexcept
-                {
-                    qvel(i,j,k)     = std::sqrt(cell_data(i,j,k,RhoQKE_comp) / cell_data(i,j,k,Rho_comp));
-                    qvel_old(i,j,k) = std::sqrt(cell_data(i,j,k,RhoQKE_comp) / cell_data(i,j,k,Rho_comp) + eps);
-                    AMREX_ASSERT_WITH_MESSAGE(qvel(i,j,k) > 0.0, "QKE must have a positive value");
-                    AMREX_ASSERT_WITH_MESSAGE(qvel_old(i,j,k) > 0.0, "Old QKE must have a positive value");
-
-                    // Not multiplying by dz: its constant and would fall out when we divide qint0/qint1 anyway
-                    if (sbx.contains(i,j,k)) {
-                        const Real Zval = gdata.ProbLo(2) + (k + 0.5)*gdata.CellSize(2);
-                        amrex::Gpu::deviceReduceSum(&qint(i,j,0,0), Zval*qvel(i,j,k), handler);
-                        amrex::Gpu::deviceReduceSum(&qint(i,j,0,1), qvel(i,j,k), handler);
-                    }
-                });
-            }
-
-            Real dz_inv = geom.InvCellSize(2);
-            const auto& dxInv = geom.InvCellSizeArray();
-            int izmin = geom.Domain().smallEnd(2);
-            int izmax = geom.Domain().bigEnd(2);
-
-            // Spatially varying MOST
-            Real d_kappa   = KAPPA;
-            Real d_gravity = CONST_GRAV;
-
-            const auto& t_mean_mf = most->get_mac_avg(0,2); // TODO: IS THIS ACTUALLY RHOTHETA
-            const auto& u_star_mf = most->get_u_star(0);    // Use coarsest level
-            const auto& t_star_mf = most->get_t_star(0);    // Use coarsest level
+            // The vertical integrals only include the interior of the domain
+            AMREX_ALWAYS_ASSERT(bx.smallEnd(2)+1 == izmin && bx.bigEnd(2)-1 == izmax);
+            const int klo = bx.smallEnd(2);
+            const int khi = bx.bigEnd(2);
 
             const auto& tm_arr     = t_mean_mf->array(mfi); // TODO: IS THIS ACTUALLY RHOTHETA
             const auto& u_star_arr = u_star_mf->array(mfi);
@@ -141,18 +111,36 @@ ComputeTurbulentViscosityPBL (const amrex::MultiFab& xvel,
 
             const amrex::Array4<Real const> z_nd_arr = use_terrain ? z_phys_nd->array(mfi) : Array4<Real>{};
 
-            ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            // One thread per column: the integrals for the length scale are accumulated
+            // in a first sweep, the eddy diffusivities are computed in a second one
+            const amrex::Box xybx = PerpendicularBox<ZDir>(bx, amrex::IntVect{0,0,0});
+            ParallelFor(xybx, [=] AMREX_GPU_DEVICE (int i, int j, int) noexcept
             {
-                // Compute some partial derivatives that we will need (second order)
-                // U and V derivatives are interpolated to account for staggered grid
-                const Real met_h_zeta = use_terrain ? Compute_h_zeta_AtCellCenter(i,j,k,dxInv,z_nd_arr) : 1.0;
-                Real dthetadz, dudz, dvdz;
-                ComputeVerticalDerivativesPBL(i, j, k,
-                                              uvel, vvel, cell_data, izmin, izmax, dz_inv/met_h_zeta,
-                                              c_ext_dir_on_zlo, c_ext_dir_on_zhi,
-                                              u_ext_dir_on_zlo, u_ext_dir_on_zhi,
-                                              v_ext_dir_on_zlo, v_ext_dir_on_zhi,
-                                              dthetadz, dudz, dvdz);
+                // Vertical integrals to compute the second length scale
+                Real qint0 = 0.0;
+                Real qint1 = 0.0;
+                for (int k = izmin; k <= izmax; ++k) {
+                    const Real qvel = std::sqrt(cell_data(i,j,k,RhoQKE_comp) / cell_data(i,j,k,Rho_comp));
+                    if (use_terrain) {
+                        const Real Zval = Compute_Zrel_AtCellCenter(i,j,k,z_nd_arr);
+                        const Real dz = Compute_h_zeta_AtCellCenter(i,j,k,dxInv,z_nd_arr);
+                        qint0 += Zval*qvel*dz;
+                        qint1 += qvel*dz;
+                    } else {
+                        // Not multiplying by dz: its constant and would fall out when we divide qint0/qint1 anyway
+                        const Real Zval = gdata.ProbLo(2) + (k + 0.5)*gdata.CellSize(2);
+                        qint0 += Zval*qvel;
+                        qint1 += qvel;
+                    }
+                }
+
+                // Second Length Scale
+                Real l_T;
+                if (qint1 > 0.0) {
+                    l_T = 0.23*qint0/qint1;
+                } else {
+                    l_T = std::numeric_limits<Real>::max();
+                }
 
                 // Spatially varying MOST
                 Real surface_heat_flux = -u_star_arr(i,j,0) * t_star_arr(i,j,0);
@@ -164,86 +152,280 @@ ComputeTurbulentViscosityPBL (const amrex::MultiFab& xvel,
                 } else {
                     l_obukhov = std::numeric_limits<Real>::max();
                 }
+                AMREX_ASSERT(l_obukhov != 0);
+
+                for (int k = klo; k <= khi; ++k) {
+                    const Real q2       = cell_data(i,j,k,RhoQKE_comp) / cell_data(i,j,k,Rho_comp);
+                    const Real qvel     = std::sqrt(q2);
+                    const Real qvel_old = std::sqrt(q2 + eps);
+                    AMREX_ASSERT_WITH_MESSAGE(qvel > 0.0, "QKE must have a positive value");
+                    AMREX_ASSERT_WITH_MESSAGE(qvel_old > 0.0, "Old QKE must have a positive value");
+
+                    // Compute some partial derivatives that we will need (second order)
+                    // U and V derivatives are interpolated to account for staggered grid
+                    const Real met_h_zeta = use_terrain ? Compute_h_zeta_AtCellCenter(i,j,k,dxInv,z_nd_arr) : 1.0;
+                    Real dthetadz, dudz, dvdz;
+                    ComputeVerticalDerivativesPBL(i, j, k,
+                                                  uvel, vvel, cell_data, izmin, izmax, dz_inv/met_h_zeta,
+                                                  c_ext_dir_on_zlo, c_ext_dir_on_zhi,
+                                                  u_ext_dir_on_zlo, u_ext_dir_on_zhi,
+                                                  v_ext_dir_on_zlo, v_ext_dir_on_zhi,
+                                                  dthetadz, dudz, dvdz);
 
-                // First Length Scale
+                    // First Length Scale
+                    int lk = amrex::max(k,0);
+                    const Real zval = gdata.ProbLo(2) + (lk + 0.5)*gdata.CellSize(2);
+                    const Real zeta = zval/l_obukhov;
+                    Real l_S;
+                    if (zeta >= 1.0) {
+                        l_S = KAPPA*zval/3.7;
+                    } else if (zeta >= 0) {
+                        l_S = KAPPA*zval/(1+2.7*zeta);
+                    } else {
+                        l_S = KAPPA*zval*std::pow(1.0 - 100.0 * zeta, 0.2);
+                    }
+
+                    // Third Length Scale
+                    Real l_B;
+                    if (dthetadz > 0) {
+                        Real N_brunt_vaisala = std::sqrt(CONST_GRAV/theta0 * dthetadz);
+                        if (zeta < 0) {
+                            Real qc = CONST_GRAV/theta0 * surface_heat_flux * l_T;
+                            qc = std::pow(qc,1.0/3.0);
+                            l_B = (1.0 + 5.0*std::sqrt(qc/(N_brunt_vaisala * l_T))) * qvel/N_brunt_vaisala;
+                        } else {
+                            l_B = qvel / N_brunt_vaisala;
+                        }
+                    } else {
+                        l_B = std::numeric_limits<Real>::max();
+                    }
+
+                    // Overall Length Scale
+                    Real l_comb = 1.0 / (1.0/l_S + 1.0/l_T + 1.0/l_B);
+
+                    // NOTE: Level 2 limiting from balance of production and dissipation.
+                    //       K_turb has a setval of 0.0 when the MF is created (NOT EACH STEP).
+                    //       We do this inline to avoid storing qe^2 at each cell.
+                    Real l_comb_old   = K_turb(i,j,k,EddyDiff::PBL_lengthscale);
+                    Real shearProd    = dudz*dudz + dvdz*dvdz;
+                    Real buoyProd     = -(CONST_GRAV/theta0) * dthetadz;
+                    Real lSM          = K_turb(i,j,k,EddyDiff::Mom_v)   / (qvel_old + eps);
+                    Real lSH          = K_turb(i,j,k,EddyDiff::Theta_v) / (qvel_old + eps);
+                    Real qe2          = B1 * l_comb_old * ( lSM * shearProd + lSH * buoyProd );
+                    Real qe           = (qe2 < 0.0) ? 0.0 : std::sqrt(qe2);
+                    Real one_m_alpha  = (qvel > qe) ? 1.0 : qvel / (qe + eps);
+                    Real one_m_alpha2 = one_m_alpha * one_m_alpha;
+
+                    // Compute non-dimensional parameters
+                    Real l2_over_q2   = l_comb*l_comb/(qvel*qvel);
+                    Real GM = l2_over_q2 * shearProd;
+                    Real GH = l2_over_q2 * buoyProd;
+                    Real E1 = 1.0 + one_m_alpha2 * ( 6.0*A1*A1*GM - 9.0*A1*A2*(1.0-C2)*GH );
+                    Real E2 = one_m_alpha2 * ( -3.0*A1*(4.0*A1 + 3.0*A2*(1.0-C5))*(1.0-C2)*GH );
+                    Real E3 = one_m_alpha2 * ( 6.0*A1*A2*GM );
+                    Real E4 = 1.0 + one_m_alpha2 * ( -12.0*A1*A2*(1.0-C2)*GH - 3.0*A2*B2*(1.0-C3)*GH );
+                    Real R1 = one_m_alpha * ( A1*(1.0-3.0*C1) );
+                    Real R2 = one_m_alpha * A2;
+
+                    Real SM = (R2*E2 - R1*E4)/(E2*E3 - E1*E4);
+                    Real SH = (R1*E3 - R2*E1)/(E2*E3 - E1*E4);
+                    Real SQ = 3.0 * SM; // Nakanishi & Niino 2009
+
+                    // Finally, compute the eddy viscosity/diffusivities
+                    const Real rho = cell_data(i,j,k,Rho_comp);
+                    K_turb(i,j,k,EddyDiff::Mom_v)   = rho * l_comb * qvel * SM * 0.5; // 0.5 for mu_turb
+                    K_turb(i,j,k,EddyDiff::Theta_v) = rho * l_comb * qvel * SH;
+                    K_turb(i,j,k,EddyDiff::QKE_v)   = rho * l_comb * qvel * SQ;
+
+                    K_turb(i,j,k,EddyDiff::PBL_lengthscale) = l_comb;
+                    // TODO: How should this be done for other components (scalars, moisture)
+                }
+            });
+        }
+    } else if (turbChoice.pbl_type == PBLType::YSU) {
+
+        // Critical bulk Richardson numbers for the PBL height
+        const Real Ric_stable   = turbChoice.pbl_ysu_Ric_stable;
+        const Real Ric_unstable = turbChoice.pbl_ysu_Ric_unstable;
+
+        // Constants of Hong, Noh & Dudhia (2006)
+        constexpr Real b_excess   = 7.8;   // thermal excess coefficient
+        constexpr Real max_excess = 3.0;   // upper bound of the thermal excess [K]
+        constexpr Real eps_sl     = 0.1;   // surface layer depth / PBL height
+        constexpr Real c_ent      = 0.15;  // entrainment flux coefficient
+        constexpr Real d1_ent     = 0.02;  // entrainment zone thickness coefficients
+        constexpr Real d2_ent     = 0.05;
+        constexpr Real lambda_0   = 30.0;  // asymptotic mixing length above the PBL [m]
+        constexpr Real min_wspd2  = 1.0;   // lower bound of the squared wind speed in Rib
+        constexpr Real min_ws     = 1.0e-3;
+        constexpr Real min_dthdz  = 1.0e-4;
+
+        const auto& olen_mf = most->get_olen(level);
+
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+        for ( amrex::MFIter mfi(eddyViscosity,amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+
+            // Box includes one ghost cell in each direction
+            const amrex::Box &bx = mfi.growntilebox(1);
+            const amrex::Array4<Real const> &cell_data     = cons_in.array(mfi);
+            const amrex::Array4<Real      > &K_turb = eddyViscosity.array(mfi);
+            const amrex::Array4<Real const> &uvel = xvel.array(mfi);
+            const amrex::Array4<Real const> &vvel = yvel.array(mfi);
+
+            // The column sweeps only include the interior of the domain
+            AMREX_ALWAYS_ASSERT(bx.smallEnd(2)+1 == izmin && bx.bigEnd(2)-1 == izmax);
+            const int klo = bx.smallEnd(2);
+            const int khi = bx.bigEnd(2);
+
+            const auto& tm_arr     = t_mean_mf->array(mfi); // plane-averaged theta
+            const auto& u_star_arr = u_star_mf->array(mfi);
+            const auto& t_star_arr = t_star_mf->array(mfi);
+            const auto& olen_arr   = olen_mf->array(mfi);
+
+            const amrex::Array4<Real const> z_nd_arr = use_terrain ? z_phys_nd->array(mfi) : Array4<Real>{};
+
+            // One thread per column: the PBL height is diagnosed by marching up the
+            // column until the bulk Richardson number exceeds its critical value,
+            // the diffusivities are computed in a second sweep
+            const amrex::Box xybx = PerpendicularBox<ZDir>(bx, amrex::IntVect{0,0,0});
+            ParallelFor(xybx, [=] AMREX_GPU_DEVICE (int i, int j, int) noexcept
+            {
+                // Height above the surface, potential temperature and squared wind speed
+                auto zval = [=] (int k) -> Real {
+                    return use_terrain ? Compute_Zrel_AtCellCenter(i,j,k,z_nd_arr)
+                                       : gdata.ProbLo(2) + (k + 0.5)*gdata.CellSize(2);
+                };
+                auto theta = [=] (int k) -> Real {
+                    return cell_data(i,j,k,RhoTheta_comp) / cell_data(i,j,k,Rho_comp);
+                };
+                auto wspd2 = [=] (int k) -> Real {
+                    const Real uc = 0.5*(uvel(i,j,k) + uvel(i+1,j,k));
+                    const Real vc = 0.5*(vvel(i,j,k) + vvel(i,j+1,k));
+                    return amrex::max(uc*uc + vc*vc, min_wspd2);
+                };
+
+                // Spatially varying MOST
+                const Real u_star            = u_star_arr(i,j,0);
+                const Real surface_heat_flux = -u_star * t_star_arr(i,j,0);
+                const Real theta0            = tm_arr(i,j,0);
+                const Real l_obukhov         = olen_arr(i,j,0);
                 AMREX_ASSERT(l_obukhov != 0);
-                int lk = amrex::max(k,0);
-                const Real zval = gdata.ProbLo(2) + (lk + 0.5)*gdata.CellSize(2);
-                const Real zeta = zval/l_obukhov;
-                Real l_S;
-                if (zeta >= 1.0) {
-                    l_S = KAPPA*zval/3.7;
-                } else if (zeta >= 0) {
-                    l_S = KAPPA*zval/(1+2.7*zeta);
-                } else {
-                    l_S = KAPPA*zval*std::pow(1.0 - 100.0 * zeta, 0.2);
+
+                const bool unstable = (surface_heat_flux > eps);
+                const Real Ric      = (unstable) ? Ric_unstable : Ric_stable;
+                const Real theta_a  = theta(izmin);
+
+                // PBL height from the bulk Richardson number of a parcel with
+                // potential temperature theta_s, interpolated between levels
+                auto pbl_height = [=] (Real theta_s, int& k_h) -> Real {
+                    Real rib_m = 0.0;
+                    Real z_m   = zval(izmin);
+                    for (int k = izmin; k <= izmax; ++k) {
+                        const Real z   = zval(k);
+                        const Real rib = d_gravity * (theta(k) - theta_s) * z / (theta_a * wspd2(k));
+                        if (rib >= Ric) {
+                            k_h = k;
+                            return (k == izmin) ? z : z_m + (Ric - rib_m) / (rib - rib_m) * (z - z_m);
+                        }
+                        rib_m = rib;
+                        z_m   = z;
+                    }
+                    k_h = izmax;
+                    return zval(izmax);
+                };
+
+                int  k_h;
+                Real h = pbl_height(theta_a, k_h);
+
+                // Convective PBL: redo the search with the thermal excess of the
+                // parcel, the velocity scale is that of the top of the surface layer
+                Real pr0 = 1.0;
+                if (unstable) {
+                    const Real phi_fac = 1.0 - 16.0*eps_sl*h/l_obukhov;
+                    const Real ws0     = amrex::max(u_star * std::pow(phi_fac, 0.25), min_ws);
+                    const Real excess  = amrex::min(b_excess*surface_heat_flux/ws0, max_excess);
+                    h   = pbl_height(theta_a + excess, k_h);
+                    pr0 = std::pow(phi_fac, -0.25) + b_excess*d_kappa*eps_sl;
+                    pr0 = amrex::min(amrex::max(pr0, 0.25), 4.0);
                 }
 
-                // Second Length Scale
-                Real l_T;
-                if (qint(i,j,0,1) > 0.0) {
-                    l_T = 0.23*qint(i,j,0,0)/qint(i,j,0,1);
-                } else {
-                    l_T = std::numeric_limits<Real>::max();
+                // Entrainment at the PBL top, spread over an inversion layer of depth delta
+                Real K_ent = 0.0;
+                Real delta = 1.0;
+                if (unstable) {
+                    const Real wstar3 = d_gravity/theta0 * surface_heat_flux * h;
+                    const Real wm3    = wstar3 + 5.0*u_star*u_star*u_star;
+                    const Real wm2    = std::pow(wm3, 2.0/3.0);
+                    const Real wtheta_h = -c_ent * (theta0/d_gravity) * wm3 / h;
+                    Real dthdz_h = min_dthdz;
+                    Real dtheta  = min_dthdz*h;
+                    if (k_h > izmin) {
+                        dtheta  = amrex::max(theta(k_h) - theta(k_h-1), dtheta);
+                        dthdz_h = amrex::max(dtheta / (zval(k_h) - zval(k_h-1)), min_dthdz);
+                    }
+                    // Convective Richardson number across the inversion
+                    const Real Ri_conv = d_gravity/theta0 * dtheta * h / wm2;
+                    delta = amrex::min(h * (d1_ent + d2_ent/Ri_conv), h);
+                    K_ent = -wtheta_h / dthdz_h;
                 }
 
-                // Third Length Scale
-                Real l_B;
-                if (dthetadz > 0) {
-                    Real N_brunt_vaisala = std::sqrt(CONST_GRAV/theta0 * dthetadz);
-                    if (zeta < 0) {
-                        Real qc = CONST_GRAV/theta0 * surface_heat_flux * l_T;
-                        qc = std::pow(qc,1.0/3.0);
-                        l_B = (1.0 + 5.0*std::sqrt(qc/(N_brunt_vaisala * l_T))) * qvel(i,j,k)/N_brunt_vaisala;
+                // Ghost cells above and below take the values of the adjacent interior cell
+                for (int k = klo; k <= khi; ++k) {
+                    const int  kk = amrex::min(amrex::max(k, izmin), izmax);
+                    const Real z  = zval(kk);
+                    Real K_m, K_h;
+                    if (z < h) {
+                        // Nonlocal K-profile with the velocity scale of the surface layer
+                        const Real zs = amrex::min(z, eps_sl*h);
+                        const Real phi_m = (unstable) ? std::pow(1.0 - 16.0*zs/l_obukhov, -0.25)
+                                                      : 1.0 + 5.0*zs/l_obukhov;
+                        const Real ws = amrex::max(u_star/phi_m, min_ws);
+                        K_m = d_kappa * ws * z * (1.0 - z/h) * (1.0 - z/h);
+                        Real pr = pr0;
+                        if (z > eps_sl*h) {
+                            pr = 1.0 + (pr0 - 1.0)*std::exp(-3.0*(z - eps_sl*h)*(z - eps_sl*h)/(h*h));
+                        }
+                        K_h = K_m / pr;
                     } else {
-                        l_B = qvel(i,j,k) / N_brunt_vaisala;
+                        // Local Richardson number closure in the free atmosphere
+                        const Real met_h_zeta = use_terrain ? Compute_h_zeta_AtCellCenter(i,j,kk,dxInv,z_nd_arr) : 1.0;
+                        Real dthetadz, dudz, dvdz;
+                        ComputeVerticalDerivativesPBL(i, j, kk,
+                                                      uvel, vvel, cell_data, izmin, izmax, dz_inv/met_h_zeta,
+                                                      c_ext_dir_on_zlo, c_ext_dir_on_zhi,
+                                                      u_ext_dir_on_zlo, u_ext_dir_on_zhi,
+                                                      v_ext_dir_on_zlo, v_ext_dir_on_zhi,
+                                                      dthetadz, dudz, dvdz);
+                        const Real shear2 = dudz*dudz + dvdz*dvdz;
+                        const Real Ri     = (d_gravity/theta0) * dthetadz / amrex::max(shear2, eps);
+                        const Real l_mix  = 1.0 / (1.0/(d_kappa*z) + 1.0/lambda_0);
+                        const Real f_Ri   = (Ri > 0.0) ? 1.0/((1.0 + 5.0*Ri)*(1.0 + 5.0*Ri))
+                                                       : std::sqrt(1.0 - 8.0*Ri);
+                        K_m = l_mix * l_mix * std::sqrt(shear2) * f_Ri;
+                        K_h = K_m;
                     }
-                } else {
-                    l_B = std::numeric_limits<Real>::max();
-                }
 
-                // Overall Length Scale
-                Real l_comb = 1.0 / (1.0/l_S + 1.0/l_T + 1.0/l_B);
-
-                // NOTE: Level 2 limiting from balance of production and dissipation.
-                //       K_turb has a setval of 0.0 when the MF is created (NOT EACH STEP).
-                //       We do this inline to avoid storing qe^2 at each cell.
-                Real l_comb_old   = K_turb(i,j,k,EddyDiff::PBL_lengthscale);
-                Real shearProd    = dudz*dudz + dvdz*dvdz;
-                Real buoyProd     = -(CONST_GRAV/theta0) * dthetadz;
-                Real lSM          = K_turb(i,j,k,EddyDiff::Mom_v)   / (qvel_old(i,j,k) + eps);
-                Real lSH          = K_turb(i,j,k,EddyDiff::Theta_v) / (qvel_old(i,j,k) + eps);
-                Real qe2          = B1 * l_comb_old * ( lSM * shearProd + lSH * buoyProd );
-                Real qe           = (qe2 < 0.0) ? 0.0 : std::sqrt(qe2);
-                Real one_m_alpha  = (qvel(i,j,k) > qe) ? 1.0 : qvel(i,j,k) / (qe + eps);
-                Real one_m_alpha2 = one_m_alpha * one_m_alpha;
-
-                // Compute non-dimensional parameters
-                Real l2_over_q2   = l_comb*l_comb/(qvel(i,j,k)*qvel(i,j,k));
-                Real GM = l2_over_q2 * shearProd;
-                Real GH = l2_over_q2 * buoyProd;
-                Real E1 = 1.0 + one_m_alpha2 * ( 6.0*A1*A1*GM - 9.0*A1*A2*(1.0-C2)*GH );
-                Real E2 = one_m_alpha2 * ( -3.0*A1*(4.0*A1 + 3.0*A2*(1.0-C5))*(1.0-C2)*GH );
-                Real E3 = one_m_alpha2 * ( 6.0*A1*A2*GM );
-                Real E4 = 1.0 + one_m_alpha2 * ( -12.0*A1*A2*(1.0-C2)*GH - 3.0*A2*B2*(1.0-C3)*GH );
-                Real R1 = one_m_alpha * ( A1*(1.0-3.0*C1) );
-                Real R2 = one_m_alpha * A2;
-
-                Real SM = (R2*E2 - R1*E4)/(E2*E3 - E1*E4);
-                Real SH = (R1*E3 - R2*E1)/(E2*E3 - E1*E4);
-                Real SQ = 3.0 * SM; // Nakanishi & Niino 2009
-
-                // Finally, compute the eddy viscosity/diffusivities
-                const Real rho = cell_data(i,j,k,Rho_comp);
-                K_turb(i,j,k,EddyDiff::Mom_v)   = rho * l_comb * qvel(i,j,k) * SM * 0.5; // 0.5 for mu_turb
-                K_turb(i,j,k,EddyDiff::Theta_v) = rho * l_comb * qvel(i,j,k) * SH;
-                K_turb(i,j,k,EddyDiff::QKE_v)   = rho * l_comb * qvel(i,j,k) * SQ;
-
-                K_turb(i,j,k,EddyDiff::PBL_lengthscale) = l_comb;
-                // TODO: How should this be done for other components (scalars, moisture)
+                    // Entrainment flux at the inversion (unit Prandtl number)
+                    if (unstable) {
+                        const Real K_e = K_ent * std::exp(-(z - h)*(z - h)/(delta*delta));
+                        K_m = amrex::max(K_m, K_e);
+                        K_h = amrex::max(K_h, K_e);
+                    }
+
+                    const Real rho = cell_data(i,j,kk,Rho_comp);
+                    K_turb(i,j,k,EddyDiff::Mom_v)    = rho * K_m * 0.5; // 0.5 for mu_turb
+                    K_turb(i,j,k,EddyDiff::Theta_v)  = rho * K_h;
+                    K_turb(i,j,k,EddyDiff::Scalar_v) = rho * K_h;
+                    K_turb(i,j,k,EddyDiff::Q1_v)     = rho * K_h;
+                    K_turb(i,j,k,EddyDiff::Q2_v)     = rho * K_h;
+                    K_turb(i,j,k,EddyDiff::Q3_v)     = rho * K_h;
+
+                    // No QKE with YSU, the length scale slot holds the PBL height
+                    K_turb(i,j,k,EddyDiff::PBL_lengthscale) = h;
+                }
             });
         }
-    } else if (turbChoice.pbl_type == PBLType::YSU) {
-        amrex::Error("YSU Model not implemented yet");
     }
 }
@@ -25,6 +25,7 @@ amrex::Real ERF::startCPUTime        = 0.0;
 amrex::Real ERF::previousCPUTimeUsed = 0.0;
 
 Vector<AMRErrorTag> ERF::ref_tags;
+Vector<TagCriterion> ERF::ref_fields;
 
 SolverChoice ERF::solverChoice;
 
@@ -115,6 +116,11 @@ ERF::ERF ()
     micro.ReSize(nlevs_max);
     qmoist.resize(nlevs_max);
 
+#if defined(ERF_USE_RRTMGP)
+    rad.resize(nlevs_max);
+    qheating_rates.resize(nlevs_max);
+#endif
+
     ReadParameters();
     const std::string& pv1 = "plot_vars_1"; setPlotVariables(pv1,plot_var_names_1);
     const std::string& pv2 = "plot_vars_2"; setPlotVariables(pv2,plot_var_names_2);
@@ -180,6 +186,9 @@ ERF::ERF ()
     mri_integrator_mem.resize(nlevs_max);
     physbcs.resize(nlevs_max);
 
+    // Per-box costs for load balancing
+    costs.resize(nlevs_max);
+
     advflux_reg.resize(nlevs_max);
 
     // Stresses
@@ -205,6 +214,7 @@ ERF::ERF ()
     z_phys_nd_src.resize(nlevs_max);
     detJ_cc_src.resize(nlevs_max);
     z_t_rk.resize(nlevs_max);
+    terrain_met_lev.resize(nlevs_max);
 
     // Mapfactors
     mapfac_m.resize(nlevs_max);
@@ -958,6 +968,16 @@ ERF::ReadParameters ()
         pp.query("sum_interval", sum_interval);
         pp.query("sum_period"  , sum_per);
 
+#if defined(ERF_USE_RRTMGP)
+        // Frequency of the shortwave and longwave radiation calls
+        pp.query("rad_sw_interval", rad_sw_interval);
+        pp.query("rad_sw_period"  , rad_sw_per);
+        pp.query("rad_lw_interval", rad_lw_interval);
+        pp.query("rad_lw_period"  , rad_lw_per);
+        pp.query("rad_cosz_refresh_interval", rad_cosz_interval);
+        pp.query("rad_cosz_refresh_period"  , rad_cosz_per);
+#endif
+
         // Time step controls
         pp.query("cfl", cfl);
         pp.query("init_shrink", init_shrink);
@@ -1106,6 +1126,13 @@ ERF::ReadParameters ()
             amrex::Abort("You must set cf_width >= cf_set_width >= 0");
         }
 
+        // Cost-weighted load balancing (after regridding and/or every load_balance_int level-0 steps)
+        pp.query("load_balance_on_regrid", load_balance_on_regrid);
+        pp.query("load_balance_int", load_balance_int);
+        pp.query("load_balance_with_sfc", load_balance_with_sfc);
+        pp.query("load_balance_knapsack_factor", load_balance_knapsack_factor);
+        pp.query("load_balance_efficiency_ratio_threshold", load_balance_efficiency_ratio_threshold);
+
         // AmrMesh iterate on grids?
         bool iterate(true);
         pp_amr.query("iterate_grids",iterate);
@@ -1474,6 +1501,11 @@ ERF::ERF (const amrex::RealBox& rb, int max_level_in,
     micro.ReSize(nlevs_max);
     qmoist.resize(nlevs_max);
 
+#if defined(ERF_USE_RRTMGP)
+    rad.resize(nlevs_max);
+    qheating_rates.resize(nlevs_max);
+#endif
+
     ReadParameters();
     const std::string& pv1 = "plot_vars_1"; setPlotVariables(pv1,plot_var_names_1);
     const std::string& pv2 = "plot_vars_2"; setPlotVariables(pv2,plot_var_names_2);
@@ -1515,6 +1547,9 @@ ERF::ERF (const amrex::RealBox& rb, int max_level_in,
     mri_integrator_mem.resize(nlevs_max);
     physbcs.resize(nlevs_max);
 
+    // Per-box costs for load balancing
+    costs.resize(nlevs_max);
+
     // Multiblock: public domain sizes (need to know which vars are nodal)
     Box nbx;
     domain_p.push_back(geom[0].Domain());
@@ -1550,6 +1585,7 @@ ERF::ERF (const amrex::RealBox& rb, int max_level_in,
     z_phys_nd_src.resize(nlevs_max);
     detJ_cc_src.resize(nlevs_max);
     z_t_rk.resize(nlevs_max);
+    terrain_met_lev.resize(nlevs_max);
 
     // Mapfactors
     mapfac_m.resize(nlevs_max);
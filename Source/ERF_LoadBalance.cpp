@@ -0,0 +1,311 @@
+/**
+ * \file ERF_LoadBalance.cpp
+ */
+
+/**
+ * Routines that measure per-box costs and use them to redistribute the boxes at a level
+*/
+
+#include <ERF.H>
+
+using namespace amrex;
+
+/**
+ * (Re)define the per-box cost container at this level and zero it
+ *
+ * @param[in] lev level of refinement
+*/
+void
+ERF::ResetCosts (int lev)
+{
+    if (!use_load_balance()) return;
+
+    // We use the state rather than grids/dmap since this is called before AmrCore sets them for a new level
+    const MultiFab& cons = vars_new[lev][Vars::cons];
+    costs[lev] = std::make_unique<LayoutData<Real>>(cons.boxArray(), cons.DistributionMap());
+    for (MFIter mfi(*costs[lev], false); mfi.isValid(); ++mfi) {
+        (*costs[lev])[mfi] = 0.0;
+    }
+}
+
+/**
+ * Distribute the wall time spent in a physics package at this level over the local boxes.
+ * The physics packages loop over boxes internally so we time the whole call on this rank
+ * and attribute it to the boxes in proportion to the work they hold.
+ *
+ * @param[in] lev level of refinement
+ * @param[in] cons conserved state at this level
+ * @param[in] wt wall time spent in the physics package on this rank
+ * @param[in] weight_by_moisture if true, boxes with condensate/precipitation are weighted more heavily
+*/
+void
+ERF::AddPhysicsCosts (int lev, const MultiFab& cons, Real wt, bool weight_by_moisture)
+{
+    if (!costs[lev]) return;
+
+    // Cells without any condensate or precipitation still cost something
+    const Real baseline_weight = 0.25;
+
+    LayoutData<Real> weight(cons.boxArray(), cons.DistributionMap());
+    Real weight_sum = 0.0;
+
+    for (MFIter mfi(cons, false); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        Real w = baseline_weight * static_cast<Real>(bx.numPts());
+
+        if (weight_by_moisture && cons.nComp() > RhoQ2_comp) {
+            const Array4<Real const>& cons_arr = cons.const_array(mfi);
+            ReduceOps<ReduceOpSum> reduce_op;
+            ReduceData<int> reduce_data(reduce_op);
+            using ReduceTuple = typename decltype(reduce_data)::Type;
+            reduce_op.eval(bx, reduce_data,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept -> ReduceTuple
+            {
+                return { (cons_arr(i,j,k,RhoQ2_comp) > 0.0) ? 1 : 0 };
+            });
+            w += static_cast<Real>(amrex::get<0>(reduce_data.value(reduce_op)));
+        }
+
+        weight[mfi] = w;
+        weight_sum += w;
+    }
+
+    if (weight_sum <= 0.0) return;
+
+    for (MFIter mfi(cons, false); mfi.isValid(); ++mfi) {
+        (*costs[lev])[mfi] += wt * weight[mfi] / weight_sum;
+    }
+}
+
+/**
+ * Redistribute the boxes at this level according to the measured costs. If the BoxArray has
+ * changed since the costs were measured (i.e. we have just regridded), the cost per cell of the
+ * old boxes is projected onto the new boxes before building the new DistributionMapping.
+ *
+ * @param[in] lev level of refinement
+ * @param[in] time current time
+*/
+void
+ERF::LoadBalance (int lev, Real time)
+{
+    BL_PROFILE("ERF::LoadBalance()");
+
+    if (ParallelDescriptor::NProcs() == 1) {
+        ResetCosts(lev);
+        return;
+    }
+
+    const BoxArray& ba = grids[lev];
+    const DistributionMapping& dm = dmap[lev];
+
+    LayoutData<Real> new_costs(ba, dm);
+
+    if (costs[lev] && costs[lev]->boxArray() == ba && costs[lev]->DistributionMap() == dm)
+    {
+        for (MFIter mfi(new_costs, false); mfi.isValid(); ++mfi) {
+            new_costs[mfi] = (*costs[lev])[mfi];
+        }
+    }
+    else if (costs[lev])
+    {
+        // Gather the cost per cell of all the old boxes ...
+        const BoxArray& ba_old = costs[lev]->boxArray();
+        Vector<Real> cost_density(ba_old.size(), 0.0);
+        for (MFIter mfi(*costs[lev], false); mfi.isValid(); ++mfi) {
+            cost_density[mfi.index()] = (*costs[lev])[mfi] / static_cast<Real>(ba_old[mfi.index()].numPts());
+        }
+        ParallelAllReduce::Sum(cost_density.data(), cost_density.size(), ParallelContext::CommunicatorSub());
+
+        // ... and project them onto the new boxes; cells not covered by an old box get the mean density
+        Real mean_density = 0.0;
+        for (const auto& c : cost_density) mean_density += c;
+        mean_density /= static_cast<Real>(amrex::max(1, static_cast<int>(cost_density.size())));
+
+        for (MFIter mfi(new_costs, false); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = ba[mfi.index()];
+            Real c = 0.0;
+            Long npts_covered = 0;
+            for (const auto& is : ba_old.intersections(bx)) {
+                c += cost_density[is.first] * static_cast<Real>(is.second.numPts());
+                npts_covered += is.second.numPts();
+            }
+            c += mean_density * static_cast<Real>(bx.numPts() - npts_covered);
+            new_costs[mfi] = c;
+        }
+    }
+    else
+    {
+        ResetCosts(lev);
+        return;
+    }
+
+    Real current_efficiency  = 0.0;
+    Real proposed_efficiency = 0.0;
+
+    DistributionMapping new_dm = (load_balance_with_sfc) ?
+        DistributionMapping::makeSFC(new_costs, current_efficiency, proposed_efficiency) :
+        DistributionMapping::makeKnapSack(new_costs, current_efficiency, proposed_efficiency,
+                                          static_cast<int>(load_balance_knapsack_factor *
+                                                           static_cast<Real>(ba.size()) /
+                                                           static_cast<Real>(ParallelDescriptor::NProcs())));
+
+    const bool do_rebalance = (proposed_efficiency > load_balance_efficiency_ratio_threshold * current_efficiency);
+
+    if (verbose > 0) {
+        amrex::Print() << "Load balance at level " << lev << ": current efficiency " << current_efficiency
+                       << ", proposed efficiency " << proposed_efficiency
+                       << (do_rebalance ? " -- redistributing" : " -- keeping the current mapping") << std::endl;
+    }
+
+    if (do_rebalance) {
+        RedistributeLevel(lev, time, new_dm);
+    }
+
+    ResetCosts(lev);
+}
+
+/**
+ * Move all the data at a level onto a new DistributionMapping without changing the BoxArray.
+ * Since the BoxArray is unchanged this is a pure copy, so the solution is unaffected.
+ *
+ * @param[in] lev level of refinement
+ * @param[in] time current time
+ * @param[in] new_dm the new DistributionMapping
+*/
+void
+ERF::RedistributeLevel (int lev, Real time, const DistributionMapping& new_dm)
+{
+    BL_PROFILE("ERF::RedistributeLevel()");
+
+    auto redistribute = [&new_dm] (auto& mf)
+    {
+        using MF = std::decay_t<decltype(mf)>;
+        MF tmp(mf.boxArray(), new_dm, mf.nComp(), mf.nGrowVect());
+        tmp.ParallelCopy(mf, 0, 0, mf.nComp(), mf.nGrowVect(), mf.nGrowVect());
+        std::swap(mf, tmp);
+    };
+    auto redistribute_ptr = [&redistribute] (auto& mf_ptr)
+    {
+        if (mf_ptr) redistribute(*mf_ptr);
+    };
+
+    // Solution data
+    for (int var_idx = 0; var_idx < Vars::NumTypes; ++var_idx) {
+        redistribute(vars_new[lev][var_idx]);
+        redistribute(vars_old[lev][var_idx]);
+    }
+
+    // Scratch space for the time integrator
+    redistribute(rU_old[lev]); redistribute(rU_new[lev]);
+    redistribute(rV_old[lev]); redistribute(rV_new[lev]);
+    redistribute(rW_old[lev]); redistribute(rW_new[lev]);
+
+    // Base state, map factors and terrain
+    redistribute(base_state[lev]);
+    if (base_state_new[lev].ok()) redistribute(base_state_new[lev]);
+
+    redistribute_ptr(mapfac_m[lev]); redistribute_ptr(mapfac_u[lev]); redistribute_ptr(mapfac_v[lev]);
+
+    redistribute_ptr(z_phys_nd[lev]);     redistribute_ptr(z_phys_cc[lev]);     redistribute_ptr(detJ_cc[lev]);
+    redistribute_ptr(z_phys_nd_new[lev]); redistribute_ptr(detJ_cc_new[lev]);
+    redistribute_ptr(z_phys_nd_src[lev]); redistribute_ptr(detJ_cc_src[lev]);
+    redistribute_ptr(z_t_rk[lev]);
+    for (auto& mf : terrain_met_lev[lev]) redistribute_ptr(mf);
+
+    redistribute_ptr(Theta_prim[lev]);
+
+    // Diffusive / turbulent terms
+    redistribute_ptr(Tau11_lev[lev]); redistribute_ptr(Tau22_lev[lev]); redistribute_ptr(Tau33_lev[lev]);
+    redistribute_ptr(Tau12_lev[lev]); redistribute_ptr(Tau21_lev[lev]);
+    redistribute_ptr(Tau13_lev[lev]); redistribute_ptr(Tau31_lev[lev]);
+    redistribute_ptr(Tau23_lev[lev]); redistribute_ptr(Tau32_lev[lev]);
+    redistribute_ptr(SFS_hfx1_lev[lev]); redistribute_ptr(SFS_hfx2_lev[lev]); redistribute_ptr(SFS_hfx3_lev[lev]);
+    redistribute_ptr(SFS_diss_lev[lev]);
+    redistribute_ptr(eddyDiffs_lev[lev]);
+    redistribute_ptr(SmnSmn_lev[lev]);
+
+    // Surface data
+    for (auto& mf : sst_lev[lev])   redistribute_ptr(mf);
+    for (auto& mf : lmask_lev[lev]) redistribute_ptr(mf);
+
+    // Microphysics -- the model owns its data so we save the moisture fields, redefine the model
+    //    on the new mapping and copy them back
+    Vector<MultiFab> qmoist_tmp(qmoist[lev].size());
+    for (int mvar(0); mvar<qmoist[lev].size(); ++mvar) {
+        qmoist_tmp[mvar].define(qmoist[lev][mvar]->boxArray(), new_dm, qmoist[lev][mvar]->nComp(),
+                                qmoist[lev][mvar]->nGrowVect());
+        qmoist_tmp[mvar].ParallelCopy(*qmoist[lev][mvar], 0, 0, qmoist[lev][mvar]->nComp(),
+                                      qmoist[lev][mvar]->nGrowVect(), qmoist[lev][mvar]->nGrowVect());
+    }
+
+    SetDistributionMap(lev, new_dm);
+
+    micro.Define(lev, solverChoice);
+    if (solverChoice.moisture_type != MoistureType::None)
+    {
+        micro.Init(lev, vars_new[lev][Vars::cons], grids[lev], Geom(lev), 0.0); // dummy dt value
+    }
+    for (int mvar(0); mvar<qmoist[lev].size(); ++mvar) {
+        qmoist[lev][mvar] = micro.Get_Qmoist_Ptr(lev,mvar);
+        MultiFab::Copy(*qmoist[lev][mvar], qmoist_tmp[mvar], 0, 0, qmoist_tmp[mvar].nComp(), qmoist_tmp[mvar].nGrowVect());
+    }
+
+    // Integrator memory
+    initialize_integrator(lev, vars_new[lev][Vars::cons], vars_new[lev][Vars::xvel]);
+
+    // Flux registers at this level and the next finer level both depend on this mapping
+    if (solverChoice.coupling_type == CouplingType::TwoWay) {
+        int ncomp_reflux = vars_new[lev][Vars::cons].nComp();
+        if (lev > 0) {
+            delete advflux_reg[lev];
+            advflux_reg[lev] = new YAFluxRegister(grids[lev], grids[lev-1],
+                                                  dmap[lev],  dmap[lev-1],
+                                                  geom[lev],  geom[lev-1],
+                                                  ref_ratio[lev-1], lev, ncomp_reflux);
+        }
+        if (lev < finest_level) {
+            delete advflux_reg[lev+1];
+            advflux_reg[lev+1] = new YAFluxRegister(grids[lev+1], grids[lev],
+                                                    dmap[lev+1],  dmap[lev],
+                                                    geom[lev+1],  geom[lev],
+                                                    ref_ratio[lev], lev+1, ncomp_reflux);
+        }
+    }
+
+    // Likewise for the coarse-fine FillPatchers
+    if (cf_width > 0) {
+        if (lev > 0) Define_ERFFillPatchers(lev);
+        if (lev < finest_level) Define_ERFFillPatchers(lev+1);
+    }
+
+    // The MOST data structures are defined on the level grids so we rebuild them,
+    //    keeping the (possibly evolved) roughness lengths
+    if (m_most) {
+        int nlevs = geom.size();
+        Vector<FArrayBox> z0_save(nlevs);
+        for (int l = 0; l < nlevs; ++l) {
+            z0_save[l].resize(m_most->get_z0(l)->box(), 1);
+            z0_save[l].copy<RunOn::Device>(*m_most->get_z0(l));
+        }
+
+        m_most = std::make_unique<ABLMost>(geom, vars_old, Theta_prim, z_phys_nd,
+                                           sst_lev, lmask_lev
+#ifdef ERF_USE_NETCDF
+                                           ,start_bdy_time, bdy_time_interval
+#endif
+                                           );
+        m_most->update_surf_temp(time);
+        for (int l = 0; l < nlevs; ++l) {
+            m_most->get_z0(l)->copy<RunOn::Device>(z0_save[l]);
+        }
+        for (int l = 0; l <= finest_level; ++l) {
+            m_most->update_mac_ptrs(l, vars_old, Theta_prim);
+        }
+    }
+
+#ifdef ERF_USE_PARTICLES
+    particleData.Redistribute();
+#endif
+}
@@ -1,5 +1,7 @@
 #include <ERF.H>
 #include <Derive.H>
+#include <TagStruct.H>
+#include <AMReX_iMultiFab.H>
 
 using namespace amrex;
 
@@ -16,38 +18,115 @@ ERF::ErrorEst (int level, TagBoxArray& tags, Real time, int /*ngrow*/)
 {
     const int clearval = TagBox::CLEAR;
     const int   tagval = TagBox::SET;
+
+    // Static (box-based) refinement -- these don't need any field data
     for (int j=0; j < ref_tags.size(); ++j)
     {
-        std::unique_ptr<MultiFab> mf;
+        ref_tags[j](tags,nullptr,clearval,tagval,time,level,geom[level]);
+    }
 
-        // This allows dynamic refinement based on the value of the density
-        if (ref_tags[j].Field() == "density")
-        {
-            mf = std::make_unique<MultiFab>(grids[level], dmap[level], 1, 0);
-            MultiFab::Copy(*mf,vars_new[level][Vars::cons],Rho_comp,0,1,0);
+    // Dynamic (field-based) refinement -- all criteria are evaluated in a single
+    //    kernel per box that reads the state directly and writes into the tags
+    if (level >= d_tag_parms.size()) return;
+    const int ncrit = d_tag_parms[level].size();
+    if (ncrit == 0) return;
+
+    bool use_moisture = (solverChoice.moisture_type != MoistureType::None);
+    int  q_size = (use_moisture) ? qmoist[level].size() : 0;
+
+    if (tag_needs_neighbors[level]) {
+        vars_new[level][Vars::cons].FillBoundary(geom[level].periodicity());
+        for (int n = 0; n < std::min(q_size, NumTagMoist); ++n) {
+            qmoist[level][n]->FillBoundary(geom[level].periodicity());
+        }
+    }
+    if (tag_needs_vel[level]) {
+        vars_new[level][Vars::xvel].FillBoundary(geom[level].periodicity());
+        vars_new[level][Vars::yvel].FillBoundary(geom[level].periodicity());
+        vars_new[level][Vars::zvel].FillBoundary(geom[level].periodicity());
+    }
+
+    // The stencils only use ghost cells that FillBoundary has filled from valid cells of
+    //    this level (including periodic images); they are made one-sided at non-periodic
+    //    domain boundaries and, on finer levels, at the coarse-fine boundary
+    iMultiFab valid_mask;
+    if (tag_needs_neighbors[level] || tag_needs_vel[level]) {
+        valid_mask.define(grids[level], dmap[level], 1, 1);
+        valid_mask.BuildMask(geom[level].Domain(), geom[level].periodicity(), 1, 0, 0, 1);
+    }
+
+    const auto dxInv = geom[level].InvCellSizeArray();
+    const auto dx    = geom[level].CellSizeArray();
+    const auto plo   = geom[level].ProbLoArray();
+
+    const TagParm* parms = d_tag_parms[level].data();
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(tags, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+
+        const Array4<char>       tag_arr = tags.array(mfi);
+        const Array4<Real const> cons    = vars_new[level][Vars::cons].const_array(mfi);
+        const Array4<Real const> u       = vars_new[level][Vars::xvel].const_array(mfi);
+        const Array4<Real const> v       = vars_new[level][Vars::yvel].const_array(mfi);
+        const Array4<Real const> w       = vars_new[level][Vars::zvel].const_array(mfi);
+        const Array4<int  const> valid   = (valid_mask.ok()) ? valid_mask.const_array(mfi) : Array4<int const>{};
 
-        // This allows dynamic refinement based on the value of the scalar/pressure/theta
-        } else if ( (ref_tags[j].Field() == "scalar"  ) ||
-                    (ref_tags[j].Field() == "pressure") ||
-                    (ref_tags[j].Field() == "theta"   ) )
+        GpuArray<Array4<Real const>,NumTagMoist> qm;
+        for (int n = 0; n < NumTagMoist; ++n) {
+            qm[n] = (n < q_size) ? qmoist[level][n]->const_array(mfi) : Array4<Real const>{};
+        }
+
+        ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
-            mf = std::make_unique<MultiFab>(grids[level], dmap[level], 1, 0);
-            for (MFIter mfi(*mf, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+            for (int n = 0; n < ncrit; ++n)
             {
-                const Box& bx = mfi.tilebox();
-                auto& dfab = (*mf)[mfi];
-                auto& sfab = vars_new[level][Vars::cons][mfi];
-                if (ref_tags[j].Field() == "scalar") {
-                    derived::erf_derscalar(bx, dfab, 0, 1, sfab, Geom(level), time, nullptr, level);
-                } else if (ref_tags[j].Field() == "theta") {
-                    derived::erf_dertheta(bx, dfab, 0, 1, sfab, Geom(level), time, nullptr, level);
+                const TagParm& p = parms[n];
+
+                if (time < p.min_time || time > p.max_time) continue;
+
+                if (p.use_realbox) {
+                    Real x = plo[0] + (i + 0.5) * dx[0];
+                    Real y = plo[1] + (j + 0.5) * dx[1];
+                    Real z = plo[2] + (k + 0.5) * dx[2];
+                    if (x < p.box_lo[0] || x > p.box_hi[0] ||
+                        y < p.box_lo[1] || y > p.box_hi[1] ||
+                        z < p.box_lo[2] || z > p.box_hi[2]) continue;
                 }
-            } // mfi
-        }
 
-        // This is sufficient for static refinement (where we don't need mf filled first)
-        ref_tags[j](tags,mf.get(),clearval,tagval,time,level,geom[level]);
-  }
+                bool tag_this = false;
+
+                if (p.field == TagField::vorticity) {
+                    Real om = tag_vorticity_mag(i, j, k, u, v, w, valid, dxInv);
+                    tag_this = (p.test == static_cast<int>(TagTest::Less)) ? (om <= p.value) : (om >= p.value);
+                } else if (p.test == static_cast<int>(TagTest::Grad)) {
+                    Real val = tag_field_value(p.field, i, j, k, cons, qm, use_moisture);
+                    int im = (valid(i-1,j,k)) ? i-1 : i; int ip = (valid(i+1,j,k)) ? i+1 : i;
+                    int jm = (valid(i,j-1,k)) ? j-1 : j; int jp = (valid(i,j+1,k)) ? j+1 : j;
+                    int km = (valid(i,j,k-1)) ? k-1 : k; int kp = (valid(i,j,k+1)) ? k+1 : k;
+                    Real diff = amrex::max(
+                      amrex::Math::abs(tag_field_value(p.field,ip,j,k,cons,qm,use_moisture) - val),
+                      amrex::Math::abs(tag_field_value(p.field,im,j,k,cons,qm,use_moisture) - val),
+                      amrex::Math::abs(tag_field_value(p.field,i,jp,k,cons,qm,use_moisture) - val),
+                      amrex::Math::abs(tag_field_value(p.field,i,jm,k,cons,qm,use_moisture) - val),
+                      amrex::Math::abs(tag_field_value(p.field,i,j,kp,cons,qm,use_moisture) - val),
+                      amrex::Math::abs(tag_field_value(p.field,i,j,km,cons,qm,use_moisture) - val));
+                    tag_this = (diff >= p.value);
+                } else {
+                    Real val = tag_field_value(p.field, i, j, k, cons, qm, use_moisture);
+                    tag_this = (p.test == static_cast<int>(TagTest::Greater)) ? (val >= p.value) : (val <= p.value);
+                }
+
+                if (tag_this) {
+                    tag_arr(i,j,k) = tagval;
+                    break;
+                }
+            } // n
+        });
+    } // mfi
 }
 
 /**
@@ -125,26 +204,53 @@ ERF::refinement_criteria_setup ()
                 info.SetMaxLevel(ref_max_level);
             }
 
+            TagTest test = TagTest::Greater;
+            std::string test_name;
             if (ppr.countval("value_greater")) {
-                int num_val = ppr.countval("value_greater");
-                Vector<Real> value(num_val);
-                ppr.getarr("value_greater",value,0,num_val);
-                std::string field; ppr.get("field_name",field);
-                ref_tags.push_back(AMRErrorTag(value,AMRErrorTag::GREATER,field,info));
-            }
-            else if (ppr.countval("value_less")) {
-                int num_val = ppr.countval("value_less");
-                Vector<Real> value(num_val);
-                ppr.getarr("value_less",value,0,num_val);
-                std::string field; ppr.get("field_name",field);
-                ref_tags.push_back(AMRErrorTag(value,AMRErrorTag::LESS,field,info));
+                test = TagTest::Greater; test_name = "value_greater";
+            } else if (ppr.countval("value_less")) {
+                test = TagTest::Less;    test_name = "value_less";
+            } else if (ppr.countval("adjacent_difference_greater")) {
+                test = TagTest::Grad;    test_name = "adjacent_difference_greater";
             }
-            else if (ppr.countval("adjacent_difference_greater")) {
-                int num_val = ppr.countval("adjacent_difference_greater");
-                Vector<Real> value(num_val);
-                ppr.getarr("adjacent_difference_greater",value,0,num_val);
+
+            if (!test_name.empty())
+            {
+                TagCriterion crit;
+                crit.test = test;
+
+                int num_val = ppr.countval(test_name.c_str());
+                crit.value.resize(num_val);
+                ppr.getarr(test_name.c_str(),crit.value,0,num_val);
+
                 std::string field; ppr.get("field_name",field);
-                ref_tags.push_back(AMRErrorTag(value,AMRErrorTag::GRAD,field,info));
+                crit.field = tag_field_from_name(field);
+                if (crit.field < 0) {
+                    Abort(std::string("Unrecognized field_name " + field + " for refinement indicator " + refinement_indicators[i]).c_str());
+                }
+                if (crit.field >= TagField::qt && solverChoice.moisture_type == MoistureType::None) {
+                    Abort(std::string("Refinement on " + field + " requires a moisture model").c_str());
+                }
+                if (crit.field >= TagField::qt && crit.field - TagField::qt >= micro.Get_Qmoist_Size()) {
+                    Abort(std::string("Refinement on " + field + " is not supported by the chosen moisture model").c_str());
+                }
+                if (crit.field == TagField::vorticity && test == TagTest::Grad) {
+                    Abort("adjacent_difference_greater is not supported for vorticity");
+                }
+
+                if (ppr.countval("max_level") > 0) ppr.get("max_level" , crit.max_level);
+                if (ppr.countval("start_time") > 0) ppr.get("start_time", crit.min_time);
+                if (ppr.countval("end_time"  ) > 0) ppr.get("end_time"  , crit.max_time);
+
+                if (realbox.ok()) {
+                    crit.use_realbox = true;
+                    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                        crit.box_lo[idim] = realbox.lo(idim);
+                        crit.box_hi[idim] = realbox.hi(idim);
+                    }
+                }
+
+                ref_fields.push_back(crit);
             }
             else if (realbox.ok())
             {
@@ -153,6 +259,38 @@ ERF::refinement_criteria_setup ()
                 Abort(std::string("Unrecognized refinement indicator for " + refinement_indicators[i]).c_str());
             }
         } // loop over criteria
+
+        // Build the per-level tables used by the fused tagging kernel in ErrorEst;
+        //    these only change if the criteria themselves change
+        d_tag_parms.resize(max_level);
+        tag_needs_neighbors.resize(max_level,0);
+        tag_needs_vel.resize(max_level,0);
+        for (int lev = 0; lev < max_level; ++lev)
+        {
+            Vector<TagParm> h_parms;
+            for (const auto& crit : ref_fields)
+            {
+                if (lev >= crit.max_level) continue;
+
+                TagParm p;
+                p.field       = crit.field;
+                p.test        = static_cast<int>(crit.test);
+                p.value       = crit.value[std::min(lev, static_cast<int>(crit.value.size())-1)];
+                p.min_time    = crit.min_time;
+                p.max_time    = crit.max_time;
+                p.use_realbox = crit.use_realbox;
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    p.box_lo[idim] = crit.box_lo[idim];
+                    p.box_hi[idim] = crit.box_hi[idim];
+                }
+                h_parms.push_back(p);
+
+                if (crit.test  == TagTest::Grad)       tag_needs_neighbors[lev] = 1;
+                if (crit.field == TagField::vorticity) tag_needs_vel[lev]       = 1;
+            }
+            d_tag_parms[lev].resize(h_parms.size());
+            Gpu::copy(Gpu::hostToDevice, h_parms.begin(), h_parms.end(), d_tag_parms[lev].begin());
+        }
     } // if max_level > 0
 }
 
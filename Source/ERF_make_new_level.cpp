@@ -173,6 +173,9 @@ void ERF::MakeNewLevelFromScratch (int lev, Real time, const BoxArray& ba,
             init_only(lev, start_time);
         }
     }
+
+    // Start measuring the costs at this level
+    ResetCosts(lev);
 }
 
 // Make a new level using provided BoxArray and DistributionMapping and
@@ -277,6 +280,9 @@ ERF::MakeNewLevelFromCoarse (int lev, Real time, const BoxArray& ba,
         Construct_ERFFillPatchers(lev);
           Define_ERFFillPatchers(lev);
     }
+
+    // Start measuring the costs at this level
+    ResetCosts(lev);
 }
 
 // Remake an existing level using provided BoxArray and DistributionMapping and
@@ -395,6 +401,12 @@ ERF::RemakeLevel (int lev, Real time, const BoxArray& ba, const DistributionMapp
           Define_ERFFillPatchers(lev);
         }
     }
+
+    // If we rebalance after regridding then LoadBalance projects the costs measured on the
+    //    old grids onto the new ones; otherwise we start measuring again on the new grids
+    if (!load_balance_on_regrid) {
+        ResetCosts(lev);
+    }
 }
 
 
@@ -412,11 +424,25 @@ ERF::update_diffusive_arrays (int lev, const BoxArray& ba, const DistributionMap
                            (solverChoice.turbChoice[lev].pbl_type        != PBLType::None) );
     bool l_use_ddorf   = (  solverChoice.turbChoice[lev].les_type        == LESType::Deardorff);
 
+    // The implicit vertical diffusion solves whole columns within a box, so no box may
+    //    be chopped in z (e.g. by amr.max_grid_size)
+    if (l_use_kturb && solverChoice.turbChoice[lev].vert_implicit_fac > 0.0) {
+        const Box& domain = geom[lev].Domain();
+        for (int i = 0; i < ba.size(); ++i) {
+            if (ba[i].smallEnd(2) != domain.smallEnd(2) || ba[i].bigEnd(2) != domain.bigEnd(2)) {
+                amrex::Abort("erf.vert_implicit_fac > 0 requires every box to span the domain in z");
+            }
+        }
+    }
+
+    // The matrix-free momentum diffusion (no terrain) does not need the tensor
+    bool l_store_tau   = !solverChoice.diffChoice.matrix_free_stress;
+
     BoxArray ba12 = convert(ba, IntVect(1,1,0));
     BoxArray ba13 = convert(ba, IntVect(1,0,1));
     BoxArray ba23 = convert(ba, IntVect(0,1,1));
 
-    if (l_use_diff) {
+    if (l_use_diff && l_store_tau) {
         Tau11_lev[lev] = std::make_unique<MultiFab>( ba  , dm, 1, IntVect(1,1,0) );
         Tau22_lev[lev] = std::make_unique<MultiFab>( ba  , dm, 1, IntVect(1,1,0) );
         Tau33_lev[lev] = std::make_unique<MultiFab>( ba  , dm, 1, IntVect(1,1,0) );
@@ -432,6 +458,14 @@ ERF::update_diffusive_arrays (int lev, const BoxArray& ba, const DistributionMap
             Tau31_lev[lev] = nullptr;
             Tau32_lev[lev] = nullptr;
         }
+    } else {
+      Tau11_lev[lev] = nullptr; Tau22_lev[lev] = nullptr; Tau33_lev[lev] = nullptr;
+      Tau12_lev[lev] = nullptr; Tau21_lev[lev] = nullptr;
+      Tau13_lev[lev] = nullptr; Tau31_lev[lev] = nullptr;
+      Tau23_lev[lev] = nullptr; Tau32_lev[lev] = nullptr;
+    }
+
+    if (l_use_diff) {
         SFS_hfx1_lev[lev] = std::make_unique<MultiFab>( ba  , dm, 1, IntVect(1,1,0) );
         SFS_hfx2_lev[lev] = std::make_unique<MultiFab>( ba  , dm, 1, IntVect(1,1,0) );
         SFS_hfx3_lev[lev] = std::make_unique<MultiFab>( ba  , dm, 1, IntVect(1,1,0) );
@@ -441,10 +475,6 @@ ERF::update_diffusive_arrays (int lev, const BoxArray& ba, const DistributionMap
         SFS_hfx3_lev[lev]->setVal(0.);
         SFS_diss_lev[lev]->setVal(0.);
     } else {
-      Tau11_lev[lev] = nullptr; Tau22_lev[lev] = nullptr; Tau33_lev[lev] = nullptr;
-      Tau12_lev[lev] = nullptr; Tau21_lev[lev] = nullptr;
-      Tau13_lev[lev] = nullptr; Tau31_lev[lev] = nullptr;
-      Tau23_lev[lev] = nullptr; Tau32_lev[lev] = nullptr;
       SFS_hfx1_lev[lev] = nullptr; SFS_hfx2_lev[lev] = nullptr; SFS_hfx3_lev[lev] = nullptr;
       SFS_diss_lev[lev] = nullptr;
     }
@@ -452,7 +482,8 @@ ERF::update_diffusive_arrays (int lev, const BoxArray& ba, const DistributionMap
     if (l_use_kturb) {
       eddyDiffs_lev[lev] = std::make_unique<MultiFab>( ba, dm, EddyDiff::NumDiffs, 1 );
       eddyDiffs_lev[lev]->setVal(0.0);
-      if(l_use_ddorf) {
+      // Without terrain the Deardorff shear production evaluates the strain on the fly
+      if(l_use_ddorf && solverChoice.use_terrain) {
           SmnSmn_lev[lev] = std::make_unique<MultiFab>( ba, dm, 1, 0 );
       } else {
           SmnSmn_lev[lev] = nullptr;
@@ -485,6 +516,9 @@ ERF::update_terrain_arrays (int lev, Real time)
         }
         make_J(geom[lev],*z_phys_nd[lev],*detJ_cc[lev]);
         make_zcc(geom[lev],*z_phys_nd[lev],*z_phys_cc[lev]);
+        if (solverChoice.terrain_type == TerrainType::Static) {
+            make_terrain_metrics(geom[lev],*z_phys_nd[lev],terrain_met_lev[lev]);
+        }
     }
 }
 
@@ -583,4 +617,5 @@ ERF::ClearLevel (int lev)
     // Clears the integrator memory
     mri_integrator_mem[lev].reset();
     physbcs[lev].reset();
+    costs[lev].reset();
 }
@@ -34,6 +34,9 @@ ERF::write_1D_profiles(Real time)
         Gpu::HostVector<Real> h_avg_p, h_avg_pu, h_avg_pv, h_avg_pw;
         Gpu::HostVector<Real> h_avg_tau11, h_avg_tau12, h_avg_tau13, h_avg_tau22, h_avg_tau23, h_avg_tau33;
         Gpu::HostVector<Real> h_avg_sgshfx, h_avg_sgsdiss; // only output tau_{theta,w} and epsilon for now
+        Gpu::HostVector<Real> h_avg_kmv, h_avg_khv, h_avg_pblh;
+
+        bool l_pbl_log = (NumDataLogs() > 4) && (solverChoice.turbChoice[0].pbl_type != PBLType::None);
 
         if (NumDataLogs() > 1) {
             derive_diag_profiles(h_avg_u, h_avg_v, h_avg_w,
@@ -51,6 +54,10 @@ ERF::write_1D_profiles(Real time)
                                    h_avg_sgsdiss);
         }
 
+        if (l_pbl_log) {
+            derive_pbl_profiles(h_avg_kmv, h_avg_khv, h_avg_pblh);
+        }
+
         int hu_size =  h_avg_u.size();
 
         auto const& dx = geom[0].CellSizeArray();
@@ -114,6 +121,24 @@ ERF::write_1D_profiles(Real time)
                   } // loop over z
                 } // if good
             } // NumDataLogs
+
+            if (l_pbl_log) {
+                std::ostream& data_log4 = DataLog(4);
+                if (data_log4.good()) {
+                  // Write the mean state with the eddy diffusivities and PBL height of the
+                  // PBL scheme; the diffusivities were computed from the state of the
+                  // previous output (at the start of this step)
+                  int pblprecision = 12;
+                  for (int k = 0; k < hu_size; k++) {
+                      Real z = (k + 0.5)* dx[2];
+                      data_log4 << std::setw(datwidth) << std::setprecision(timeprecision) << time << " "
+                                << std::setw(datwidth) << std::setprecision(pblprecision) << z << " "
+                                << h_avg_u[k] << " " << h_avg_v[k] << " " << h_avg_th[k] << " " << h_avg_rho[k] << " "
+                                << h_avg_kmv[k] << " " << h_avg_khv[k] << " " << h_avg_pblh[k]
+                                << std::endl;
+                  } // loop over z
+                } // if good
+            } // l_pbl_log
         } // if IOProcessor
     } // if verbose
 }
@@ -377,3 +402,34 @@ ERF::derive_stress_profiles(Gpu::HostVector<Real>& h_avg_tau11, Gpu::HostVector<
         h_avg_diss[k] /= area_z;
     }
 }
+
+/**
+ * Computes the profiles of the vertical eddy diffusivities of momentum and heat
+ * and of the PBL height stored by the PBL scheme (mu_turb convention, i.e.
+ * rho K_m / 2 and rho K_h)
+ *
+ * @param h_avg_kmv Profile of the vertical eddy viscosity on Host
+ * @param h_avg_khv Profile of the vertical eddy diffusivity of theta on Host
+ * @param h_avg_pblh Profile of the PBL height on Host
+ */
+void
+ERF::derive_pbl_profiles(Gpu::HostVector<Real>& h_avg_kmv, Gpu::HostVector<Real>& h_avg_khv,
+                         Gpu::HostVector<Real>& h_avg_pblh)
+{
+    int lev = 0;
+
+    int zdir = 2;
+    auto domain = geom[0].Domain();
+
+    h_avg_kmv  = sumToLine(*eddyDiffs_lev[lev],EddyDiff::Mom_v          ,1,domain,zdir);
+    h_avg_khv  = sumToLine(*eddyDiffs_lev[lev],EddyDiff::Theta_v        ,1,domain,zdir);
+    h_avg_pblh = sumToLine(*eddyDiffs_lev[lev],EddyDiff::PBL_lengthscale,1,domain,zdir);
+
+    int hk_size = h_avg_kmv.size();
+
+    // Divide by the total number of cells we are averaging over
+    Real area_z = static_cast<Real>(domain.length(0)*domain.length(1));
+    for (int k = 0; k < hk_size; ++k) {
+        h_avg_kmv[k] /= area_z; h_avg_khv[k] /= area_z; h_avg_pblh[k] /= area_z;
+    }
+}
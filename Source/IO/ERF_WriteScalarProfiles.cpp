@@ -37,6 +37,19 @@ ERF::sum_integrated_quantities(Real time)
         scal_ml += volWgtSumMF(lev,vars_new[lev][Vars::cons],RhoScalar_comp,*mapfac_m[lev],false,true);
     }
 
+    // Level 0 sum of the radiative potential temperature tendency
+    Real radh_sl = 0.0;
+#if defined(ERF_USE_RRTMGP)
+    if (qheating_rates[0]) {
+        radh_sl = volWgtSumMF(0,*qheating_rates[0],0,*mapfac_m[0],false,false)
+                + volWgtSumMF(0,*qheating_rates[0],1,*mapfac_m[0],false,false);
+    }
+#endif
+
+    // Level 0 maximum of the PBL height diagnosed by YSU
+    const bool has_pblh = (solverChoice.turbChoice[0].pbl_type == PBLType::YSU);
+    Real pblh_sl = (has_pblh) ? eddyDiffs_lev[0]->max(EddyDiff::PBL_lengthscale) : 0.0;
+
     if (verbose > 0) {
 
         Gpu::HostVector<Real> h_avg_ustar; h_avg_ustar.resize(1);
@@ -61,8 +74,8 @@ ERF::sum_integrated_quantities(Real time)
             h_avg_olen[0]  = 0.;
         }
 
-        const int nfoo = 6;
-        amrex::Real foo[nfoo] = {mass_sl,rhth_sl,scal_sl,mass_ml,rhth_ml,scal_ml};
+        const int nfoo = 7;
+        amrex::Real foo[nfoo] = {mass_sl,rhth_sl,scal_sl,mass_ml,rhth_ml,scal_ml,radh_sl};
 #ifdef AMREX_LAZY
         Lazy::QueueReduction([=]() mutable {
 #endif
@@ -77,6 +90,7 @@ ERF::sum_integrated_quantities(Real time)
             mass_ml = foo[i++];
             rhth_ml = foo[i++];
             scal_ml = foo[i++];
+            radh_sl = foo[i++];
 
             amrex::Print() << '\n';
             if (finest_level ==  0) {
@@ -88,6 +102,12 @@ ERF::sum_integrated_quantities(Real time)
                amrex::Print() << "TIME= " << time << " RHO THETA   SL/ML = " << rhth_sl << " " << rhth_ml << '\n';
                amrex::Print() << "TIME= " << time << " RHO SCALAR  SL/ML = " << scal_sl << " " << scal_ml << '\n';
             }
+#if defined(ERF_USE_RRTMGP)
+            amrex::Print() << "TIME= " << time << " RAD HEATING       = " << radh_sl << '\n';
+#endif
+            if (has_pblh) {
+               amrex::Print() << "TIME= " << time << " PBL HEIGHT        = " << pblh_sl << '\n';
+            }
 
             // The first data log only holds scalars
             if (NumDataLogs() > 0)
@@ -28,6 +28,7 @@ ERF::initRayleigh ()
     d_rayleigh_vbar.resize(max_level+1, amrex::Gpu::DeviceVector<Real>(0));
     d_rayleigh_wbar.resize(max_level+1, amrex::Gpu::DeviceVector<Real>(0));
     d_rayleigh_thetabar.resize(max_level+1, amrex::Gpu::DeviceVector<Real>(0));
+    rayleigh_klo.resize(max_level+1, 0);
 
     for (int lev = 0; lev <= finest_level; lev++)
     {
@@ -46,6 +47,15 @@ ERF::initRayleigh ()
         prob->erf_init_rayleigh(h_rayleigh_tau[lev], h_rayleigh_ubar[lev], h_rayleigh_vbar[lev],
                           h_rayleigh_wbar[lev], h_rayleigh_thetabar[lev], geom[lev]);
 
+        // The damping kernels skip everything below the lowest layer with nonzero tau
+        rayleigh_klo[lev] = zlen_rayleigh;
+        for (int k = 0; k < zlen_rayleigh; k++) {
+            if (h_rayleigh_tau[lev][k] != 0.0) {
+                rayleigh_klo[lev] = k;
+                break;
+            }
+        }
+
         // Copy from host version to device version
         amrex::Gpu::copy(amrex::Gpu::hostToDevice, h_rayleigh_tau[lev].begin(), h_rayleigh_tau[lev].end(),
                          d_rayleigh_tau[lev].begin());
@@ -226,6 +226,11 @@ ERF::init_from_metgrid (int lev)
     // This defines z at w-cell faces.
     make_zcc(geom[lev],*z_phys,*z_phys_cc[lev]);
 
+    // This caches the metric terms at cell centers and edges.
+    if (solverChoice.terrain_type == TerrainType::Static) {
+        make_terrain_metrics(geom[lev],*z_phys,terrain_met_lev[lev]);
+    }
+
     // Set up FABs to hold data that will be used to set lateral boundary conditions.
     int MetGridBdyEnd = MetGridBdyVars::NumTypes-1;
     if (use_moisture) MetGridBdyEnd = MetGridBdyVars::NumTypes;
@@ -184,6 +184,11 @@ ERF::init_from_wrfinput (int lev)
         make_J  (geom[lev],*z_phys_nd[lev],*  detJ_cc[lev]);
         make_zcc(geom[lev],*z_phys_nd[lev],*z_phys_cc[lev]);
 
+        // This caches the metric terms at cell centers and edges.
+        if (solverChoice.terrain_type == TerrainType::Static) {
+            make_terrain_metrics(geom[lev],*z_phys_nd[lev],terrain_met_lev[lev]);
+        }
+
     } // use_terrain
 
     MultiFab r_hse (base_state[lev], make_alias, 0, 1); // r_0  is first  component
@@ -1,8 +1,29 @@
 #include "Microphysics.H"
 
 /**
- * Computes diagnostic quantities like cloud ice/liquid and precipitation ice/liquid
- * from the existing Microphysics variables.
+ * Computes the qmoist diagnostics (qt, qv, qc) from the conserved variables.
  */
-void FastEddy::Diagnose () {
+void FastEddy::Diagnose ()
+{
+    auto qt = mic_fab_vars[MicVar_FE::qt];
+    auto qv = mic_fab_vars[MicVar_FE::qv];
+    auto qc = mic_fab_vars[MicVar_FE::qc];
+
+    for ( amrex::MFIter mfi(*m_cons, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        auto states_array = m_cons->const_array(mfi);
+
+        auto qt_array = qt->array(mfi);
+        auto qv_array = qv->array(mfi);
+        auto qc_array = qc->array(mfi);
+
+        const auto& box3d = mfi.tilebox();
+
+        amrex::ParallelFor(box3d, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
+        {
+            amrex::Real rho  = states_array(i,j,k,Rho_comp);
+            qv_array(i,j,k)  = states_array(i,j,k,RhoQ1_comp)/rho;
+            qc_array(i,j,k)  = states_array(i,j,k,RhoQ2_comp)/rho;
+            qt_array(i,j,k)  = qv_array(i,j,k) + qc_array(i,j,k);
+        });
+    }
 }
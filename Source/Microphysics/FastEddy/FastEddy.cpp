@@ -8,20 +8,50 @@
 
 using namespace amrex;
 
+/**
+ * Flags the columns in which the saturation adjustment can change the state:
+ * a cell is active if it holds (or has negative) cloud water, has negative
+ * vapor, or is within a relative ActiveColumns::qsat_margin of saturation.
+ */
+void FastEddy::Compute_Active_Columns ()
+{
+    for ( MFIter mfi(*m_cons); mfi.isValid(); ++mfi) {
+        auto states_array = m_cons->const_array(mfi);
+
+        m_active.build(mfi, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            Real rho = states_array(i,j,k,Rho_comp);
+            Real qv  = states_array(i,j,k,RhoQ1_comp)/rho;
+            if (states_array(i,j,k,RhoQ2_comp) != 0.0 || qv < 0.0) { return true; }
+
+            Real tabs     = getTgivenRandRTh(rho, states_array(i,j,k,RhoTheta_comp), qv);
+            Real pressure = getPgivenRTh(states_array(i,j,k,RhoTheta_comp), qv)/100.;
+            Real qsat;
+            erf_qsatw(tabs, pressure, qsat);
+            return (qv > (1.0 - ActiveColumns::qsat_margin)*qsat);
+        });
+    }
+}
+
 /**
  * Compute Precipitation-related Microphysics quantities.
+ *
+ * Boxes and columns without active cells are skipped; every other cell is
+ * updated exactly as without the mask.
  */
 void FastEddy::AdvanceFE ()
 {
-    auto tabs  = mic_fab_vars[MicVar_FE::tabs];
+    MultiFab& cons = *m_cons;
 
-    // get the temperature, dentisy, theta, qt and qc from input
-    for ( MFIter mfi(*tabs,TilingIfNotGPU()); mfi.isValid(); ++mfi) {
-        auto qv_array    = mic_fab_vars[MicVar_FE::qv]->array(mfi);
-        auto qc_array    = mic_fab_vars[MicVar_FE::qc]->array(mfi);
-        auto tabs_array  = mic_fab_vars[MicVar_FE::tabs]->array(mfi);
-        auto theta_array = mic_fab_vars[MicVar_FE::theta]->array(mfi);
-        auto pres_array  = mic_fab_vars[MicVar_FE::pres]->array(mfi);
+    // operate on the conserved state; theta, qv, qc, tabs and pres are derived in the kernel
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for ( MFIter mfi(cons,TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        if (!m_active.box_active(mfi)) { continue; }
+
+        auto states_array = cons.array(mfi);
+        auto mask         = m_active.const_array(mfi);
 
         const auto& box3d = mfi.tilebox();
 
@@ -30,14 +60,20 @@ void FastEddy::AdvanceFE ()
 
         ParallelFor(box3d, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
         {
+            if (!mask(i,j,0)) { return; }
+
+            Real rho   = states_array(i,j,k,Rho_comp);
+            Real theta = states_array(i,j,k,RhoTheta_comp)/rho;
+            Real qv    = states_array(i,j,k,RhoQ1_comp)/rho;
+            Real qc    = std::max(0.0, states_array(i,j,k,RhoQ2_comp)/rho);
 
-            qc_array(i,j,k) = std::max(0.0, qc_array(i,j,k));
+            Real tabs     = getTgivenRandRTh(rho, states_array(i,j,k,RhoTheta_comp), qv);
+            Real pressure = getPgivenRTh(states_array(i,j,k,RhoTheta_comp), qv)/100.;
 
             //------- Autoconversion/accretion
             Real dq_clwater_to_vapor, dq_vapor_to_clwater, qsat;
 
-            Real pressure = pres_array(i,j,k);
-            erf_qsatw(tabs_array(i,j,k), pressure, qsat);
+            erf_qsatw(tabs, pressure, qsat);
 
             // If there is precipitating water (i.e. rain), and the cell is not saturated
             // then the rain water can evaporate leading to extraction of latent heat, hence
@@ -46,27 +82,30 @@ void FastEddy::AdvanceFE ()
             dq_vapor_to_clwater = 0.0;
             dq_clwater_to_vapor = 0.0;
 
-            //Real fac = qsat*4093.0*L_v/(Cp_d*std::pow(tabs_array(i,j,k)-36.0,2));
-            Real fac = qsat*L_v*L_v/(Cp_d*R_v*tabs_array(i,j,k)*tabs_array(i,j,k));
+            //Real fac = qsat*4093.0*L_v/(Cp_d*std::pow(tabs-36.0,2));
+            Real fac = qsat*L_v*L_v/(Cp_d*R_v*tabs*tabs);
 
             // If water vapor content exceeds saturation value, then vapor condenses to waterm and latent heat is released, increasing temperature
-            if(qv_array(i,j,k) > qsat){
-                dq_vapor_to_clwater = std::min(qv_array(i,j,k), (qv_array(i,j,k)-qsat)/(1.0 + fac));
+            if(qv > qsat){
+                dq_vapor_to_clwater = std::min(qv, (qv-qsat)/(1.0 + fac));
             }
             // If water vapor is less than the satruated value, then the cloud water can evaporate, leading to evaporative cooling and
             // reducing temperature
-            if(qv_array(i,j,k) < qsat and qc_array(i,j,k) > 0.0){
-                dq_clwater_to_vapor = std::min(qc_array(i,j,k), (qsat - qv_array(i,j,k))/(1.0 + fac));
+            if(qv < qsat and qc > 0.0){
+                dq_clwater_to_vapor = std::min(qc, (qsat - qv)/(1.0 + fac));
             }
 
-            qv_array(i,j,k) = qv_array(i,j,k) - dq_vapor_to_clwater + dq_clwater_to_vapor;
-            qc_array(i,j,k) = qc_array(i,j,k) + dq_vapor_to_clwater - dq_clwater_to_vapor;
+            qv = qv - dq_vapor_to_clwater + dq_clwater_to_vapor;
+            qc = qc + dq_vapor_to_clwater - dq_clwater_to_vapor;
 
-            theta_array(i,j,k) = theta_array(i,j,k) + theta_array(i,j,k)/tabs_array(i,j,k)*d_fac_cond*(dq_vapor_to_clwater - dq_clwater_to_vapor);
+            theta = theta + theta/tabs*d_fac_cond*(dq_vapor_to_clwater - dq_clwater_to_vapor);
 
-            qv_array(i,j,k) = std::max(0.0, qv_array(i,j,k));
-            qc_array(i,j,k) = std::max(0.0, qc_array(i,j,k));
+            qv = std::max(0.0, qv);
+            qc = std::max(0.0, qc);
 
+            states_array(i,j,k,RhoTheta_comp) = rho*theta;
+            states_array(i,j,k,RhoQ1_comp)    = rho*qv;
+            states_array(i,j,k,RhoQ2_comp)    = rho*qc;
         });
     }
 }
@@ -3,27 +3,26 @@
 
 /**
  * Computes diagnostic quantities like cloud ice/liquid and precipitation ice/liquid
- * from the existing Microphysics variables.
+ * from the conserved variables.
  */
 void Kessler::Diagnose ()
 {
     auto qt   = mic_fab_vars[MicVar_Kess::qt];
-    auto qp   = mic_fab_vars[MicVar_Kess::qp];
     auto qv   = mic_fab_vars[MicVar_Kess::qv];
-    auto qn   = mic_fab_vars[MicVar_Kess::qn];
     auto qcl  = mic_fab_vars[MicVar_Kess::qcl];
     auto qci  = mic_fab_vars[MicVar_Kess::qci];
+    auto qp   = mic_fab_vars[MicVar_Kess::qp];
     auto qpl  = mic_fab_vars[MicVar_Kess::qpl];
     auto qpi  = mic_fab_vars[MicVar_Kess::qpi];
-    auto tabs = mic_fab_vars[MicVar_Kess::tabs];
 
-    for ( amrex::MFIter mfi(*tabs, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+    for ( amrex::MFIter mfi(*m_cons, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        auto states_array = m_cons->const_array(mfi);
+
         auto qt_array    = qt->array(mfi);
-        auto qp_array    = qp->array(mfi);
         auto qv_array    = qv->array(mfi);
-        auto qn_array    = qn->array(mfi);
         auto qcl_array   = qcl->array(mfi);
         auto qci_array   = qci->array(mfi);
+        auto qp_array    = qp->array(mfi);
         auto qpl_array   = qpl->array(mfi);
         auto qpi_array   = qpi->array(mfi);
 
@@ -31,14 +30,17 @@ void Kessler::Diagnose ()
 
         amrex::ParallelFor(box3d, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
         {
-            qt_array(i,j,k)  = qv_array(i,j,k) + qn_array(i,j,k);
+            amrex::Real rho  = states_array(i,j,k,Rho_comp);
+            amrex::Real qn   = states_array(i,j,k,RhoQ2_comp)/rho;
+            qv_array(i,j,k)  = states_array(i,j,k,RhoQ1_comp)/rho;
+            qp_array(i,j,k)  = states_array(i,j,k,RhoQ3_comp)/rho;
+            qt_array(i,j,k)  = qv_array(i,j,k) + qn;
             amrex::Real omn  = 1.0;
-            qcl_array(i,j,k) = qn_array(i,j,k)*omn;
-            qci_array(i,j,k) = qn_array(i,j,k)*(1.0-omn);
+            qcl_array(i,j,k) = qn*omn;
+            qci_array(i,j,k) = qn*(1.0-omn);
             amrex::Real omp  = 1.0;
             qpl_array(i,j,k) = qp_array(i,j,k)*omp;
             qpi_array(i,j,k) = qp_array(i,j,k)*(1.0-omp);
         });
     }
 }
-
@@ -28,11 +28,13 @@ void Kessler::Init (const MultiFab& cons_in,
     m_geom = geom;
     m_gtoe = grids;
 
-    MicVarMap.resize(m_qmoist_size);
-    MicVarMap = {MicVar_Kess::qt, MicVar_Kess::qv, MicVar_Kess::qcl, MicVar_Kess::qci,
-                 MicVar_Kess::qp, MicVar_Kess::qpl, MicVar_Kess::qpi};
+    // rain terminal velocity law
+    m_vt_pow.define(0.1346);
 
-    // initialize microphysics variables
+    // column activity mask, rebuilt in every advance
+    m_active.define(cons_in.boxArray(), cons_in.DistributionMap(), m_use_active_columns);
+
+    // initialize diagnostic variables
     for (auto ivar = 0; ivar < MicVar_Kess::NumVars; ++ivar) {
         mic_fab_vars[ivar] = std::make_shared<MultiFab>(cons_in.boxArray(), cons_in.DistributionMap(),
                                                         1, cons_in.nGrowVect());
@@ -51,46 +53,3 @@ void Kessler::Init (const MultiFab& cons_in,
         zhi  = hi.z;
     }
 }
-
-/**
- * Initializes the Microphysics module.
- *
- * @param[in] cons_in Conserved variables input
- */
-void Kessler::Copy_State_to_Micro (const MultiFab& cons_in)
-{
-    // Get the temperature, density, theta, qt and qp from input
-    for ( MFIter mfi(cons_in); mfi.isValid(); ++mfi) {
-        const auto& box3d = mfi.tilebox();
-
-        auto states_array = cons_in.array(mfi);
-
-        auto qv_array    = mic_fab_vars[MicVar_Kess::qv]->array(mfi);
-        auto qc_array    = mic_fab_vars[MicVar_Kess::qcl]->array(mfi);
-        auto qi_array    = mic_fab_vars[MicVar_Kess::qci]->array(mfi);
-        auto qn_array    = mic_fab_vars[MicVar_Kess::qn]->array(mfi);
-        auto qp_array    = mic_fab_vars[MicVar_Kess::qp]->array(mfi);
-
-        auto rho_array   = mic_fab_vars[MicVar_Kess::rho]->array(mfi);
-        auto theta_array = mic_fab_vars[MicVar_Kess::theta]->array(mfi);
-        auto tabs_array  = mic_fab_vars[MicVar::tabs]->array(mfi);
-        auto pres_array  = mic_fab_vars[MicVar::pres]->array(mfi);
-
-        // Get pressure, theta, temperature, density, and qt, qp
-        amrex::ParallelFor( box3d, [=] AMREX_GPU_DEVICE (int i, int j, int k)
-        {
-            rho_array(i,j,k)   = states_array(i,j,k,Rho_comp);
-            theta_array(i,j,k) = states_array(i,j,k,RhoTheta_comp)/states_array(i,j,k,Rho_comp);
-            qv_array(i,j,k)    = states_array(i,j,k,RhoQ1_comp)/states_array(i,j,k,Rho_comp);
-            qc_array(i,j,k)    = states_array(i,j,k,RhoQ2_comp)/states_array(i,j,k,Rho_comp);
-            qp_array(i,j,k)    = states_array(i,j,k,RhoQ3_comp)/states_array(i,j,k,Rho_comp);
-            qn_array(i,j,k)    = qc_array(i,j,k) + qi_array(i,j,k);
-
-            tabs_array(i,j,k)  = getTgivenRandRTh(states_array(i,j,k,Rho_comp),
-                                                  states_array(i,j,k,RhoTheta_comp),
-                                                  qv_array(i,j,k));
-            pres_array(i,j,k)  = getPgivenRTh(states_array(i,j,k,RhoTheta_comp), qv_array(i,j,k))/100.;
-        });
-    }
-}
-
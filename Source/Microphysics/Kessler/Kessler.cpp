@@ -9,101 +9,185 @@
 using namespace amrex;
 
 /**
- * Compute Precipitation-related Microphysics quantities.
+ * Flags the columns in which sedimentation or the conversions can change the
+ * state: a cell is active if it holds (or has negative) cloud or rain water,
+ * has negative vapor, or is within a relative ActiveColumns::qsat_margin of
+ * saturation. Columns without rain do not sediment, so one mask built before
+ * the rain fall serves both stages.
  */
-void Kessler::AdvanceKessler ()
+void Kessler::Compute_Active_Columns ()
+{
+    for ( MFIter mfi(*m_cons); mfi.isValid(); ++mfi) {
+        auto states_array = m_cons->const_array(mfi);
+
+        m_active.build(mfi, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            Real rho = states_array(i,j,k,Rho_comp);
+            Real qv  = states_array(i,j,k,RhoQ1_comp)/rho;
+            if (states_array(i,j,k,RhoQ2_comp) != 0.0 ||
+                states_array(i,j,k,RhoQ3_comp) != 0.0 || qv < 0.0) { return true; }
+
+            Real tabs     = getTgivenRandRTh(rho, states_array(i,j,k,RhoTheta_comp), qv);
+            Real pressure = getPgivenRTh(states_array(i,j,k,RhoTheta_comp), qv)/100.;
+            Real qsat;
+            erf_qsatw(tabs, pressure, qsat);
+            return (qv > (1.0 - ActiveColumns::qsat_margin)*qsat);
+        });
+    }
+}
+
+/**
+ * Sedimentation of rain, one column per thread.
+ *
+ * The terminal velocity (Klemp and Wilhelmson, 1978) is evaluated at the cell
+ * faces from the averaged density and rain water, and the column is subcycled
+ * so that the local fall CFL stays below 0.9. As in the WRF Kessler scheme,
+ * sedimentation is applied before the conversion processes.
+ */
+void Kessler::RainFall ()
 {
-    auto qt   = mic_fab_vars[MicVar_Kess::qt];
-    auto qp   = mic_fab_vars[MicVar_Kess::qp];
-    auto qn   = mic_fab_vars[MicVar_Kess::qn];
-    auto tabs = mic_fab_vars[MicVar_Kess::tabs];
-    auto pres = mic_fab_vars[MicVar_Kess::pres];
-
-    auto qcl   = mic_fab_vars[MicVar_Kess::qcl];
-    auto theta = mic_fab_vars[MicVar_Kess::theta];
-    auto qv    = mic_fab_vars[MicVar_Kess::qv];
-    auto rho   = mic_fab_vars[MicVar_Kess::rho];
-
-    auto dz = m_geom.CellSize(2);
+    MultiFab& cons = *m_cons;
+
+    Real dz  = m_geom.CellSize(2);
+    Real dtn = dt;
+
     auto domain = m_geom.Domain();
     int k_lo = domain.smallEnd(2);
     int k_hi = domain.bigEnd(2);
 
-    MultiFab fz;
-    auto ba    = tabs->boxArray();
-    auto dm    = tabs->DistributionMap();
-    fz.define(convert(ba, IntVect(0,0,1)), dm, 1, 0); // No ghost cells
+    auto vt_pow = m_vt_pow.view();
 
-    for ( MFIter mfi(fz, TilingIfNotGPU()); mfi.isValid(); ++mfi ){
-        auto rho_array = mic_fab_vars[MicVar_Kess::rho]->array(mfi);
-        auto qp_array  = mic_fab_vars[MicVar_Kess::qp]->array(mfi);
-        auto fz_array  = fz.array(mfi);
-        const Box& tbz = mfi.tilebox();
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for ( MFIter mfi(cons, TileNoZ()); mfi.isValid(); ++mfi ){
+        if (!m_active.box_active(mfi)) { continue; }
 
-        ParallelFor(tbz, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
+        auto states_array = cons.array(mfi);
+        auto mask         = m_active.const_array(mfi);
+
+        const Box& tbx = mfi.tilebox();
+        AMREX_ASSERT(tbx.smallEnd(2) == k_lo && tbx.bigEnd(2) == k_hi);
+
+        Box box2d(tbx);
+        box2d.setRange(2,0);
+
+        ParallelFor(box2d, [=] AMREX_GPU_DEVICE(int i, int j, int) noexcept
         {
-            Real rho_avg, qp_avg;
-
-            if (k==k_lo) {
-                rho_avg = rho_array(i,j,k);
-                qp_avg  = qp_array(i,j,k);
-            } else if (k==k_hi+1) {
-                rho_avg = rho_array(i,j,k-1);
-                qp_avg  = qp_array(i,j,k-1);
-            } else {
-                rho_avg = 0.5*(rho_array(i,j,k-1) + rho_array(i,j,k)); // Convert to g/cm^3
-                qp_avg = 0.5*(qp_array(i,j,k-1)  + qp_array(i,j,k));
+            if (!mask(i,j,0)) { return; }
+
+            // Density, rain water and terminal velocity at face k (bottom of cell k)
+            auto face_vals = [=] (int k, Real& rho_avg, Real& qp_avg) -> Real
+            {
+                if (k==k_lo) {
+                    rho_avg = states_array(i,j,k,Rho_comp);
+                    qp_avg  = states_array(i,j,k,RhoQ3_comp)/rho_avg;
+                } else if (k==k_hi+1) {
+                    rho_avg = states_array(i,j,k-1,Rho_comp);
+                    qp_avg  = states_array(i,j,k-1,RhoQ3_comp)/rho_avg;
+                } else {
+                    rho_avg = 0.5*(states_array(i,j,k-1,Rho_comp) + states_array(i,j,k,Rho_comp));
+                    qp_avg  = 0.5*(states_array(i,j,k-1,RhoQ3_comp)/states_array(i,j,k-1,Rho_comp) +
+                                   states_array(i,j,k  ,RhoQ3_comp)/states_array(i,j,k  ,Rho_comp));
+                }
+                qp_avg = std::max(0.0, qp_avg);
+
+                // 36.34*(0.001*rho*qp)^0.1346*(rho/1.16)^(-1/2), in m/s
+                return 36.34*vt_pow(rho_avg*0.001*qp_avg)*std::sqrt(1.16/rho_avg);
+            };
+
+            // Number of subcycles from the largest fall CFL in this column
+            Real cfl = 0.0;
+            for (int k = k_lo; k <= k_hi+1; ++k) {
+                Real rho_avg, qp_avg;
+                cfl = std::max(cfl, face_vals(k, rho_avg, qp_avg)*dtn/dz);
             }
+            if (cfl == 0.0) { return; }
+
+            int nsub = (cfl > 0.9) ? static_cast<int>(std::ceil(cfl/0.9)) : 1;
+            Real dts = dtn/Real(nsub);
 
-            qp_avg = std::max(0.0, qp_avg);
+            for (int isub = 0; isub < nsub; ++isub) {
+                Real rho_avg, qp_avg;
+                Real V = face_vals(k_lo, rho_avg, qp_avg);
+                Real fz_k = rho_avg*V*qp_avg;
+                if (std::fabs(fz_k) < 1e-14) fz_k = 0.0;
 
-            Real V_terminal = 36.34*std::pow(rho_avg*0.001*qp_avg, 0.1346)*std::pow(rho_avg/1.16, -0.5); // in m/s
+                // Sweep upward; the flux through the top face of cell k is
+                // evaluated before cell k is updated
+                for (int k = k_lo; k <= k_hi; ++k) {
+                    V = face_vals(k+1, rho_avg, qp_avg);
+                    Real fz_kp = rho_avg*V*qp_avg;
+                    if (std::fabs(fz_kp) < 1e-14) fz_kp = 0.0;
 
-            fz_array(i,j,k) = rho_avg*V_terminal*qp_avg;
+                    Real rho    = states_array(i,j,k,Rho_comp);
+                    Real dq_sed = 1.0/rho*(fz_kp - fz_k)/dz*dts;
+                    if (std::fabs(dq_sed) < 1e-14) dq_sed = 0.0;
 
-            /*if(k==0){
-              fz_array(i,j,k) = 0;
-              }*/
+                    Real qp = std::max(0.0, states_array(i,j,k,RhoQ3_comp)/rho + dq_sed);
+                    states_array(i,j,k,RhoQ3_comp) = rho*qp;
+
+                    fz_k = fz_kp;
+                }
+            }
         });
     }
+}
+
+/**
+ * Compute Precipitation-related Microphysics quantities.
+ *
+ * Boxes and columns without active cells are skipped; every other cell is
+ * updated exactly as without the mask.
+ */
+void Kessler::AdvanceKessler ()
+{
+    MultiFab& cons = *m_cons;
 
     Real dtn = dt;
 
-    // get the temperature, dentisy, theta, qt and qp from input
-    for ( MFIter mfi(*tabs,TilingIfNotGPU()); mfi.isValid(); ++mfi) {
-        auto tabs_array = mic_fab_vars[MicVar_Kess::tabs]->array(mfi);
-        auto pres_array = mic_fab_vars[MicVar_Kess::pres]->array(mfi);
-        auto qn_array   = mic_fab_vars[MicVar_Kess::qn]->array(mfi);
-        auto qt_array   = mic_fab_vars[MicVar_Kess::qt]->array(mfi);
-        auto qp_array   = mic_fab_vars[MicVar_Kess::qp]->array(mfi);
+    // operate on the conserved state; theta, qv, qn, qp, tabs and pres are derived in the kernel
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for ( MFIter mfi(cons,TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        if (!m_active.box_active(mfi)) { continue; }
 
-        auto theta_array = theta->array(mfi);
-        auto qv_array    = qv->array(mfi);
-        auto rho_array   = mic_fab_vars[MicVar_Kess::rho]->array(mfi);
+        auto states_array = cons.array(mfi);
+        auto mask         = m_active.const_array(mfi);
 
         const auto& box3d = mfi.tilebox();
 
-        auto fz_array  = fz.array(mfi);
-
         // Expose for GPU
         Real d_fac_cond = m_fac_cond;
 
         ParallelFor(box3d, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
         {
-            qt_array(i,j,k) = std::max(0.0, qt_array(i,j,k));
-            qp_array(i,j,k) = std::max(0.0, qp_array(i,j,k));
-            qn_array(i,j,k) = std::max(0.0, qn_array(i,j,k));
+            if (!mask(i,j,0)) { return; }
+
+            Real rho   = states_array(i,j,k,Rho_comp);
+            Real theta = states_array(i,j,k,RhoTheta_comp)/rho;
+            Real qv    = states_array(i,j,k,RhoQ1_comp)/rho;
+            Real qn    = states_array(i,j,k,RhoQ2_comp)/rho;
+            Real qp    = states_array(i,j,k,RhoQ3_comp)/rho;
+            Real qt    = qv + qn;
+
+            Real tabs     = getTgivenRandRTh(rho, states_array(i,j,k,RhoTheta_comp), qv);
+            Real pressure = getPgivenRTh(states_array(i,j,k,RhoTheta_comp), qv)/100.;
+
+            qt = std::max(0.0, qt);
+            qp = std::max(0.0, qp);
+            qn = std::max(0.0, qn);
 
-            if(qt_array(i,j,k) == 0.0){
-                qv_array(i,j,k) = 0.0;
-                qn_array(i,j,k) = 0.0;
+            if(qt == 0.0){
+                qv = 0.0;
+                qn = 0.0;
             }
 
             //------- Autoconversion/accretion
             Real qcc, autor, accrr, dq_clwater_to_rain, dq_rain_to_vapor, dq_clwater_to_vapor, dq_vapor_to_clwater, qsat;
 
-            Real pressure = pres_array(i,j,k);
-            erf_qsatw(tabs_array(i,j,k), pressure, qsat);
+            erf_qsatw(tabs, pressure, qsat);
 
             // If there is precipitating water (i.e. rain), and the cell is not saturated
             // then the rain water can evaporate leading to extraction of latent heat, hence
@@ -115,36 +199,36 @@ void Kessler::AdvanceKessler ()
             dq_clwater_to_vapor = 0.0;
 
 
-            //Real fac = qsat*4093.0*L_v/(Cp_d*std::pow(tabs_array(i,j,k)-36.0,2));
-            Real fac = qsat*L_v*L_v/(Cp_d*R_v*tabs_array(i,j,k)*tabs_array(i,j,k));
+            //Real fac = qsat*4093.0*L_v/(Cp_d*std::pow(tabs-36.0,2));
+            Real fac = qsat*L_v*L_v/(Cp_d*R_v*tabs*tabs);
 
             // If water vapor content exceeds saturation value, then vapor condenses to waterm and latent heat is released, increasing temperature
-            if(qv_array(i,j,k) > qsat){
-                dq_vapor_to_clwater = std::min(qv_array(i,j,k), (qv_array(i,j,k)-qsat)/(1.0 + fac));
+            if(qv > qsat){
+                dq_vapor_to_clwater = std::min(qv, (qv-qsat)/(1.0 + fac));
             }
 
 
             // If water vapor is less than the satruated value, then the cloud water can evaporate, leading to evaporative cooling and
             // reducing temperature
-            if(qv_array(i,j,k) < qsat and qn_array(i,j,k) > 0.0){
-                dq_clwater_to_vapor = std::min(qn_array(i,j,k), (qsat - qv_array(i,j,k))/(1.0 + fac));
+            if(qv < qsat and qn > 0.0){
+                dq_clwater_to_vapor = std::min(qn, (qsat - qv)/(1.0 + fac));
             }
 
-            if(qp_array(i,j,k) > 0.0 && qv_array(i,j,k) < qsat) {
-                Real C = 1.6 + 124.9*std::pow(0.001*rho_array(i,j,k)*qp_array(i,j,k),0.2046);
-                dq_rain_to_vapor = 1.0/(0.001*rho_array(i,j,k))*(1.0 - qv_array(i,j,k)/qsat)*C*std::pow(0.001*rho_array(i,j,k)*qp_array(i,j,k),0.525)/
+            if(qp > 0.0 && qv < qsat) {
+                Real C = 1.6 + 124.9*std::pow(0.001*rho*qp,0.2046);
+                dq_rain_to_vapor = 1.0/(0.001*rho)*(1.0 - qv/qsat)*C*std::pow(0.001*rho*qp,0.525)/
                     (5.4e5 + 2.55e6/(pressure*qsat))*dtn;
                 // The negative sign is to make this variable (vapor formed from evaporation)
                 // a poistive quantity (as qv/qs < 1)
-                dq_rain_to_vapor = std::min({qp_array(i,j,k), dq_rain_to_vapor});
+                dq_rain_to_vapor = std::min({qp, dq_rain_to_vapor});
 
                 // Removing latent heat due to evaporation from rain water to water vapor, reduces the (potential) temperature
             }
 
             // If there is cloud water present then do accretion and autoconversion to rain
 
-            if (qn_array(i,j,k) > 0.0) {
-                qcc = qn_array(i,j,k);
+            if (qn > 0.0) {
+                qcc = qn;
 
                 autor = 0.0;
                 if (qcc > qcw0) {
@@ -152,28 +236,28 @@ void Kessler::AdvanceKessler ()
                 }
 
                 accrr = 0.0;
-                accrr = 2.2 * std::pow(qp_array(i,j,k) , 0.875);
+                accrr = 2.2 * std::pow(qp , 0.875);
                 dq_clwater_to_rain = dtn *(accrr*qcc + autor*(qcc - 0.001));
 
                 // If the amount of change is more than the amount of qc present, then dq = qc
-                dq_clwater_to_rain = std::min(dq_clwater_to_rain, qn_array(i,j,k));
+                dq_clwater_to_rain = std::min(dq_clwater_to_rain, qn);
             }
 
-            if(std::fabs(fz_array(i,j,k+1)) < 1e-14) fz_array(i,j,k+1) = 0.0;
-            if(std::fabs(fz_array(i,j,k)) < 1e-14) fz_array(i,j,k) = 0.0;
-            Real dq_sed = 1.0/rho_array(i,j,k)*(fz_array(i,j,k+1) - fz_array(i,j,k))/dz*dtn;
-            if(std::fabs(dq_sed) < 1e-14)dq_sed = 0.0;
-            //dq_sed = 0.0;
+            qt = qt + dq_rain_to_vapor - dq_clwater_to_rain;
+            qp = qp + dq_clwater_to_rain - dq_rain_to_vapor;
+            qn = qn + dq_vapor_to_clwater - dq_clwater_to_vapor - dq_clwater_to_rain;
 
-            qt_array(i,j,k) = qt_array(i,j,k) + dq_rain_to_vapor - dq_clwater_to_rain;
-            qp_array(i,j,k) = qp_array(i,j,k) + dq_sed + dq_clwater_to_rain - dq_rain_to_vapor;
-            qn_array(i,j,k) = qn_array(i,j,k) + dq_vapor_to_clwater - dq_clwater_to_vapor - dq_clwater_to_rain;
+            theta = theta + theta/tabs*d_fac_cond*(dq_vapor_to_clwater - dq_clwater_to_vapor - dq_rain_to_vapor);
 
-            theta_array(i,j,k) = theta_array(i,j,k) + theta_array(i,j,k)/tabs_array(i,j,k)*d_fac_cond*(dq_vapor_to_clwater - dq_clwater_to_vapor - dq_rain_to_vapor);
+            qt = std::max(0.0, qt);
+            qp = std::max(0.0, qp);
+            qn = std::max(0.0, qn);
 
-            qt_array(i,j,k) = std::max(0.0, qt_array(i,j,k));
-            qp_array(i,j,k) = std::max(0.0, qp_array(i,j,k));
-            qn_array(i,j,k) = std::max(0.0, qn_array(i,j,k));
+            // qv is not modified by the conversions above (it is only reset for qt == 0)
+            states_array(i,j,k,RhoTheta_comp) = rho*theta;
+            states_array(i,j,k,RhoQ1_comp)    = rho*qv;
+            states_array(i,j,k,RhoQ2_comp)    = rho*qn;
+            states_array(i,j,k,RhoQ3_comp)    = rho*qp;
         });
     }
 }
@@ -2,11 +2,64 @@
 #include "Microphysics.H"
 #include "IndexDefines.H"
 #include "TileNoZ.H"
+#include "EOS.H"
 
 using namespace amrex;
 
+/**
+ * Flags the columns in which any stage of the advance can change the state: a
+ * cell is active if it holds (or has negative) cloud water, cloud ice or
+ * precipitation, has negative vapor, or if its total water is within a
+ * relative ActiveColumns::qsat_margin of the saturation mixing ratio used as
+ * the condensation test in Cloud. Inactive columns are skipped by Cloud,
+ * IceFall, Precip and PrecipFall, and only have their diagnostics refreshed
+ * in Update_State.
+ */
+void SAM::Compute_Active_Columns () {
+
+    constexpr Real an = 1.0/(tbgmax-tbgmin);
+    constexpr Real bn = tbgmin*an;
+
+    auto pres1d_t = pres1d.table();
+
+    auto qci = mic_fab_vars[MicVar::qci];
+
+    for ( MFIter mfi(*m_cons); mfi.isValid(); ++mfi) {
+        auto states_array = m_cons->const_array(mfi);
+        auto qci_array    = qci->const_array(mfi);
+
+        m_active.build(mfi, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            Real rho = states_array(i,j,k,Rho_comp);
+            Real qv  = states_array(i,j,k,RhoQ1_comp)/rho;
+            if (states_array(i,j,k,RhoQ2_comp) != 0.0 || states_array(i,j,k,RhoQ3_comp) != 0.0 ||
+                qci_array(i,j,k) != 0.0 || qv < 0.0) { return true; }
+
+            // Saturation mixing ratio of the first guess in Cloud (no precipitation)
+            Real tabs = getTgivenRandRTh(rho, states_array(i,j,k,RhoTheta_comp), qv);
+            Real qsatt;
+            if (tabs > tbgmax) {
+                erf_qsatw(tabs, pres1d_t(k), qsatt);
+            } else if (tabs <= tbgmin) {
+                erf_qsati(tabs, pres1d_t(k), qsatt);
+            } else {
+                Real om = an*tabs-bn;
+                Real qsatt1, qsatt2;
+                erf_qsatw(tabs, pres1d_t(k), qsatt1);
+                erf_qsati(tabs, pres1d_t(k), qsatt2);
+                qsatt = om*qsatt1 + (1.-om)*qsatt2;
+            }
+            return (qv > (1.0 - ActiveColumns::qsat_margin)*qsatt);
+        });
+    }
+}
+
 /**
  * Compute Cloud-related Microphysics quantities.
+ *
+ * The total water, precipitating water and temperature are evaluated from the
+ * conserved state (plus the cloud ice carried by the model) inside the kernel.
+ * Inactive boxes and columns are skipped.
  */
 void SAM::Cloud () {
 
@@ -20,24 +73,39 @@ void SAM::Cloud () {
     auto qt    = mic_fab_vars[MicVar::qt];
     auto qp    = mic_fab_vars[MicVar::qp];
     auto qn    = mic_fab_vars[MicVar::qn];
-    auto rho   = mic_fab_vars[MicVar::rho];
+    auto qcl   = mic_fab_vars[MicVar::qcl];
+    auto qci   = mic_fab_vars[MicVar::qci];
     auto tabs  = mic_fab_vars[MicVar::tabs];
 
     Real fac_cond = m_fac_cond;
     Real fac_sub  = m_fac_sub;
     Real fac_fus  = m_fac_fus;
 
-    for ( MFIter mfi(*tabs, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+    for ( MFIter mfi(*m_cons, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        if (!m_active.box_active(mfi)) { continue; }
+
+        auto states_array = m_cons->const_array(mfi);
+        auto mask         = m_active.const_array(mfi);
+
         auto qt_array    = qt->array(mfi);
         auto qp_array    = qp->array(mfi);
         auto qn_array    = qn->array(mfi);
+        auto qcl_array   = qcl->array(mfi);
+        auto qci_array   = qci->array(mfi);
         auto tabs_array  = tabs->array(mfi);
 
         const auto& box3d = mfi.tilebox() & m_gtoe[mfi.index()];
 
         ParallelFor(box3d, [=] AMREX_GPU_DEVICE (int i, int j, int k)
         {
-            qt_array(i,j,k) = std::max(0.0,qt_array(i,j,k));
+            if (!mask(i,j,0)) { return; }
+
+            Real rho = states_array(i,j,k,Rho_comp);
+            Real qv  = states_array(i,j,k,RhoQ1_comp)/rho;
+            qt_array(i,j,k)   = std::max(0.0, qv + states_array(i,j,k,RhoQ2_comp)/rho + qci_array(i,j,k));
+            qp_array(i,j,k)   = states_array(i,j,k,RhoQ3_comp)/rho;
+            tabs_array(i,j,k) = getTgivenRandRTh(rho, states_array(i,j,k,RhoTheta_comp), qv);
+
             // Initial guess for temperature assuming no cloud water/ice:
             Real tabs1 = tabs_array(i,j,k);
 
@@ -127,6 +195,11 @@ void SAM::Cloud () {
             }
             tabs_array(i,j,k) = tabs1;
             qp_array(i,j,k)   = std::max(0.0, qp_array(i,j,k)); // just in case
+
+            // Partition the condensate into cloud water and cloud ice
+            Real omn = std::max(0.0, std::min(1.0,(tabs1-tbgmin)*a_bg));
+            qcl_array(i,j,k) = qn_array(i,j,k)*omn;
+            qci_array(i,j,k) = qn_array(i,j,k)*(1.0-omn);
         });
     }
 }
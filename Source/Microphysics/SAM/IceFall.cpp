@@ -1,5 +1,4 @@
 
-#include <AMReX_ParReduce.H>
 #include "Microphysics.H"
 #include "TileNoZ.H"
 
@@ -7,6 +6,11 @@ using namespace amrex;
 
 /**
  * Computes contributions to Microphysics and thermodynamic variables from falling cloud ice in each column.
+ *
+ * Each column is handled by a single thread which first finds the vertical
+ * range containing cold cloud, then sweeps it once with the flux-limited ice
+ * fluxes kept in registers. Columns without cold cloud, including all
+ * inactive columns, are skipped.
  */
 void SAM::IceFall () {
 
@@ -14,80 +18,67 @@ void SAM::IceFall () {
     Real dtn = dt;
     int  nz  = nlev;
 
-    int kmax, kmin;
     auto qcl   = mic_fab_vars[MicVar::qcl];
     auto qci   = mic_fab_vars[MicVar::qci];
     auto qt    = mic_fab_vars[MicVar::qt];
     auto tabs  = mic_fab_vars[MicVar::tabs];
-    auto theta = mic_fab_vars[MicVar::theta];
-
-    MultiFab fz;
-    fz.define(qcl->boxArray(),qcl->DistributionMap(), 1, qcl->nGrowVect());
-    fz.setVal(0.);
 
     auto qifall_t = qifall.table();
     auto tlatqi_t = tlatqi.table();
     auto rho1d_t  = rho1d.table();
 
-    kmin = nz;
-    kmax = -1;
-
-    { // calculate maximum and minium ice fall vertical region
-        auto const& qcl_arrays  = qcl->const_arrays();
-        auto const& qci_arrays  = qci->const_arrays();
-        auto const& tabs_arrays = tabs->const_arrays();
-
-        GpuTuple<int, int> k_max_min = ParReduce(TypeList<ReduceOpMax, ReduceOpMin>{},
-                                                 TypeList<int, int>{},
-                                                 *qcl, IntVect::TheZeroVector(),
-                                                 [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k) noexcept
-                                                 -> GpuTuple<int, int>
-                                                 {
-                                                     bool is_positive       = qcl_arrays[box_no](i,j,k)+qci_arrays[box_no](i,j,k) > 0.0;
-                                                     bool smaller_than_zero = tabs_arrays[box_no](i,j,k) < 273.15;
-                                                     int mkmin = is_positive && smaller_than_zero ? k : nz-1;
-                                                     int mkmax = is_positive && smaller_than_zero ? k : 0;
-                                                     return {mkmax, mkmin};
-                                                 });
-        kmax = amrex::get<0>(k_max_min);
-        kmin = amrex::get<1>(k_max_min);
-    }
-
-//std::cout << "ice_fall: " << kmin << "; " << kmax << std::endl;
-
-    // for (int k=0; k<nzm; k++) {
-    //  for (int icrm=0; icrm<ncrms; icrm++) {
     amrex::ParallelFor(nz, [=] AMREX_GPU_DEVICE (int k)
     {
         qifall_t(k) = 0.0;
         tlatqi_t(k) = 0.0;
     });
 
-    //if(index_cloud_ice == -1) { return;}
+    Real fac_cond = m_fac_cond;
+    Real fac_fus  = m_fac_fus;
 
-    // for (int k=0; k<nzm; k++) {
-    //   for (int j=0; j<ny; j++) {
-    //     for (int i=0; i<nx; i++) {
-    //       for (int icrm=0; icrm<ncrms; icrm++) {
     for ( amrex::MFIter mfi(*tabs, TileNoZ()); mfi.isValid(); ++mfi) {
-        //auto qcl_array   = qcl->array(mfi);
-        auto qci_array   = qci->array(mfi);
-        auto qt_array    = qt->array(mfi);
-        //auto tabs_array  = tabs->array(mfi);
-        auto theta_array = theta->array(mfi);
-        auto fz_array    = fz.array(mfi);
+        if (!m_active.box_active(mfi)) { continue; }
+
+        auto mask         = m_active.const_array(mfi);
+        auto qcl_array    = qcl->const_array(mfi);
+        auto qci_array    = qci->const_array(mfi);
+        auto tabs_array   = tabs->const_array(mfi);
+        auto qt_array     = qt->array(mfi);
+        auto states_array = m_cons->array(mfi);
 
         const auto& box3d = mfi.tilebox();
+        const int klo = box3d.smallEnd(2);
+        const int khi = box3d.bigEnd(2);
+
+        Box box2d(box3d);
+        box2d.setRange(2,0);
 
-        amrex::ParallelFor(box3d, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
+        amrex::ParallelFor(box2d, [=] AMREX_GPU_DEVICE(int i, int j, int) noexcept
         {
-            if (k >= std::max(0,kmin-1) && k <= kmax ) {
-                // Set up indices for x-y planes above and below current plane.
-                int kc = std::min(k+1, nz-1);
-                int kb = std::max(k-1, 0);
+            if (!mask(i,j,0)) { return; }
+
+            // calculate maximum and minium ice fall vertical region
+            int kmin = khi+1;
+            int kmax = klo-1;
+            for (int k = klo; k <= khi; ++k) {
+                if (qcl_array(i,j,k)+qci_array(i,j,k) > 0.0 && tabs_array(i,j,k) < 273.15) {
+                    kmin = std::min(kmin, k);
+                    kmax = std::max(kmax, k);
+                }
+            }
+            if (kmax < kmin) { return; }
 
-                // CFL number based on grid spacing interpolated to interface i,j,k-1/2
-                Real coef = dtn/dz; //dtn/(0.5*(adz(kb)+adz(k))*dz);
+            // CFL number based on grid spacing interpolated to interface i,j,k-1/2
+            Real coef = dtn/dz; //dtn/(0.5*(adz(kb)+adz(k))*dz);
+
+            // Flux through the bottom face of cell k
+            auto ice_flux = [=] (int k) -> Real
+            {
+                if (k < std::max(klo,kmin-1) || k > kmax) { return 0.0; }
+
+                // Set up indices for x-y planes above and below current plane.
+                int kc = std::min(k+1, khi);
+                int kb = std::max(k-1, klo);
 
                 // Compute cloud ice density in this cell and the ones above/below.
                 // Since cloud ice is falling, the above cell is u(icrm,upwind),
@@ -115,33 +106,17 @@ void SAM::IceFall () {
                 // Compute limited flux.
                 // Since falling cloud ice is a 1D advection problem, this
                 // flux-limited advection scheme is monotonic.
-                fz_array(i,j,k) = -vt_ice*(qic - 0.5*(1.-coef*vt_ice)*tmp_phi*(qic-qid));
-            }
-        });
+                return -vt_ice*(qic - 0.5*(1.-coef*vt_ice)*tmp_phi*(qic-qid));
+            };
+
+            Real fz_k = ice_flux(std::max(klo,kmin-1));
+            for (int k = std::max(klo,kmin-1); k <= kmax; ++k) {
+                Real fz_kp = (k < khi) ? ice_flux(k+1) : 0.0;
 
-        // for (int j=0; j<ny; j++) {
-        //  for (int i=0; i<nx; i++) {
-        //    for (int icrm=0; icrm<ncrms; icrm++) {
-        /* by Xingqiu Yuan, need setup boundary condition for fz_t here???
-           amrex::ParallelFor(box2d, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-           fz_t(nz-1,j,i) = 0.0;
-           });
-        */
-
-        // for (int k=0; k<nzm; k++) {
-        //   for (int j=0; j<ny; j++) {
-        //     for (int i=0; i<nx; i++) {
-        //       for (int icrm=0; icrm<ncrms; icrm++) {
-        Real fac_cond = m_fac_cond;
-        Real fac_fus  = m_fac_fus;
-        amrex::ParallelFor(box3d, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
-        {
-            if ( k >= std::max(0,kmin-1) && k <= kmax ) {
-                Real coef = dtn/dz;
                 // The cloud ice increment is the difference of the fluxes.
-                Real dqi  = coef*(fz_array(i,j,k)-fz_array(i,j,k+1));
+                Real dqi  = coef*(fz_k-fz_kp);
                 // Add this increment to both non-precipitating and total water.
-                amrex::Gpu::Atomic::Add(&qt_array(i,j,k), dqi);
+                qt_array(i,j,k) += dqi;
                 // Include this effect in the total moisture budget.
                 amrex::Gpu::Atomic::Add(&qifall_t(k), dqi);
 
@@ -151,25 +126,12 @@ void SAM::IceFall () {
                 Real lat_heat = (fac_cond+fac_fus)*dqi;
 
                 // Add divergence of latent heat flux contribution to liquid-ice static potential temperature.
-                amrex::Gpu::Atomic::Add(&theta_array(i,j,k), -lat_heat);
+                states_array(i,j,k,RhoTheta_comp) -= states_array(i,j,k,Rho_comp)*lat_heat;
                 // Add divergence to liquid-ice static energy budget.
                 amrex::Gpu::Atomic::Add(&tlatqi_t(k), -lat_heat);
-            }
-        });
 
-#if 0
-        // for (int j=0; j<ny; j++) {
-        //    for (int i=0; i<nx; i++) {
-        //      for (int icrm=0; icrm<ncrms; icrm++) {
-        //parallel_for( SimpleBounds<3>(ny,nx,ncrms) , YAKL_LAMBDA (int j, int i, int icrm) {
-        amrex::ParallelFor(box2d, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
-        {
-            Real coef = dtn/dz;
-            Real dqi = -coef*fz(i,j,0);
-            precsfc (i,j) = precsfc (i,j)+dqi;
-            precssfc(i,j) = precssfc(i,j)+dqi;
+                fz_k = fz_kp;
+            }
         });
-#endif
     }
 }
-
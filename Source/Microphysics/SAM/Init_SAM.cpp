@@ -27,17 +27,19 @@ void SAM::Init (const MultiFab& cons_in,
     m_geom = geom;
     m_gtoe = grids;
 
-    MicVarMap.resize(m_qmoist_size);
-    MicVarMap = {MicVar::qt, MicVar::qv, MicVar::qcl, MicVar::qci,
-                 MicVar::qp, MicVar::qpl, MicVar::qpi, MicVar::qg};
+    // column activity mask, rebuilt in every advance
+    m_active.define(cons_in.boxArray(), cons_in.DistributionMap(), m_use_active_columns);
 
-    // initialize microphysics variables
+    // initialize diagnostic and work variables
     for (auto ivar = 0; ivar < MicVar::NumVars; ++ivar) {
         mic_fab_vars[ivar] = std::make_shared<MultiFab>(cons_in.boxArray(), cons_in.DistributionMap(),
                                                         1, cons_in.nGrowVect());
         mic_fab_vars[ivar]->setVal(0.);
     }
 
+    // column scratch for the precipitation fall (no ghost cells needed)
+    m_fall_scratch.define(cons_in.boxArray(), cons_in.DistributionMap(), FallScr::NumVars, 0);
+
     // Set class data members
     for ( MFIter mfi(cons_in, TileNoZ()); mfi.isValid(); ++mfi) {
         const auto& box3d = mfi.tilebox();
@@ -77,49 +79,6 @@ void SAM::Init (const MultiFab& cons_in,
 }
 
 
-/**
- * Initializes the Microphysics module.
- *
- * @param[in] cons_in Conserved variables input
- */
-void SAM::Copy_State_to_Micro (const MultiFab& cons_in)
-{
-    // Get the temperature, density, theta, qt and qp from input
-    for ( MFIter mfi(cons_in); mfi.isValid(); ++mfi) {
-        const auto& box3d = mfi.tilebox();
-
-        auto states_array = cons_in.array(mfi);
-
-        auto qv_array    = mic_fab_vars[MicVar_Kess::qv]->array(mfi);
-        auto qc_array    = mic_fab_vars[MicVar_Kess::qcl]->array(mfi);
-        auto qi_array    = mic_fab_vars[MicVar_Kess::qci]->array(mfi);
-        auto qn_array    = mic_fab_vars[MicVar_Kess::qn]->array(mfi);
-        auto qp_array    = mic_fab_vars[MicVar_Kess::qp]->array(mfi);
-
-        auto rho_array   = mic_fab_vars[MicVar_Kess::rho]->array(mfi);
-        auto theta_array = mic_fab_vars[MicVar_Kess::theta]->array(mfi);
-        auto tabs_array  = mic_fab_vars[MicVar::tabs]->array(mfi);
-        auto pres_array  = mic_fab_vars[MicVar::pres]->array(mfi);
-
-        // Get pressure, theta, temperature, density, and qt, qp
-        amrex::ParallelFor( box3d, [=] AMREX_GPU_DEVICE (int i, int j, int k)
-        {
-            rho_array(i,j,k)   = states_array(i,j,k,Rho_comp);
-            theta_array(i,j,k) = states_array(i,j,k,RhoTheta_comp)/states_array(i,j,k,Rho_comp);
-            qv_array(i,j,k)    = states_array(i,j,k,RhoQ1_comp)/states_array(i,j,k,Rho_comp);
-            qc_array(i,j,k)    = states_array(i,j,k,RhoQ2_comp)/states_array(i,j,k,Rho_comp);
-            qp_array(i,j,k)    = states_array(i,j,k,RhoQ3_comp)/states_array(i,j,k,Rho_comp);
-            qn_array(i,j,k)    = qc_array(i,j,k) + qi_array(i,j,k);
-
-            tabs_array(i,j,k)  = getTgivenRandRTh(states_array(i,j,k,Rho_comp),
-                                                  states_array(i,j,k,RhoTheta_comp),
-                                                  qv_array(i,j,k));
-            pres_array(i,j,k)  = getPgivenRTh(states_array(i,j,k,RhoTheta_comp), qv_array(i,j,k))/100.;
-        });
-    }
-}
-
-
 void SAM::Compute_Coefficients ()
 {
     auto dz   = m_geom.CellSize(2);
@@ -156,21 +115,22 @@ void SAM::Compute_Coefficients ()
     Real gamg2 = erf_gammafff((5.0+b_grau)/2.0);
     // Real gamg3 = erf_gammafff(4.0+b_grau      );
 
-    // calculate the plane average variables
-    PlaneAverage rho_ave(mic_fab_vars[MicVar::rho].get(), m_geom, m_axis);
-    PlaneAverage theta_ave(mic_fab_vars[MicVar::theta].get(), m_geom, m_axis);
-    PlaneAverage qv_ave(mic_fab_vars[MicVar::qv].get(), m_geom, m_axis);
-    rho_ave.compute_averages(ZDir(), rho_ave.field());
-    theta_ave.compute_averages(ZDir(), theta_ave.field());
-    qv_ave.compute_averages(ZDir(), qv_ave.field());
+    // calculate the plane averages of the conserved variables; theta and qv
+    // are recovered as density-weighted averages
+    PlaneAverage cons_ave(m_cons, m_geom, m_axis);
+    cons_ave.compute_averages(ZDir(), cons_ave.field());
 
-    // get host variable rho, and rhotheta
-    int ncell = rho_ave.ncell_line();
+    // get host variable rho, rhotheta and rhoqv
+    int ncell = cons_ave.ncell_line();
 
     Gpu::HostVector<Real> rho_h(ncell), theta_h(ncell), qv_h(ncell);
-    rho_ave.line_average(0, rho_h);
-    theta_ave.line_average(0, theta_h);
-    qv_ave.line_average(0, qv_h);
+    cons_ave.line_average(Rho_comp, rho_h);
+    cons_ave.line_average(RhoTheta_comp, theta_h);
+    cons_ave.line_average(RhoQ1_comp, qv_h);
+    for (int k = 0; k < ncell; ++k) {
+        theta_h[k] /= rho_h[k];
+        qv_h[k]    /= rho_h[k];
+    }
 
     // copy data to device
     Gpu::DeviceVector<Real> rho_d(ncell), theta_d(ncell), qv_d(ncell);
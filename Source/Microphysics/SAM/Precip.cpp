@@ -7,6 +7,9 @@ using namespace amrex;
 
 /**
  * Compute Precipitation-related Microphysics quantities.
+ *
+ * Inactive boxes and columns hold neither condensate nor precipitation and are
+ * skipped.
  */
 void SAM::Precip () {
 
@@ -40,6 +43,9 @@ void SAM::Precip () {
 
     // get the temperature, dentisy, theta, qt and qp from input
     for ( MFIter mfi(*tabs,TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        if (!m_active.box_active(mfi)) { continue; }
+
+        auto mask       = m_active.const_array(mfi);
         auto tabs_array = mic_fab_vars[MicVar::tabs]->array(mfi);
         auto qn_array   = mic_fab_vars[MicVar::qn]->array(mfi);
         auto qt_array   = mic_fab_vars[MicVar::qt]->array(mfi);
@@ -49,6 +55,8 @@ void SAM::Precip () {
 
         ParallelFor(box3d, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
         {
+            if (!mask(i,j,0)) { return; }
+
             //------- Autoconversion/accretion
             Real omn, omp, omg, qcc, qii, autor, autos, accrr, qrr, accrcs, accris,
                 qss, accrcg, accrig, tmp, qgg, dq, qsatt, qsat;
@@ -1,41 +1,75 @@
-
 #include "Microphysics.H"
 #include "IndexDefines.H"
 #include "TileNoZ.H"
 
 /**
- * Updates conserved and microphysics variables in the provided MultiFabs from
- * the internal MultiFabs that store Microphysics module data.
+ * Writes the water vapor, cloud water and precipitating water from the work
+ * variables back into the conserved variables, and refreshes the qmoist
+ * diagnostics (qv, qcl, qci, qpl, qpi, qg) in the same pass. The potential
+ * temperature has already been updated in place.
  *
- * @param[out] cons Conserved variables
- * @param[out] qmoist: qv, qc, qi, qr, qs, qg
+ * Inactive columns were not touched by the advance: their diagnostics are
+ * evaluated from the conserved state, which is left as is.
  */
-void SAM::Copy_Micro_to_State (amrex::MultiFab& cons)
+void SAM::Update_State ()
 {
-    // Get the temperature, density, theta, qt and qp from input
-    for ( amrex::MFIter mfi(cons,amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+    auto qt   = mic_fab_vars[MicVar::qt];
+    auto qp   = mic_fab_vars[MicVar::qp];
+    auto qv   = mic_fab_vars[MicVar::qv];
+    auto qn   = mic_fab_vars[MicVar::qn];
+    auto qcl  = mic_fab_vars[MicVar::qcl];
+    auto qci  = mic_fab_vars[MicVar::qci];
+    auto qpl  = mic_fab_vars[MicVar::qpl];
+    auto qpi  = mic_fab_vars[MicVar::qpi];
+    auto qg   = mic_fab_vars[MicVar::qg];
+    auto tabs = mic_fab_vars[MicVar::tabs];
+
+    for ( amrex::MFIter mfi(*m_cons,amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
         const auto& box3d = mfi.tilebox();
 
-        auto states_arr = cons.array(mfi);
+        auto states_arr = m_cons->array(mfi);
+        auto mask       = m_active.const_array(mfi);
 
-        auto rho_arr    = mic_fab_vars[MicVar_Kess::rho]->array(mfi);
-        auto theta_arr  = mic_fab_vars[MicVar_Kess::theta]->array(mfi);
-        auto qv_arr     = mic_fab_vars[MicVar_Kess::qv]->array(mfi);
-        auto qc_arr     = mic_fab_vars[MicVar_Kess::qcl]->array(mfi);
-        auto qp_arr     = mic_fab_vars[MicVar_Kess::qp]->array(mfi);
+        auto qt_arr   = qt->array(mfi);
+        auto qp_arr   = qp->array(mfi);
+        auto qn_arr   = qn->const_array(mfi);
+        auto tabs_arr = tabs->const_array(mfi);
+        auto qv_arr   = qv->array(mfi);
+        auto qcl_arr  = qcl->array(mfi);
+        auto qci_arr  = qci->array(mfi);
+        auto qpl_arr  = qpl->array(mfi);
+        auto qpi_arr  = qpi->array(mfi);
+        auto qg_arr   = qg->array(mfi);
 
-        // get potential total density, temperature, qt, qp
         amrex::ParallelFor( box3d, [=] AMREX_GPU_DEVICE (int i, int j, int k)
         {
-            states_arr(i,j,k,RhoTheta_comp) = rho_arr(i,j,k)*theta_arr(i,j,k);
-            states_arr(i,j,k,RhoQ1_comp)    = rho_arr(i,j,k)*qv_arr(i,j,k);
-            states_arr(i,j,k,RhoQ2_comp)    = rho_arr(i,j,k)*qc_arr(i,j,k);
-            states_arr(i,j,k,RhoQ3_comp)    = rho_arr(i,j,k)*qp_arr(i,j,k);
-        });
-    }
+            amrex::Real rho = states_arr(i,j,k,Rho_comp);
 
-    // Fill interior ghost cells and periodic boundaries
-    cons.FillBoundary(m_geom.periodicity());
-}
+            // No condensate or precipitation: all the water is vapor
+            if (!mask(i,j,0)) {
+                qt_arr(i,j,k)  = states_arr(i,j,k,RhoQ1_comp)/rho;
+                qv_arr(i,j,k)  = qt_arr(i,j,k);
+                qcl_arr(i,j,k) = 0.0;
+                qci_arr(i,j,k) = 0.0;
+                qp_arr(i,j,k)  = 0.0;
+                qpl_arr(i,j,k) = 0.0;
+                qpi_arr(i,j,k) = 0.0;
+                qg_arr(i,j,k)  = 0.0;
+                return;
+            }
 
+            qv_arr(i,j,k)   = std::max(0.0, qt_arr(i,j,k) - qn_arr(i,j,k));
+            amrex::Real omn = std::max(0.0, std::min(1.0,(tabs_arr(i,j,k)-tbgmin)*a_bg));
+            qcl_arr(i,j,k)  = qn_arr(i,j,k)*omn;
+            qci_arr(i,j,k)  = qn_arr(i,j,k)*(1.0-omn);
+            amrex::Real omp = std::max(0.0, std::min(1.0,(tabs_arr(i,j,k)-tprmin)*a_pr));
+            qpl_arr(i,j,k)  = qp_arr(i,j,k)*omp;
+            qpi_arr(i,j,k)  = qp_arr(i,j,k)*(1.0-omp);
+            qg_arr(i,j,k)   = std::max(0.0, qp_arr(i,j,k)-qpl_arr(i,j,k)-qpi_arr(i,j,k));
 
+            states_arr(i,j,k,RhoQ1_comp) = rho*qv_arr(i,j,k);
+            states_arr(i,j,k,RhoQ2_comp) = rho*qcl_arr(i,j,k);
+            states_arr(i,j,k,RhoQ3_comp) = rho*qp_arr(i,j,k);
+        });
+    }
+}
@@ -6,16 +6,38 @@
 #include "Ebert_curry.H"
 #include "Rad_constants.H"
 #include "AMReX_Random.H"
+#include "AMReX_ParmParse.H"
 using yakl::fortran::parallel_for;
 using yakl::fortran::SimpleBounds;
 
 void Optics::initialize(int ngas, int nmodes, int num_aeros,
                         int nswbands, int nlwbands,
+                        int nswgpts, int nlwgpts,
                         int ncol, int nlev, int nrh, int top_lev,
                         const std::vector<std::string>& aero_names,
                         const real2d& zi, const real2d& pmid, const real2d& temp,
                         const real2d& qi, const real2d& geom_radius) {
-   cloud_optics.initialize();
+   // The cloud optics tables do not depend on the grids
+   if (!cloud_optics_loaded) {
+      cloud_optics.initialize();
+      cloud_optics_loaded = true;
+   }
+
+   // Ice and liquid cloud optics schemes
+   icecldoptics = "mitchell";
+   liqcldoptics = "gammadist";
+   amrex::ParmParse pp("erf");
+   pp.query("rad_ice_optics", icecldoptics);
+   pp.query("rad_liq_optics", liqcldoptics);
+   if (icecldoptics != "mitchell" && icecldoptics != "ebertcurry") {
+      amrex::Abort("erf.rad_ice_optics must be mitchell or ebertcurry");
+   }
+   if (liqcldoptics != "gammadist" && liqcldoptics != "slingo") {
+      amrex::Abort("erf.rad_liq_optics must be gammadist or slingo");
+   }
+
+   iscloudy_sw = bool3d("iscloudy_sw", nswgpts, ncol, nlev);
+   iscloudy_lw = bool3d("iscloudy_lw", nlwgpts, ncol, nlev);
    aero_optics.initialize(ngas, nmodes, num_aeros,
                           nswbands, nlwbands, ncol, nlev, nrh, top_lev,
                           aero_names, zi, pmid, temp, qi, geom_radius);
@@ -26,320 +48,222 @@ void Optics::finalize() {
 }
 
 
-void Optics::get_cloud_optics_sw(int ncol, int nlev, int nbnd,
+void Optics::get_cloud_optics_sw(int ncol, int nlev, int nbnd, int ngpt,
+         const int1d& gpt2bnd, const int1d& bnd_map,
          bool do_snow, const real2d& cld, const real2d& cldfsnow, const real2d& iclwp,
          const real2d& iciwp, const real2d& icswp, const real2d& lambdac, const real2d& mu,
          const real2d& dei, const real2d& des, const real2d& rel, const real2d& rei,
-         const real3d& tau_out, const real3d& ssa_out, const real3d& asm_out,
-         const real3d& liq_tau_out, const real3d& ice_tau_out, const real3d& snw_tau_out) {
-      //Temporary variables to hold cloud optical properties before combining into
-      // output arrays. Same shape as output arrays, so get shapes from output.
-      real3d liq_tau("liq_tau",nbnd, ncol, nlev);
-      real3d liq_tau_ssa("liq_tau_ssa",nbnd, ncol, nlev);
-      real3d liq_tau_ssa_g("liq_tau_ssa_g", nbnd, ncol, nlev);
-      real3d liq_tau_ssa_f("liq_tau_ssa_f", nbnd, ncol, nlev);
-      real3d ice_tau("ice_tau", nbnd, ncol, nlev);
-      real3d ice_tau_ssa("ice_tau_ssa", nbnd, ncol, nlev);
-      real3d ice_tau_ssa_g("ice_tau_ssa_g", nbnd, ncol, nlev);
-      real3d ice_tau_ssa_f("ice_tau_ssa_f", nbnd, ncol, nlev);
-      real3d cld_tau("cld_tau", nbnd, ncol, nlev);
-      real3d cld_tau_ssa("cld_tau_ssa", nbnd, ncol, nlev);
-      real3d cld_tau_ssa_g("cld_tau_ssa_g", nbnd, ncol, nlev);
-      real3d cld_tau_ssa_f("cld_tau_ssa_f", nbnd, ncol, nlev);
-      real3d snow_tau("snow_tau", nbnd, ncol, nlev );
-      real3d snow_tau_ssa("snow_tau_ssa", nbnd, ncol, nlev);
-      real3d snow_tau_ssa_g("snow_tau_ssa_g", nbnd, ncol, nlev);
-      real3d snow_tau_ssa_f("snow_tau_ssa_f", nbnd, ncol, nlev);
-      real3d combined_tau("combined_tau", nbnd, ncol, nlev);
-      real3d combined_tau_ssa("combined_tau_ssa", nbnd, ncol, nlev);
-      real3d combined_tau_ssa_g("combined_tau_ssa_g", nbnd, ncol, nlev);
-      real3d combined_tau_ssa_f("combined_tau_ssa_f", nbnd, ncol, nlev);
-
-      // Initialize outputs
-      yakl::memset(tau_out, 0.);
-      yakl::memset(ssa_out, 0.);
-      yakl::memset(asm_out, 0.);
-      yakl::memset(liq_tau_out, 0.);
-      yakl::memset(ice_tau_out, 0.);
-      yakl::memset(snw_tau_out, 0.);
-
-      // Initialize local variables
-      yakl::memset(ice_tau, 0.);
-      yakl::memset(ice_tau_ssa, 0.);
-      yakl::memset(ice_tau_ssa_g, 0.);
-      yakl::memset(ice_tau_ssa_f, 0.);
-      yakl::memset(liq_tau, 0.);
-      yakl::memset(liq_tau_ssa, 0.);
-      yakl::memset(liq_tau_ssa_g, 0.);
-      yakl::memset(liq_tau_ssa_f, 0.);
-      yakl::memset(snow_tau, 0.);
-      yakl::memset(snow_tau_ssa, 0.);
-      yakl::memset(snow_tau_ssa_g, 0.);
-      yakl::memset(snow_tau_ssa_f, 0.);
-      yakl::memset(combined_tau, 0.);
-      yakl::memset(combined_tau_ssa, 0.);
-      yakl::memset(combined_tau_ssa_g, 0.);
-      yakl::memset(combined_tau_ssa_f, 0.);
-
-      // Get ice cloud optics
-      if (icecldoptics == "mitchell") {
-         cloud_optics.mitchell_ice_optics_sw(
-            ncol, nlev, iciwp, dei,
-            ice_tau, ice_tau_ssa,
-            ice_tau_ssa_g, ice_tau_ssa_f);
+         const real3d& tau_gpt, const real3d& ssa_gpt, const real3d& asm_gpt,
+         bool do_diag, const real3d& liq_tau_out, const real3d& ice_tau_out, const real3d& snw_tau_out) {
+      // The tabulated schemes are evaluated in the kernel below; the
+      // parameterized ones still fill band arrays that the kernel reads
+      const bool liq_tab = (liqcldoptics == "gammadist");
+      const bool ice_tab = (icecldoptics == "mitchell");
+      real3d liq_tau, liq_tau_ssa, liq_tau_ssa_g, liq_tau_ssa_f;
+      real3d ice_tau, ice_tau_ssa, ice_tau_ssa_g, ice_tau_ssa_f;
+      if (!liq_tab) {
+         liq_tau       = real3d("liq_tau", nbnd, ncol, nlev);
+         liq_tau_ssa   = real3d("liq_tau_ssa", nbnd, ncol, nlev);
+         liq_tau_ssa_g = real3d("liq_tau_ssa_g", nbnd, ncol, nlev);
+         liq_tau_ssa_f = real3d("liq_tau_ssa_f", nbnd, ncol, nlev);
+         Slingo::slingo_liq_optics_sw(ncol, nlev, nbnd, cld, iclwp, rel,
+                                      liq_tau, liq_tau_ssa, liq_tau_ssa_g, liq_tau_ssa_f);
       }
-      else if (icecldoptics == "ebertcurry") {
-         EbertCurry::ec_ice_optics_sw(ncol, nlev, nbnd, cld, iciwp,
-                                     rei, ice_tau, ice_tau_ssa,
-                                     ice_tau_ssa_g, ice_tau_ssa_f);
+      if (!ice_tab) {
+         ice_tau       = real3d("ice_tau", nbnd, ncol, nlev);
+         ice_tau_ssa   = real3d("ice_tau_ssa", nbnd, ncol, nlev);
+         ice_tau_ssa_g = real3d("ice_tau_ssa_g", nbnd, ncol, nlev);
+         ice_tau_ssa_f = real3d("ice_tau_ssa_f", nbnd, ncol, nlev);
+         EbertCurry::ec_ice_optics_sw(ncol, nlev, nbnd, cld, iciwp, rei,
+                                      ice_tau, ice_tau_ssa, ice_tau_ssa_g, ice_tau_ssa_f);
       }
 
-      // Get liquid cloud optics
-      if (liqcldoptics == "gammadist") {
-         cloud_optics.gammadist_liq_optics_sw(
-            ncol, nlev, iclwp, lambdac, mu,
-            liq_tau, liq_tau_ssa,
-            liq_tau_ssa_g, liq_tau_ssa_f);
-      }
-      else if (liqcldoptics == "slingo") {
-         Slingo::slingo_liq_optics_sw(
-            ncol, nlev, nbnd, cld, iclwp, rel,
-            liq_tau, liq_tau_ssa,
-            liq_tau_ssa_g, liq_tau_ssa_f);
-      }
+      // Stochastic subcolumn cloud mask of the g-points
+      auto iscloudy = iscloudy_sw;
+      mcica_subcol_mask(ngpt, ncol, nlev, cld, cldfsnow, iscloudy);
 
-      // Get snow cloud optics
-      if (do_snow) {
-         cloud_optics.mitchell_ice_optics_sw(
-            ncol, nlev, icswp, des,
-            snow_tau, snow_tau_ssa,
-            snow_tau_ssa_g, snow_tau_ssa_f);
-      }
-      else {
-         // We are not doing snow optics, so set these to zero so we can still use
-         // the arrays without additional logic
-         yakl::memset(snow_tau, 0.);
-         yakl::memset(snow_tau_ssa, 0.);
-         yakl::memset(snow_tau_ssa_g, 0.);
-         yakl::memset(snow_tau_ssa_f, 0.);
-      }
+      auto t = cloud_optics.tables();
 
-      // Combine all cloud optics from CAM routines
-      parallel_for(SimpleBounds<3>(nbnd, ncol, nlev), YAKL_LAMBDA (int ibnd, int icol, int ilev) {
-         cld_tau(ibnd, icol, ilev) = ice_tau(ibnd, icol, ilev) + liq_tau(ibnd, icol, ilev);
-         cld_tau_ssa(ibnd, icol, ilev) = ice_tau_ssa(ibnd, icol, ilev) + liq_tau_ssa(ibnd, icol, ilev);
-         cld_tau_ssa_g(ibnd, icol, ilev) = ice_tau_ssa_g(ibnd, icol, ilev) + liq_tau_ssa_g(ibnd, icol, ilev);
+      parallel_for(SimpleBounds<2>(ncol, nlev), YAKL_LAMBDA (int icol, int ilev) {
+         // Table interpolation weights of the liquid, ice and snow in this cell
+         const bool has_liq = liq_tab && lambdac(icol,ilev) > 0. && iclwp(icol,ilev) >= 1.e-80;
+         const bool has_ice = ice_tab && iciwp(icol,ilev) >= 1.e-80 && dei(icol,ilev) != 0.;
+         const bool has_snw = do_snow && icswp(icol,ilev) >= 1.e-80 && des(icol,ilev) != 0.;
+         int  jmu = 1, jl = 1, jd = 1, js = 1;
+         real wmu = 1., wl = 1., wd = 1., ws = 1.;
+         if (has_liq) CloudRadProps::gamma_weights(t, lambdac(icol,ilev), mu(icol,ilev), jmu, wmu, jl, wl);
+         if (has_ice) CloudRadProps::interp_weight(t.g_d_eff, t.n_g_d, dei(icol,ilev), jd, wd);
+         if (has_snw) CloudRadProps::interp_weight(t.g_d_eff, t.n_g_d, des(icol,ilev), js, ws);
+
+         const real fcld  = cld(icol,ilev);
+         const real fsnw  = cldfsnow(icol,ilev);
+         const real fcomb = std::max(fcld, fsnw);
+
+         // The g-points of a band are contiguous, so the band properties are
+         // computed once per band
+         int  ib_cur = 0;
+         real tau = 0., ssa = 1., asm_p = 0.;
+         for (int igpt = 1; igpt <= ngpt; ++igpt) {
+            const int ib = gpt2bnd(igpt);
+            if (ib != ib_cur) {
+               ib_cur = ib;
+               const int tb = bnd_map(ib);
+
+               // optical depth and its products with the single scattering
+               // albedo and the asymmetry parameter
+               real l_tau = 0., l_tw = 0., l_twg = 0.;
+               if (has_liq) {
+                  l_tau = iclwp(icol,ilev) * CloudRadProps::liq_value(t.ext_sw_liq, tb, jmu, wmu, jl, wl);
+                  l_tw  = l_tau * CloudRadProps::liq_value(t.ssa_sw_liq, tb, jmu, wmu, jl, wl);
+                  l_twg = l_tw  * CloudRadProps::liq_value(t.asm_sw_liq, tb, jmu, wmu, jl, wl);
+               } else if (!liq_tab) {
+                  l_tau = liq_tau(tb,icol,ilev);
+                  l_tw  = liq_tau_ssa(tb,icol,ilev);
+                  l_twg = liq_tau_ssa_g(tb,icol,ilev);
+               }
+
+               real i_tau = 0., i_tw = 0., i_twg = 0.;
+               if (has_ice) {
+                  i_tau = iciwp(icol,ilev) * CloudRadProps::ice_value(t.ext_sw_ice, tb, jd, wd);
+                  i_tw  = i_tau * CloudRadProps::ice_value(t.ssa_sw_ice, tb, jd, wd);
+                  i_twg = i_tw  * CloudRadProps::ice_value(t.asm_sw_ice, tb, jd, wd);
+               } else if (!ice_tab) {
+                  i_tau = ice_tau(tb,icol,ilev);
+                  i_tw  = ice_tau_ssa(tb,icol,ilev);
+                  i_twg = ice_tau_ssa_g(tb,icol,ilev);
+               }
+
+               real s_tau = 0., s_tw = 0., s_twg = 0.;
+               if (has_snw) {
+                  s_tau = icswp(icol,ilev) * CloudRadProps::ice_value(t.ext_sw_ice, tb, js, ws);
+                  s_tw  = s_tau * CloudRadProps::ice_value(t.ssa_sw_ice, tb, js, ws);
+                  s_twg = s_tw  * CloudRadProps::ice_value(t.asm_sw_ice, tb, js, ws);
+               }
+
+               // Combine cloud and snow, weighted by their fractions
+               real c_tau = l_tau + i_tau;
+               real c_tw  = l_tw  + i_tw;
+               real c_twg = l_twg + i_twg;
+               if (do_snow) {
+                  if (fcomb > 0.) {
+                     c_tau = (fcld*c_tau + fsnw*s_tau) / fcomb;
+                     c_tw  = (fcld*c_tw  + fsnw*s_tw ) / fcomb;
+                     c_twg = (fcld*c_twg + fsnw*s_twg) / fcomb;
+                  } else {
+                     c_tau = 0.; c_tw = 0.; c_twg = 0.;
+                  }
+               }
+
+               // Convert the products to single scattering albedo and
+               // asymmetry parameter, without dividing by zero
+               tau   = c_tau;
+               ssa   = (c_tau > 0.) ? c_tw/c_tau : 1.;
+               asm_p = (c_tw  > 0.) ? c_twg/c_tw : 0.;
+
+               if (do_diag) {
+                  liq_tau_out(icol,ilev,tb) = l_tau;
+                  ice_tau_out(icol,ilev,tb) = i_tau;
+                  snw_tau_out(icol,ilev,tb) = s_tau;
+               }
+            }
+
+            // MCICA: homogeneous clouds in the cloudy subcolumns
+            if (iscloudy(igpt,icol,ilev) && fcomb > 0.) {
+               tau_gpt(icol,ilev,igpt) = tau;
+               ssa_gpt(icol,ilev,igpt) = ssa;
+               asm_gpt(icol,ilev,igpt) = asm_p;
+            } else {
+               tau_gpt(icol,ilev,igpt) = 0.;
+               ssa_gpt(icol,ilev,igpt) = 1.;
+               asm_gpt(icol,ilev,igpt) = 0.;
+            }
+         }
       });
-
-      if (do_snow) {
-         combine_properties( nbnd, ncol, nlev,
-            cld, cld_tau, cldfsnow, snow_tau, combined_tau);
-
-         combine_properties( nbnd, ncol, nlev,
-            cld, cld_tau_ssa, cldfsnow, snow_tau_ssa, combined_tau_ssa);
-
-         combine_properties( nbnd, ncol, nlev,
-            cld, cld_tau_ssa_g, cldfsnow, snow_tau_ssa_g, combined_tau_ssa_g);
-      }
-      else {
-        parallel_for(SimpleBounds<3>(nbnd, ncol, nlev), YAKL_LAMBDA (int ibnd, int icol, int ilev) {
-           combined_tau(ibnd, icol, ilev) = cld_tau(ibnd, icol, ilev);
-           combined_tau_ssa(ibnd, icol, ilev) = cld_tau_ssa(ibnd, icol, ilev);
-           combined_tau_ssa_g(ibnd, icol, ilev) = cld_tau_ssa_g(ibnd, icol, ilev);
-        });
-      }
-
-      // Copy to output arrays, converting to optical depth, single scattering
-      // albedo, and assymmetry parameter from the products that the CAM routines
-      // return. Make sure we do not try to divide by zero...
-      parallel_for(SimpleBounds<3>(nbnd, ncol, nlev), YAKL_LAMBDA (int iband, int icol, int ilev) {
-          tau_out(icol,ilev,iband) = combined_tau(iband,icol,ilev);
-          if (combined_tau(iband,icol,ilev) > 0) {
-             ssa_out(icol,ilev,iband)
-                 = combined_tau_ssa(iband,icol,ilev) / combined_tau(iband,icol,ilev);
-          } else {
-             ssa_out(icol,ilev,iband) = 1.;
-          }
-
-          if (combined_tau_ssa(iband,icol,ilev) > 0) {
-             asm_out(icol,ilev,iband)
-                 = combined_tau_ssa_g(iband,icol,ilev) / combined_tau_ssa(iband,icol,ilev);
-          } else {
-             asm_out(icol,ilev,iband) = 0.;
-          }
-
-          // Re-order diagnostics outputs
-          liq_tau_out(icol,ilev,iband) = liq_tau(iband,icol,ilev);
-          ice_tau_out(icol,ilev,iband) = ice_tau(iband,icol,ilev);
-          snw_tau_out(icol,ilev,iband) = snow_tau(iband,icol,ilev);
-     });
  }
 
    //----------------------------------------------------------------------------
-void Optics::get_cloud_optics_lw(
-         int ncol, int nlev, int nbnd, bool do_snow, const real2d& cld, const real2d& cldfsnow, const real2d& iclwp,
-         const real2d& iciwp, const real2d& icswp, const real2d& lambdac, const real2d& mu, const real2d& dei, const real2d& des,
-         const real2d& rei, const real3d& tau_out, const real3d& liq_tau_out, const real3d& ice_tau_out, const real3d& snw_tau_out) {
-      // Temporary variables to hold absorption optical depth
-      real3d ice_tau("ice_tau", nbnd, ncol, nlev);
-      real3d liq_tau("liq_tau", nbnd, ncol, nlev);
-      real3d snow_tau("snow_tau", nbnd, ncol, nlev);
-      real3d cld_tau("cld_tau", nbnd, ncol, nlev);
-      real3d combined_tau("combined_tau", nbnd, ncol, nlev);
-
-      // Initialize outputs
-      yakl::memset(tau_out, 0.);
-      yakl::memset(liq_tau_out, 0.);
-      yakl::memset(ice_tau_out, 0.);
-      yakl::memset(snw_tau_out, 0.);
-
-      // Initialize local variables
-      yakl::memset(ice_tau, 0.);
-      yakl::memset(liq_tau, 0.);
-      yakl::memset(snow_tau, 0.);
-      yakl::memset(cld_tau, 0.);
-      yakl::memset(combined_tau, 0.);
-
-      // Get ice optics
-      if (icecldoptics == "mitchell") {
-         cloud_optics.mitchell_ice_optics_lw(ncol, nlev, iciwp, dei, ice_tau);
-      }
-      else if (icecldoptics == "ebertcurry") {
-         EbertCurry::ec_ice_optics_lw(ncol, nlev, nbnd, cld, iclwp, iciwp, rei, ice_tau);
-      }
-
-      // Get liquid optics
-      if (liqcldoptics == "gammadist") {
-         cloud_optics.gammadist_liq_optics_lw(ncol, nlev, iclwp, lambdac, mu, liq_tau);
-      }
-      else if (liqcldoptics == "slingo") {
+void Optics::get_cloud_optics_lw(int ncol, int nlev, int nbnd, int ngpt, const int1d& gpt2bnd,
+         bool do_snow, const real2d& cld, const real2d& cldfsnow, const real2d& iclwp,
+         const real2d& iciwp, const real2d& icswp, const real2d& lambdac, const real2d& mu,
+         const real2d& dei, const real2d& des, const real2d& rei, const real3d& tau_gpt,
+         bool do_diag, const real3d& liq_tau_out, const real3d& ice_tau_out, const real3d& snw_tau_out) {
+      // Absorption optical depth of the parameterized schemes, by band
+      const bool liq_tab = (liqcldoptics == "gammadist");
+      const bool ice_tab = (icecldoptics == "mitchell");
+      real3d liq_tau, ice_tau;
+      if (!liq_tab) {
+         liq_tau = real3d("liq_tau", nbnd, ncol, nlev);
          Slingo::slingo_liq_optics_lw(ncol, nlev, nbnd, cld, iclwp, iciwp, liq_tau);
       }
-
-      // Combined cloud optics
-      parallel_for(SimpleBounds<3>(nbnd, ncol, nlev), YAKL_LAMBDA (int ibnd, int icol, int ilev) {
-          cld_tau(ibnd, icol, ilev) = liq_tau(ibnd, icol, ilev) + ice_tau(ibnd, icol, ilev);
-       });
-
-      // Get snow optics?
-      if (do_snow) {
-         cloud_optics.mitchell_ice_optics_lw(ncol, nlev, icswp, des, snow_tau);
-         combine_properties(nbnd, ncol, nlev,
-                            cld, cld_tau, cldfsnow, snow_tau, combined_tau);
-      }
-      else {
-         parallel_for(SimpleBounds<3>(nbnd, ncol, nlev), YAKL_LAMBDA (int ibnd, int icol, int ilev) {
-            combined_tau(ibnd,icol,ilev) = cld_tau(ibnd,icol,ilev);
-         });
+      if (!ice_tab) {
+         ice_tau = real3d("ice_tau", nbnd, ncol, nlev);
+         EbertCurry::ec_ice_optics_lw(ncol, nlev, nbnd, cld, iclwp, iciwp, rei, ice_tau);
       }
 
-      // Set output optics
-      parallel_for(SimpleBounds<3>(nbnd, ncol, nlev), YAKL_LAMBDA (int ibnd, int icol, int ilev) {
-         tau_out(icol,ilev,ibnd) = combined_tau(ibnd,icol,ilev);
-         liq_tau_out(icol,ilev,ibnd) = liq_tau(ibnd,icol,ilev);
-         ice_tau_out(icol,ilev,ibnd) = ice_tau(ibnd,icol,ilev);
-         snw_tau_out(icol,ilev,ibnd) = snow_tau(ibnd,icol,ilev);
-     });
-  }
-
-//----------------------------------------------------------------------------
-// Provide a procedure to combine cloud optical properties by weighting
-// contributions by fraction present. I.e., for combining cloud and snow
-// optical properties, we weight the cloud and snow properties by the fraction
-// of cloud and snow present.
-void Optics::combine_properties(int nbands, int ncols, int nlevs,
-                                const real2d& fraction1, const real3d& property1,
-                                const real2d& fraction2, const real3d& property2,
-                                const real3d& combined_property) {
-      // Combined fraction (max of property 1 and 2)
-      real2d combined_fraction("combined_fraction", ncols,nlevs);
-
-      // Combined fraction
-      parallel_for(SimpleBounds<2>(ncols, nlevs), YAKL_LAMBDA (int icol, int ilev) {
-         combined_fraction(icol, ilev) = std::max(fraction1(icol, ilev), fraction2(icol, ilev));
-      });
-
-      // Combine optical properties by weighting by amount of cloud and snow
-      yakl::memset(combined_property, 0.);
-      parallel_for(SimpleBounds<3>(nlevs, ncols, nbands), YAKL_LAMBDA (int ilev, int icol, int iband) {
-         if (combined_fraction(icol,ilev) > 0) {
-              combined_property(iband,icol,ilev) = (
-                fraction1(icol,ilev) * property1(iband,icol,ilev)
-                + fraction2(icol,ilev) * property2(iband,icol,ilev)
-              ) / combined_fraction(icol,ilev);
-         }
-     });
-}
-
-//----------------------------------------------------------------------------
-// Do MCICA sampling of optics here. This will map bands to gpoints,
-// while doing stochastic sampling of cloud state
-void Optics::sample_cloud_optics_sw(
-         int ncol, int nlev, int ngpt, const int1d& gpt2bnd,
-         const real2d& pmid, const real2d& cld, const real2d& cldfsnow,
-         const real3d& tau_bnd, const real3d& ssa_bnd, const real3d& asm_bnd,
-         const real3d& tau_gpt, const real3d& ssa_gpt, const real3d& asm_gpt) {
-
-      //real(r8), dimension(ncol,nlev) :: combined_cld
-      real2d combined_cld("combined_cld", ncol, nlev);
+      // Stochastic subcolumn cloud mask of the g-points
+      auto iscloudy = iscloudy_lw;
+      mcica_subcol_mask(ngpt, ncol, nlev, cld, cldfsnow, iscloudy);
 
-      //logical, dimension(ngpt,ncol,nlev) :: iscloudy
-      bool3d iscloudy("iscloudy", ngpt, ncol, nlev);
+      auto t = cloud_optics.tables();
 
-      // Combined snow and cloud fraction
       parallel_for(SimpleBounds<2>(ncol, nlev), YAKL_LAMBDA (int icol, int ilev) {
-          combined_cld(icol,ilev) = std::max(cld(icol,ilev), cldfsnow(icol,ilev));
-      });
-
-      // Get stochastic subcolumn cloud mask
-      mcica_subcol_mask(ngpt, ncol, nlev, combined_cld, iscloudy);
-
-      // Generate subcolumns for homogeneous clouds
-      parallel_for(SimpleBounds<3>(ngpt, nlev, ncol), YAKL_LAMBDA (int igpt, int ilev, int icol) {
-        if (iscloudy(igpt,icol,ilev) && combined_cld(icol,ilev) > 0.) {
-           tau_gpt(icol,ilev,igpt) = tau_bnd(icol,ilev,gpt2bnd(igpt));
-           ssa_gpt(icol,ilev,igpt) = ssa_bnd(icol,ilev,gpt2bnd(igpt));
-           asm_gpt(icol,ilev,igpt) = asm_bnd(icol,ilev,gpt2bnd(igpt));
-        } else {
-           tau_gpt(icol,ilev,igpt) = 0.;
-           ssa_gpt(icol,ilev,igpt) = 1.;
-           asm_gpt(icol,ilev,igpt) = 0.;
-        }
-     });
- }
-
-//----------------------------------------------------------------------------
-// Do MCICA sampling of optics here. This will map bands to gpoints,
-// while doing stochastic sampling of cloud state
-void Optics::sample_cloud_optics_lw(int ncol, int nlev, int ngpt, const int1d& gpt2bnd,
-                                    const real2d& pmid, const real2d& cld, const real2d& cldfsnow,
-                                    const real3d& tau_bnd, const real3d& tau_gpt) {
-      //real(r8), dimension(ncol,nlev) :: combined_cld
-      real2d combined_cld("combined_cld", ncol, nlev);
-
-      //logical, dimension(ngpt,ncol,nlev) :: iscloudy
-      bool3d iscloudy("iscloudy", ngpt, ncol, nlev);
-
-      // Combine cloud and snow fractions for MCICA sampling
-      parallel_for(SimpleBounds<2>(ncol, nlev), YAKL_LAMBDA (int icol, int ilev) {
-          combined_cld(icol,ilev) = std::max(cld(icol,ilev), cldfsnow(icol,ilev));
-      });
-
-      // Get the stochastic subcolumn cloudy mask
-      mcica_subcol_mask(ngpt, ncol, nlev, combined_cld, iscloudy);
-
-      // Map optics to g-points, selecting a single subcolumn for each
-      // g-point. This implementation generates homogeneous clouds, but it would be
-      // straightforward to extend this to handle horizontally heterogeneous clouds
-      // as well.
-      parallel_for(SimpleBounds<3>(ngpt, nlev, ncol), YAKL_LAMBDA (int igpt, int ilev, int icol) {
-         if (iscloudy(igpt,icol,ilev) && combined_cld(icol,ilev) > 0.) {
-             tau_gpt(icol,ilev,igpt) = tau_bnd(icol,ilev,gpt2bnd(igpt));
-         } else {
-            tau_gpt(icol,ilev,igpt) = 0.;
+         const bool has_liq = liq_tab && lambdac(icol,ilev) > 0. && iclwp(icol,ilev) >= 1.e-80;
+         const bool has_ice = ice_tab && iciwp(icol,ilev) >= 1.e-80 && dei(icol,ilev) != 0.;
+         const bool has_snw = do_snow && icswp(icol,ilev) >= 1.e-80 && des(icol,ilev) != 0.;
+         int  jmu = 1, jl = 1, jd = 1, js = 1;
+         real wmu = 1., wl = 1., wd = 1., ws = 1.;
+         if (has_liq) CloudRadProps::gamma_weights(t, lambdac(icol,ilev), mu(icol,ilev), jmu, wmu, jl, wl);
+         if (has_ice) CloudRadProps::interp_weight(t.g_d_eff, t.n_g_d, dei(icol,ilev), jd, wd);
+         if (has_snw) CloudRadProps::interp_weight(t.g_d_eff, t.n_g_d, des(icol,ilev), js, ws);
+
+         const real fcld  = cld(icol,ilev);
+         const real fsnw  = cldfsnow(icol,ilev);
+         const real fcomb = std::max(fcld, fsnw);
+
+         int  ib_cur = 0;
+         real tau = 0.;
+         for (int igpt = 1; igpt <= ngpt; ++igpt) {
+            const int ib = gpt2bnd(igpt);
+            if (ib != ib_cur) {
+               ib_cur = ib;
+
+               real l_tau = 0.;
+               if (has_liq) {
+                  l_tau = iclwp(icol,ilev) * CloudRadProps::liq_value(t.abs_lw_liq, ib, jmu, wmu, jl, wl);
+               } else if (!liq_tab) {
+                  l_tau = liq_tau(ib,icol,ilev);
+               }
+
+               real i_tau = 0.;
+               if (has_ice) {
+                  i_tau = iciwp(icol,ilev) * CloudRadProps::ice_value(t.abs_lw_ice, ib, jd, wd);
+               } else if (!ice_tab) {
+                  i_tau = ice_tau(ib,icol,ilev);
+               }
+
+               real s_tau = 0.;
+               if (has_snw) {
+                  s_tau = icswp(icol,ilev) * CloudRadProps::ice_value(t.abs_lw_ice, ib, js, ws);
+               }
+
+               tau = l_tau + i_tau;
+               if (do_snow) {
+                  tau = (fcomb > 0.) ? (fcld*tau + fsnw*s_tau) / fcomb : 0.;
+               }
+
+               if (do_diag) {
+                  liq_tau_out(icol,ilev,ib) = l_tau;
+                  ice_tau_out(icol,ilev,ib) = i_tau;
+                  snw_tau_out(icol,ilev,ib) = s_tau;
+               }
+            }
+
+            // Map optics to g-points, selecting a single subcolumn for each
+            // g-point. This implementation generates homogeneous clouds.
+            tau_gpt(icol,ilev,igpt) = (iscloudy(igpt,icol,ilev) && fcomb > 0.) ? tau : 0.;
          }
       });
- }
+  }
 
 //----------------------------------------------------------------------------
 void Optics::set_aerosol_optics_sw(int icall, int ncol, int nlev, int nswbands, real dt,
@@ -363,15 +287,15 @@ void Optics::set_aerosol_optics_sw(int icall, int ncol, int nlev, int nswbands,
       yakl::memset(tau_w_g, 0.);
       yakl::memset(tau_w_f, 0.);
 
-      int1d ic("icount",1);
-      intHost1d ic_host("ic_host",1);
-      parallel_for(SimpleBounds<1>(ncol), YAKL_LAMBDA (int i) {
-        if (night_indices(i) > 0) ++ic(1);
-      });
-      ic.deep_copy_to(ic_host);
+      // Number of night columns; night_indices is compacted, so count on the host
+      auto night_host = night_indices.createHostCopy();
+      int nnight = 0;
+      for (int i = 1; i <= ncol; ++i) {
+        if (night_host(i) > 0) ++nnight;
+      }
 
       aero_optics.aer_rad_props_sw(icall, dt,
-           ic_host(1), night_indices, is_cmip6_volc,
+           nnight, night_indices, is_cmip6_volc,
            tau, tau_w, tau_w_g, tau_w_f, clear_rh);
 
       // Extract quantities from products
@@ -408,39 +332,37 @@ void Optics::set_aerosol_optics_lw(int icall, real dt, bool is_cmip6_volc, const
 // at the top of a column and marches down, with each layer depending on the state
 // of the layer above it.
 //
-void Optics::mcica_subcol_mask(int ngpt, int ncol, int nlev,
-                               const real2d& cldfrac, const bool3d& iscloudy) {
-   // Local vars
+void Optics::mcica_subcol_mask(int ngpt, int ncol, int nlev, const real2d& cld,
+                               const real2d& cldfsnow, const bool3d& iscloudy) {
    const real cldmin = 1.0e-80;      // min cloud fraction
-   real2d cldf("cldf",ncol,nlev);    // cloud fraction clipped to cldmin
-   real3d cdf("cdf", ngpt, ncol, nlev);   // random numbers
-
-   // clip cloud fraction
-   parallel_for(SimpleBounds<2>(ncol, nlev), YAKL_LAMBDA (int icol, int ilev) {
-      cldf(icol,ilev) = cldfrac(icol,ilev);
-      if (cldf(icol,ilev) < cldmin) cldf(icol,ilev) = 0.;
-   });
 
    amrex::RandomEngine engine;
-   // Generate random numbers in each subcolumn at every level
-    parallel_for(SimpleBounds<3>(ngpt, ncol, nlev), YAKL_LAMBDA (int isubcol, int icol, int ilev) {
-      cdf(isubcol,icol,ilev) = amrex::Random(engine);
-   });
 
-   // Maximum-Random overlap
+   // Maximum-Random overlap, one subcolumn per thread
    // i) pick a random number for top layer.
    // ii) walk down the column:
    //    - if the layer above is cloudy, use the same random number as in the layer above
    //    - if the layer above is clear, use a new random number
-   parallel_for(SimpleBounds<3>(nlev, ncol, ngpt), YAKL_LAMBDA (int k, int i, int isubcol) {
-     if (k > 1) {
-        if (cdf(isubcol,i,k-1) > 1. - cldf(i,k-1) ) {
-           cdf(isubcol,i,k) = cdf(isubcol,i,k-1);
-        } else {
-           cdf(isubcol,i,k) = cdf(isubcol,i,k) * (1. - cldf(i,k-1));
+   parallel_for(SimpleBounds<2>(ngpt, ncol), YAKL_LAMBDA (int isubcol, int i) {
+     real cdf_above  = 0.;
+     real cldf_above = 0.;
+     for (int k = 1; k <= nlev; ++k) {
+        // combined cloud and snow fraction, clipped to cldmin
+        real cldf = std::max(cld(i,k), cldfsnow(i,k));
+        if (cldf < cldmin) cldf = 0.;
+
+        real cdf = amrex::Random(engine);
+        if (k > 1) {
+           if (cdf_above > 1. - cldf_above) {
+              cdf = cdf_above;
+           } else {
+              cdf *= (1. - cldf_above);
+           }
         }
-        iscloudy(isubcol,i,k) = cdf(isubcol,i,k) >= 1.-cldf(i,k) ? true : false;
+        iscloudy(isubcol,i,k) = (cdf >= 1. - cldf);
+
+        cdf_above  = cdf;
+        cldf_above = cldf;
      }
    });
 }
-
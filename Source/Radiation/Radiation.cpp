@@ -13,6 +13,7 @@
  */
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <memory>
 
 #include "Radiation.H"
@@ -22,6 +23,7 @@
 #include <AMReX_Geometry.H>
 #include <AMReX_TableData.H>
 #include <AMReX_MultiFabUtil.H>
+#include <AMReX_ParmParse.H>
 #include "ERF_Constants.H"
 #include "IndexDefines.H"
 #include "DataStruct.H"
@@ -46,20 +48,10 @@ namespace internal {
   }
 
   void expand_day_fluxes(const FluxesByband& daytime_fluxes, FluxesByband& expanded_fluxes,
-                         const int1d& day_indices) {
-      auto ncol  = size(daytime_fluxes.bnd_flux_up, 1);
+                         const int1d& day_indices, int nday) {
       auto nlev  = size(daytime_fluxes.bnd_flux_up, 2);
       auto nbnds = size(daytime_fluxes.bnd_flux_up, 3);
 
-      int1d nday_1d("nday_1d", 1),
-            nday_host("nday_host",1);
-      yakl::memset(nday_1d, 0);
-      parallel_for(SimpleBounds<1>(ncol), YAKL_LAMBDA (int icol) {
-         if (day_indices(icol) > 0) nday_1d(1)++;
-      });
-
-      nday_1d.deep_copy_to(nday_host);
-      auto nday = nday_host(1);
       parallel_for(SimpleBounds<3>(nday, nlev, nbnds), YAKL_LAMBDA (int iday, int ilev, int ibnd) {
         // Map daytime index to proper column index
          auto icol = day_indices(iday);
@@ -78,18 +70,46 @@ namespace internal {
      });
   }
 
-  // Utility function to reorder an array given a new indexing
-  void reordered(const real1d& array_in, const int1d& new_indexing, const real1d& array_out) {
-      // Reorder array based on input index mapping, which maps old indices to new
-      parallel_for(SimpleBounds<1>(size(array_in, 1)), YAKL_LAMBDA (int i) {
-         array_out(i) = array_in(new_indexing(i));
-      });
+  // Bilinear interpolation of the packed coarse columns of a box, whose
+  // coarse index range is [cilo,cihi] x [cjlo,cjhi], to the fine column (i,j);
+  // coarse columns outside the box are replaced by the nearest one inside
+  AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+  amrex::Real interp_column(const real2d& tend, int off,
+                            int cilo, int cihi, int cjlo, int cjhi,
+                            int r, int i, int j, int ilev) {
+      const amrex::Real x = (i + 0.5) / r - 0.5;
+      const amrex::Real y = (j + 0.5) / r - 0.5;
+      const int i0 = static_cast<int>(std::floor(x));
+      const int j0 = static_cast<int>(std::floor(y));
+      const amrex::Real wx = x - i0;
+      const amrex::Real wy = y - j0;
+      const int ia = amrex::min(amrex::max(i0, cilo), cihi);
+      const int ib = amrex::min(amrex::max(i0+1, cilo), cihi);
+      const int ja = amrex::min(amrex::max(j0, cjlo), cjhi);
+      const int jb = amrex::min(amrex::max(j0+1, cjlo), cjhi);
+      const int cnx = cihi - cilo + 1;
+      auto col = [=] (int ic, int jc) { return off + (jc-cjlo)*cnx + (ic-cilo) + 1; };
+      return (1.0-wy) * ((1.0-wx)*tend(col(ia,ja),ilev) + wx*tend(col(ib,ja),ilev))
+           +      wy  * ((1.0-wx)*tend(col(ia,jb),ilev) + wx*tend(col(ib,jb),ilev));
+  }
+
+  // Solar declination [rad], equation of time [rad] and Earth-Sun distance
+  // factor for the (fractional) day of the year doy, following
+  // Spencer (1971), Fourier series representation of the position of the sun
+  void solar_position(amrex::Real doy, amrex::Real& decl, amrex::Real& eot, amrex::Real& eccf) {
+      const amrex::Real g = 2.0*PI*(doy - 1.0)/365.0;
+      decl = 0.006918 - 0.399912*std::cos(g) + 0.070257*std::sin(g)
+           - 0.006758*std::cos(2.0*g) + 0.000907*std::sin(2.0*g)
+           - 0.002697*std::cos(3.0*g) + 0.001480*std::sin(3.0*g);
+      eot  = 0.000075 + 0.001868*std::cos(g) - 0.032077*std::sin(g)
+           - 0.014615*std::cos(2.0*g) - 0.040849*std::sin(2.0*g);
+      eccf = 1.000110 + 0.034221*std::cos(g) + 0.001280*std::sin(g)
+           + 0.000719*std::cos(2.0*g) + 0.000077*std::sin(2.0*g);
   }
 }
 
 // init
 void Radiation::initialize(const MultiFab& cons_in,
-                           const MultiFab& qmoist,
                            const BoxArray& grids,
                            const Geometry& geom,
                            const Real& dt_advance,
@@ -101,6 +121,7 @@ void Radiation::initialize(const MultiFab& cons_in,
 
    m_geom = geom;
    m_box = grids;
+   m_dmap = cons_in.DistributionMap();
 
    auto dz   = m_geom.CellSize(2);
    auto lowz = m_geom.ProbLo(2);
@@ -113,20 +134,79 @@ void Radiation::initialize(const MultiFab& cons_in,
    do_snow_optics = do_snow_opt;
    is_cmip6_volc = is_cmip6_volcano;
 
-   for ( MFIter mfi(cons_in, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+   // Pack the columns of all local boxes one after the other; ERF does
+   // not chop the grids in z, so every column spans the whole domain
+   nlev = m_geom.Domain().length(2);
+
+   // Radiation may run on the average of r x r blocks of columns
+   ParmParse pp("erf");
+   pp.query("rad_coarsening_ratio", m_crse_ratio);
+   if (m_crse_ratio < 1) {
+      amrex::Abort("erf.rad_coarsening_ratio must be at least 1");
+   }
+   const IntVect crse_ratio(m_crse_ratio, m_crse_ratio, 1);
 
-      const auto& box3d = mfi.tilebox();
+   m_col_offset.resize(cons_in.local_size()+1);
+   ncol_local = 0;
+   for ( MFIter mfi(cons_in, false); mfi.isValid(); ++mfi) {
+      const auto& cbx = amrex::coarsen(mfi.validbox(), crse_ratio);
+      m_col_offset[mfi.LocalIndex()] = ncol_local;
+      ncol_local += cbx.length(0)*cbx.length(1);
+   }
+   m_col_offset[cons_in.local_size()] = ncol_local;
 
-      nlev = box3d.length(2);
-      ncol = box3d.length(0)*box3d.length(1);
+   // The RRTMGP work arrays are sized for one batch of columns
+   pp.query("rad_column_chunk_size", m_chunk_size);
+   if (m_chunk_size <= 0) {
+      amrex::Abort("erf.rad_column_chunk_size must be positive");
+   }
+   ncol = std::max(1, std::min(m_chunk_size, ncol_local));
+   nchunks = (ncol_local + ncol - 1) / ncol;
+
+   // Solar geometry; the latitude defaults to the one of the Coriolis force
+   pp.query("latitude", m_latitude);
+   pp.query("rad_latitude", m_latitude);
+   pp.query("rad_longitude", m_longitude);
+   pp.query("rad_start_day_of_year", m_start_day_of_year);
+   pp.query("rad_fixed_cosz", m_fixed_cosz);
+
+   // Latitude and longitude of the center of every packed column, mapping
+   // x and y onto the sphere around (m_latitude, m_longitude) at x = y = 0
+   constexpr Real earth_radius = 6.371e6;
+   const Real lat0 = m_latitude*PI/180.;
+   const Real lon0 = m_longitude*PI/180.;
+   const Real coslat0 = std::max(std::cos(lat0), 1.0e-6);
+   m_col_lat.resize(ncol_local);
+   m_col_lon.resize(ncol_local);
+   m_cosz.resize(ncol_local);
+   m_cosz_sw.clear();
+   for ( MFIter mfi(cons_in, false); mfi.isValid(); ++mfi) {
+      const auto& vbx = mfi.validbox();
+      const auto& cbx = amrex::coarsen(vbx, crse_ratio);
+      const int off = m_col_offset[mfi.LocalIndex()];
+      for (int jc = cbx.smallEnd(1); jc <= cbx.bigEnd(1); ++jc) {
+         for (int ic = cbx.smallEnd(0); ic <= cbx.bigEnd(0); ++ic) {
+            const Real xc = 0.5*(std::max(ic*m_crse_ratio, vbx.smallEnd(0)) +
+                                 std::min(ic*m_crse_ratio+m_crse_ratio-1, vbx.bigEnd(0)) + 1);
+            const Real yc = 0.5*(std::max(jc*m_crse_ratio, vbx.smallEnd(1)) +
+                                 std::min(jc*m_crse_ratio+m_crse_ratio-1, vbx.bigEnd(1)) + 1);
+            const Real x = m_geom.ProbLo(0) + xc*m_geom.CellSize(0);
+            const Real y = m_geom.ProbLo(1) + yc*m_geom.CellSize(1);
+            const int icol = off + (jc-cbx.smallEnd(1))*cbx.length(0) + (ic-cbx.smallEnd(0));
+            m_col_lat[icol] = lat0 + y/earth_radius;
+            m_col_lon[icol] = lon0 + x/(earth_radius*coslat0);
+         }
+      }
    }
 
    ngas = active_gases.size();
 
    // initialize cloud, aerosol, and radiation
-   radiation.initialize(ngas, active_gases,
-                        rrtmgp_coefficients_file_sw.c_str(),
-                        rrtmgp_coefficients_file_lw.c_str());
+   if (!m_coefficients_loaded) {
+      radiation.initialize(ngas, active_gases,
+                           rrtmgp_coefficients_file_sw.c_str(),
+                           rrtmgp_coefficients_file_lw.c_str());
+   }
 
    // initialize the radiation data
    nswbands = radiation.get_nband_sw();
@@ -134,15 +214,24 @@ void Radiation::initialize(const MultiFab& cons_in,
    nlwbands = radiation.get_nband_lw();
    nlwgpts  = radiation.get_ngpt_lw();
 
-   rrtmg_to_rrtmgp = int1d("rrtmg_to_rrtmgp",14);
-   parallel_for(14, YAKL_LAMBDA (int i) {
+   // The last RRTMG band (820-2600 cm^-1) is the first one in RRTMGP
+   if (nswbands != RadConstants::nswbands) {
+      amrex::Abort("Radiation: unexpected number of shortwave bands");
+   }
+   rrtmg_to_rrtmgp = int1d("rrtmg_to_rrtmgp",RadConstants::nswbands);
+   parallel_for(RadConstants::nswbands, YAKL_LAMBDA (int i) {
      if (i == 1) {
-       rrtmg_to_rrtmgp(i) = 13;
+       rrtmg_to_rrtmgp(i) = RadConstants::nswbands;
      } else {
        rrtmg_to_rrtmgp(i) = i - 1;
      }
    });
 
+   gpoint_bands_sw = int1d("gpoint_bands_sw", nswgpts);
+   gpoint_bands_lw = int1d("gpoint_bands_lw", nlwgpts);
+   radiation.get_gpoint_bands_sw(gpoint_bands_sw);
+   radiation.get_gpoint_bands_lw(gpoint_bands_lw);
+
    tmid = real2d("tmid", ncol, nlev);
    pmid = real2d("pmid", ncol, nlev);
 
@@ -155,44 +244,7 @@ void Radiation::initialize(const MultiFab& cons_in,
    qn   = real2d("qn", ncol, nlev);
    zi   = real2d("zi", ncol, nlev);
 
-  //amrex::MultiFab qv(qmoist, amrex::make_alias, 0, 1);
-  //amrex::MultiFab qc(qmoist, amrex::make_alias, 1, 1);
-  //amrex::MultiFab qi(qmoist, amrex::make_alias, 2, 1);
-
-   // Get the temperature, density, theta, qt and qp from input
-   for ( MFIter mfi(cons_in, false); mfi.isValid(); ++mfi) {
-     auto states_array = cons_in.array(mfi);
-     auto qmoist_array = qmoist.array(mfi);
-
-     const auto& box3d = mfi.tilebox();
-     auto nx = box3d.length(0);
-     auto ny = box3d.length(1);
-     // Get pressure, theta, temperature, density, and qt, qp
-     amrex::ParallelFor( box3d, [=] AMREX_GPU_DEVICE (int i, int j, int k) {
-       auto icol = j*nx+i+1;
-       auto ilev = k+1;
-       qt(icol,ilev)   = states_array(i,j,k,RhoQt_comp)/states_array(i,j,k,Rho_comp);
-       qc(icol,ilev)   = qmoist_array(i,j,k,1);
-       qi(icol,ilev)   = qmoist_array(i,j,k,2);
-       qn(icol,ilev)   = qmoist_array(i,j,k,1) + qmoist_array(i,j,k,2);
-       tmid(icol,ilev) = getTgivenRandRTh(states_array(i,j,k,Rho_comp),states_array(i,j,k,RhoTheta_comp));
-       pmid(icol,ilev) = getPgivenRTh(states_array(i,j,k,RhoTheta_comp));
-     });
-   }
-
-   parallel_for(SimpleBounds<2>(ncol, nlev+1), YAKL_LAMBDA (int icol, int ilev) {
-     if (ilev == 1) {
-       pint(icol, 1) = 2.*pmid(icol, 2) - pmid(icol, 1);
-       tint(icol, 1) = 2.*tmid(icol, 2) - tmid(icol, 1);
-     } else if (ilev <= nlev) {
-       pint(icol, ilev) = 0.5*(pmid(icol, ilev-1) + pmid(icol, ilev));
-       tint(icol, ilev) = 0.5*(tmid(icol, ilev-1) + tmid(icol, ilev));
-     } else {
-       pint(icol, nlev+1) = 2.*pmid(icol, nlev-1) - pmid(icol, nlev);
-       tint(icol, nlev+1) = 2.*tmid(icol, nlev-1) - tmid(icol, nlev);
-     }
-   });
-
+   // The heights do not change between steps
    parallel_for(SimpleBounds<2>(ncol, nlev), YAKL_LAMBDA (int icol, int ilev) {
      zi(icol, ilev) = lowz + (ilev+0.5)*dz;
    });
@@ -208,6 +260,108 @@ void Radiation::initialize(const MultiFab& cons_in,
    qrsc = real2d("qrsc", ncol, nlev);
    qrlc = real2d("qrlc", ncol, nlev);
 
+   // Potential temperature tendencies of all local columns
+   theta_tend_sw = real2d("theta_tend_sw", std::max(1,ncol_local), nlev);
+   theta_tend_lw = real2d("theta_tend_lw", std::max(1,ncol_local), nlev);
+   yakl::memset(theta_tend_sw, 0.);
+   yakl::memset(theta_tend_lw, 0.);
+   sw_scale = real1d("sw_scale", std::max(1,ncol_local));
+   if (m_crse_ratio > 1) {
+      theta_corr_sw = real2d("theta_corr_sw", std::max(1,ncol_local), nlev);
+      theta_corr_lw = real2d("theta_corr_lw", std::max(1,ncol_local), nlev);
+   }
+
+   clear_rh = real2d("clear_rh", ncol, nswbands);
+   yakl::memset(clear_rh, 0.01);
+
+   // Work arrays of run()
+   coszrs   = real1d("coszrs", ncol);
+   cld      = real2d("cld", ncol, nlev);
+   cldfsnow = real2d("cldfsnow", ncol, nlev);
+   iclwp    = real2d("iclwp", ncol, nlev);
+   iciwp    = real2d("iciwp", ncol, nlev);
+   icswp    = real2d("icswp", ncol, nlev);
+   dei      = real2d("dei", ncol, nlev);
+   des      = real2d("des", ncol, nlev);
+   lambdac  = real2d("lambdac", ncol, nlev);
+   mu       = real2d("mu", ncol, nlev);
+   rei      = real2d("rei", ncol, nlev);
+   rel      = real2d("rel", ncol, nlev);
+
+   cld_tau_gpt_sw = real3d("cld_tau_gpt_sw", ncol, nlev, nswgpts);
+   cld_ssa_gpt_sw = real3d("cld_ssa_gpt_sw", ncol, nlev, nswgpts);
+   cld_asm_gpt_sw = real3d("cld_asm_gpt_sw", ncol, nlev, nswgpts);
+   aer_tau_bnd_sw = real3d("aer_tau_bnd_sw", ncol, nlev, nswbands);
+   aer_ssa_bnd_sw = real3d("aer_ssa_bnd_sw", ncol, nlev, nswbands);
+   aer_asm_bnd_sw = real3d("aer_asm_bnd_sw", ncol, nlev, nswbands);
+   aer_tau_bnd_lw = real3d("aer_tau_bnd_lw", ncol, nlev, nlwbands);
+   cld_tau_gpt_lw = real3d("cld_tau_gpt_lw", ncol, nlev, nlwgpts);
+
+   // NOTE: these are diagnostic only
+   pp.query("rad_optics_diagnostics", do_optics_diag);
+   if (do_optics_diag) {
+      liq_tau_bnd_sw = real3d("liq_tau_bnd_sw", ncol, nlev, nswbands);
+      ice_tau_bnd_sw = real3d("ice_tau_bnd_sw", ncol, nlev, nswbands);
+      snw_tau_bnd_sw = real3d("snw_tau_bnd_sw", ncol, nlev, nswbands);
+      liq_tau_bnd_lw = real3d("liq_tau_bnd_lw", ncol, nlev, nlwbands);
+      ice_tau_bnd_lw = real3d("ice_tau_bnd_lw", ncol, nlev, nlwbands);
+      snw_tau_bnd_lw = real3d("snw_tau_bnd_lw", ncol, nlev, nlwbands);
+   }
+
+   // Gas volume mixing ratios
+   gas_vmr = real3d("gas_vmr", ngas, ncol, nlev);
+
+   day_indices   = int1d("day_indices", ncol);
+   night_indices = int1d("night_indices", ncol);
+
+   internal::initial_fluxes(ncol, nlev, nlwbands, sw_fluxes_allsky);
+   internal::initial_fluxes(ncol, nlev, nlwbands, sw_fluxes_clrsky);
+   internal::initial_fluxes(ncol, nlev, nlwbands, lw_fluxes_allsky);
+   internal::initial_fluxes(ncol, nlev, nlwbands, lw_fluxes_clrsky);
+
+   // Work arrays of radiation_driver_sw
+   coszrs_day     = real1d("coszrs_day", ncol);
+   albedo_dir_day = real2d("albedo_dir_day", nswbands, ncol);
+   albedo_dif_day = real2d("albedo_dif_day", nswbands, ncol);
+   pmid_day       = real2d("pmid_day", ncol, nlev);
+   tmid_day       = real2d("tmid_day", ncol, nlev);
+   pint_day       = real2d("pint_day", ncol, nlev+1);
+
+   gas_vmr_day    = real3d("gas_vmr_day", ngas, ncol, nlev);
+   gas_vmr_rad_sw = real3d("gas_vmr_rad_sw", ngas, ncol, nlev);
+
+   cld_tau_gpt_day = real3d("cld_tau_gpt_day", ncol, nlev, nswgpts);
+   cld_ssa_gpt_day = real3d("cld_ssa_gpt_day", ncol, nlev, nswgpts);
+   cld_asm_gpt_day = real3d("cld_asm_gpt_day", ncol, nlev, nswgpts);
+   aer_tau_bnd_day = real3d("aer_tau_bnd_day", ncol, nlev, nswbands);
+   aer_ssa_bnd_day = real3d("aer_ssa_bnd_day", ncol, nlev, nswbands);
+   aer_asm_bnd_day = real3d("aer_asm_bnd_day", ncol, nlev, nswbands);
+
+   cld_tau_gpt_rad_sw = real3d("cld_tau_gpt_rad_sw", ncol, nlev+1, nswgpts);
+   cld_ssa_gpt_rad_sw = real3d("cld_ssa_gpt_rad_sw", ncol, nlev+1, nswgpts);
+   cld_asm_gpt_rad_sw = real3d("cld_asm_gpt_rad_sw", ncol, nlev+1, nswgpts);
+   aer_tau_bnd_rad_sw = real3d("aer_tau_bnd_rad_sw", ncol, nlev+1, nswgpts);
+   aer_ssa_bnd_rad_sw = real3d("aer_ssa_bnd_rad_sw", ncol, nlev+1, nswgpts);
+   aer_asm_bnd_rad_sw = real3d("aer_asm_bnd_rad_sw", ncol, nlev+1, nswgpts);
+
+   nday_fluxes = -1;
+
+   // Work arrays of radiation_driver_lw
+   cld_tau_gpt_rad_lw = real3d("cld_tau_gpt_rad_lw", ncol, nlev+1, nlwgpts);
+   aer_tau_bnd_rad_lw = real3d("aer_tau_bnd_rad_lw", ncol, nlev+1, nlwgpts);
+   qrl_rad  = real2d("qrl_rad", ncol, nlev);
+   qrlc_rad = real2d("qrlc_rad", ncol, nlev);
+   gas_vmr_rad_lw = real3d("gas_vmr_rad_lw", ngas, ncol, nlev);
+
+   // Set surface emissivity to 1 here. There is a note in the RRTMG
+   // implementation that this is treated in the land model, but the old
+   // RRTMG implementation also sets this to 1. This probably does not make
+   // a lot of difference either way, but if a more intelligent value
+   // exists or is assumed in the model we should use it here as well.
+   // TODO: set this more intelligently?
+   surface_emissivity = real2d("surface_emissivity", nlwbands, ncol);
+   yakl::memset(surface_emissivity, 1.0);
+
    int nmodes = 3;
    int nrh = 1;
    int top_lev = 1;
@@ -216,96 +370,225 @@ void Radiation::initialize(const MultiFab& cons_in,
    auto geom_radius = real2d("geom_radius", ncol, nlev);
    yakl::memset(geom_radius, 0.1);
 
+   // The aerosol optics keep handles to zi, pmid, tmid and qt, so they see
+   // the state written by update()
    optics.initialize(ngas, nmodes, naer, nswbands, nlwbands,
-                     ncol, nlev, nrh, top_lev, aero_names, zi,
+                     nswgpts, nlwgpts, ncol, nlev, nrh, top_lev, aero_names, zi,
                      pmid, tmid, qt, geom_radius);
 
-   amrex::Print() << "LW coefficents file: " << rrtmgp_coefficients_file_lw
-                  << "\nSW coefficents file: " << rrtmgp_coefficients_file_sw
-                  << "\nFrequency (timesteps) of Shortwave Radiation calc: " << dt
-                  << "\nFrequency (timesteps) of Longwave Radiation calc:  " << dt
-                  << "\nDo aerosol radiative calculations: " << do_aerosol_rad << std::endl;
+   if (!m_coefficients_loaded) {
+      amrex::Print() << "LW coefficents file: " << rrtmgp_coefficients_file_lw
+                     << "\nSW coefficents file: " << rrtmgp_coefficients_file_sw
+                     << "\nFrequency (timesteps) of Shortwave Radiation calc: " << dt
+                     << "\nFrequency (timesteps) of Longwave Radiation calc:  " << dt
+                     << "\nDo aerosol radiative calculations: " << do_aerosol_rad << std::endl;
+   }
 
+   m_coefficients_loaded = true;
+   m_initialized = true;
 }
 
+// update the radiation state from the current solution
+void Radiation::update(const MultiFab& cons_in,
+                       const Vector<MultiFab*>& qmoist,
+                       const Real& time) {
+   // The columns are gathered from these batch by batch in run()
+   m_cons   = &cons_in;
+   m_qmoist = qmoist;
+   m_time   = time;
+}
 
-// run radiation model
-void Radiation::run() {
-   // Temporary variable for heating rate output
-   real2d hr("hr", ncol, nlev);
-
-   // Cosine solar zenith angle for all columns in chunk
-   real1d coszrs("coszrs", ncol);
-
-   // Pointers to fields on the physics buffer
-   real2d cld("cld", ncol, nlev), cldfsnow("cldfsnow", ncol, nlev),
-          iclwp("iclwp", ncol, nlev), iciwp("iciwp", ncol, nlev),
-          icswp("icswp", ncol, nlev), dei("dei", ncol, nlev),
-          des("des", ncol, nlev), lambdac("lambdac", ncol, nlev),
-          mu("mu", ncol, nlev), rei("rei", ncol, nlev), rel("rel", ncol, nlev);
-
-   // Cloud, snow, and aerosol optical properties
-   real3d cld_tau_gpt_sw("cld_tau_gpt_sw", ncol, nlev, nswgpts),
-          cld_ssa_gpt_sw("cld_ssa_gpt_sw", ncol, nlev, nswgpts),
-          cld_asm_gpt_sw("cld_asm_gpt_sw", ncol, nlev, nswgpts);
-   real3d cld_tau_bnd_sw("cld_tau_bnd_sw", ncol, nlev, nswbands),
-          cld_ssa_bnd_sw("cld_ssa_bnd_sw", ncol, nlev, nswbands),
-          cld_asm_bnd_sw("cld_asm_bnd_sw", ncol, nlev, nswbands);
-   real3d aer_tau_bnd_sw("aer_tau_bnd_sw", ncol, nlev, nswbands),
-          aer_ssa_bnd_sw("aer_ssa_bnd_sw", ncol, nlev, nswbands),
-          aer_asm_bnd_sw("aer_asm_bnd_sw", ncol, nlev, nswbands);
-   real3d cld_tau_bnd_lw("cld_tau_bnd_lw", ncol, nlev, nlwbands),
-          aer_tau_bnd_lw("aer_tau_bnd_lw", ncol, nlev, nlwbands);
-   real3d cld_tau_gpt_lw("cld_tau_gpt_lw", ncol, nlev, nlwgpts);
+// Cosine of the solar zenith angle of all local columns at m_time
+void Radiation::set_cosine_solar_zenith_angle() {
+   if (m_fixed_cosz >= 0.) {
+      std::fill(m_cosz.begin(), m_cosz.end(), m_fixed_cosz);
+      m_eccf = 1.0;
+      return;
+   }
 
-   // NOTE: these are diagnostic only
-   real3d liq_tau_bnd_sw("liq_tau_bnd_sw", ncol, nlev, nswbands),
-          ice_tau_bnd_sw("ice_tau_bnd_sw", ncol, nlev, nswbands),
-          snw_tau_bnd_sw("snw_tau_bnd_sw", ncol, nlev, nswbands);
-   real3d liq_tau_bnd_lw("liq_tau_bnd_lw", ncol, nlev, nlwbands),
-          ice_tau_bnd_lw("ice_tau_bnd_lw", ncol, nlev, nlwbands),
-          snw_tau_bnd_lw("snw_tau_bnd_lw", ncol, nlev, nlwbands);
+   const Real doy = m_start_day_of_year + m_time/86400.;
+   Real decl, eot;
+   internal::solar_position(doy, decl, eot, m_eccf);
+
+   // Hour angle at longitude zero; the sun is overhead there at 12 UTC
+   // (up to the equation of time)
+   const Real h0 = 2.0*PI*(doy - std::floor(doy)) + eot - PI;
+   const Real sin_decl = std::sin(decl);
+   const Real cos_decl = std::cos(decl);
+   for (int icol = 0; icol < ncol_local; ++icol) {
+      m_cosz[icol] = std::sin(m_col_lat[icol])*sin_decl
+                   + std::cos(m_col_lat[icol])*cos_decl*std::cos(h0 + m_col_lon[icol]);
+   }
+}
 
-   // Gas volume mixing ratios
-   real3d gas_vmr("gas_vmr", ngas, ncol, nlev);
+// Copy the columns of batch ichunk into the RRTMGP input arrays
+void Radiation::gather_chunk(int ichunk) {
+   const int c0 = ichunk*ncol;
+   const int c1 = std::min(c0+ncol, ncol_local);
+   const int nreal = c1 - c0;
+
+   const int r = m_crse_ratio;
+
+   // qmoist is ordered qt, qv, qc(l), qi, ...; the warm schemes (e.g.
+   // FastEddy) carry no cloud ice
+   const bool has_qc = (m_qmoist.size() > 2);
+   const bool has_qi = (m_qmoist.size() > 3);
+
+   for ( MFIter mfi(*m_cons, false); mfi.isValid(); ++mfi) {
+     const int off = m_col_offset[mfi.LocalIndex()];
+     const int lo  = std::max(off, c0);
+     const int hi  = std::min(m_col_offset[mfi.LocalIndex()+1], c1);
+     if (lo >= hi) continue;
+
+     auto states_array = m_cons->const_array(mfi);
+     auto qc_array = (has_qc) ? m_qmoist[2]->const_array(mfi) : Array4<const Real>{};
+     auto qi_array = (has_qi) ? m_qmoist[3]->const_array(mfi) : Array4<const Real>{};
+
+     const auto& vbx = mfi.validbox();
+     const auto& crse_bx = amrex::coarsen(vbx, IntVect(r,r,1));
+     const int cnx  = crse_bx.length(0);
+     const int cilo = crse_bx.smallEnd(0);
+     const int cjlo = crse_bx.smallEnd(1);
+     const int ilo = vbx.smallEnd(0), ihi = vbx.bigEnd(0);
+     const int jlo = vbx.smallEnd(1), jhi = vbx.bigEnd(1);
+     const int klo = vbx.smallEnd(2);
+
+     // (m,kk) runs over the packed columns lo..hi-1 and the levels; each
+     // packed column is the average of the r x r fine columns it covers
+     Box cbx(IntVect(0,0,0), IntVect(hi-lo-1, nlev-1, 0));
+     amrex::ParallelFor(cbx, [=] AMREX_GPU_DEVICE (int m, int kk, int) {
+       const int bcol = lo + m - off;
+       const int ic = cilo + bcol % cnx;
+       const int jc = cjlo + bcol / cnx;
+       const int k = klo + kk;
+       Real sum_qt = 0.0, sum_qc = 0.0, sum_qi = 0.0, sum_t = 0.0, sum_p = 0.0;
+       int  nsum = 0;
+       for (int j = amrex::max(jc*r, jlo); j <= amrex::min(jc*r+r-1, jhi); ++j) {
+         for (int i = amrex::max(ic*r, ilo); i <= amrex::min(ic*r+r-1, ihi); ++i) {
+           sum_qt += states_array(i,j,k,RhoQ1_comp)/states_array(i,j,k,Rho_comp);
+           sum_qc += (has_qc) ? qc_array(i,j,k) : 0.0;
+           sum_qi += (has_qi) ? qi_array(i,j,k) : 0.0;
+           sum_t  += getTgivenRandRTh(states_array(i,j,k,Rho_comp),states_array(i,j,k,RhoTheta_comp));
+           sum_p  += getPgivenRTh(states_array(i,j,k,RhoTheta_comp));
+           ++nsum;
+         }
+       }
+       const Real inv = 1.0 / static_cast<Real>(nsum);
+       auto icol = lo + m - c0 + 1;
+       auto ilev = kk + 1;
+       qt(icol,ilev)   = sum_qt*inv;
+       qc(icol,ilev)   = sum_qc*inv;
+       qi(icol,ilev)   = sum_qi*inv;
+       qn(icol,ilev)   = (sum_qc + sum_qi)*inv;
+       tmid(icol,ilev) = sum_t*inv;
+       pmid(icol,ilev) = sum_p*inv;
+     });
+   }
 
-   // Needed for shortwave aerosol; TODO: remove this dependency
-   int nday, nnight;     // Number of daylight columns
-   int1d day_indices("day_indices", ncol), night_indices("night_indices", ncol);   // Indicies of daylight coumns
+   // Pad a partial last batch with copies of its last column; the results
+   // of the padding columns are discarded
+   if (nreal < ncol) {
+     parallel_for(SimpleBounds<2>(ncol-nreal, nlev), YAKL_LAMBDA (int ipad, int ilev) {
+       qt(nreal+ipad,ilev)   = qt(nreal,ilev);
+       qc(nreal+ipad,ilev)   = qc(nreal,ilev);
+       qi(nreal+ipad,ilev)   = qi(nreal,ilev);
+       qn(nreal+ipad,ilev)   = qn(nreal,ilev);
+       tmid(nreal+ipad,ilev) = tmid(nreal,ilev);
+       pmid(nreal+ipad,ilev) = pmid(nreal,ilev);
+     });
+   }
 
-   // Flag to carry (QRS,QRL)*dp across time steps.
-   // TODO: what does this mean?
-   bool conserve_energy = true;
+   // Cosine of the solar zenith angle of the batch; the padding columns
+   // count as night so that the shortwave skips them
+   if (sw_computed) {
+     realHost1d coszrs_host("coszrs_host", ncol);
+     for (int icol = 1; icol <= ncol; ++icol) {
+       coszrs_host(icol) = (icol <= nreal) ? m_cosz[c0+icol-1] : 0.0;
+     }
+     coszrs_host.deep_copy_to(coszrs);
+     nday = set_daynight_indices(coszrs_host, day_indices, night_indices);
+   }
 
-   // For loops over diagnostic calls
-   //bool active_calls(0:N_DIAG)
+   parallel_for(SimpleBounds<2>(ncol, nlev+1), YAKL_LAMBDA (int icol, int ilev) {
+     if (ilev == 1) {
+       pint(icol, 1) = 2.*pmid(icol, 2) - pmid(icol, 1);
+       tint(icol, 1) = 2.*tmid(icol, 2) - tmid(icol, 1);
+     } else if (ilev <= nlev) {
+       pint(icol, ilev) = 0.5*(pmid(icol, ilev-1) + pmid(icol, ilev));
+       tint(icol, ilev) = 0.5*(tmid(icol, ilev-1) + tmid(icol, ilev));
+     } else {
+       pint(icol, nlev+1) = 2.*pmid(icol, nlev-1) - pmid(icol, nlev);
+       tint(icol, nlev+1) = 2.*tmid(icol, nlev-1) - tmid(icol, nlev);
+     }
+   });
+}
 
-   // Zero-array for cloud properties if not diagnosed by microphysics
-   real2d zeros("zeros", ncol, nlev);
+// Convert the heating rates [W/kg] of batch ichunk to potential temperature
+// tendencies [K/s] of the local columns
+void Radiation::store_chunk(int ichunk) {
+   const int c0 = ichunk*ncol;
+   const int nreal = std::min(c0+ncol, ncol_local) - c0;
+   const bool l_sw = sw_computed;
+   const bool l_lw = lw_computed;
+
+   parallel_for(SimpleBounds<2>(nreal, nlev), YAKL_LAMBDA (int icol, int ilev) {
+     Real iexner = std::pow(p_0/pmid(icol,ilev), R_d/Cp_d);
+     if (l_sw) theta_tend_sw(c0+icol,ilev) = qrs(icol,ilev) / Cp_d * iexner;
+     if (l_lw) theta_tend_lw(c0+icol,ilev) = qrl(icol,ilev) / Cp_d * iexner;
+   });
+}
 
-   int1d gpoint_bands_sw("gpoint_bands_sw", nswgpts);
-   int1d gpoint_bands_lw("gpoint_bands_lw", nlwgpts);
+// run radiation model over all local columns, one batch at a time
+void Radiation::run(bool compute_sw, bool compute_lw) {
+   sw_computed = do_short_wave_rad && compute_sw;
+   lw_computed = do_long_wave_rad  && compute_lw;
 
-   // Do shortwave stuff...
-   if (do_short_wave_rad) {
-      // Radiative fluxes
-      FluxesByband fluxes_allsky, fluxes_clrsky;
-      internal::initial_fluxes(ncol, nlev, nlwbands, fluxes_allsky);
-      internal::initial_fluxes(ncol, nlev, nlwbands, fluxes_clrsky);
+   if (!sw_computed && !lw_computed) return;
 
-      // Get cosine solar zenith angle for current time step. ( still NOT YET implemented here)
-//      set_cosine_solar_zenith_angle(state, dt_avg, coszrs(1:ncol))
-      yakl::memset(coszrs, 0.2);  // we set constant value here to avoid numerical overflow.
+   if (sw_computed) {
+      set_cosine_solar_zenith_angle();
+      m_cosz_sw = m_cosz;
+   }
 
-     // Get albedo. This uses CAM routines internally and just provides a
-     // wrapper to improve readability of the code here.
-     set_albedo(coszrs, albedo_dir, albedo_dif);
+   for (int ichunk = 0; ichunk < nchunks; ++ichunk) {
+      gather_chunk(ichunk);
+      run_chunk();
+      store_chunk(ichunk);
+   }
+}
 
-     // Do shortwave cloud optics calculations
-     yakl::memset(cld_tau_gpt_sw, 0.);
-     yakl::memset(cld_ssa_gpt_sw, 0.);
-     yakl::memset(cld_asm_gpt_sw, 0.);
+// Rescale the stored shortwave tendencies to the solar zenith angle at m_time
+void Radiation::refresh_zenith_angle() {
+   lw_computed = false;
+   sw_computed = do_short_wave_rad && (static_cast<int>(m_cosz_sw.size()) == ncol_local);
+   if (!sw_computed || ncol_local == 0) return;
+
+   set_cosine_solar_zenith_angle();
+
+   // Absorbed shortwave is taken proportional to the incoming flux at the
+   // top, i.e. to the cosine of the zenith angle; once the sun has set in a
+   // column it gets no shortwave heating until the next shortwave call
+   realHost1d scale_host("scale_host", ncol_local);
+   for (int icol = 0; icol < ncol_local; ++icol) {
+      const Real cosz_old = m_cosz_sw[icol];
+      const Real cosz_new = m_cosz[icol];
+      scale_host(icol+1) = (cosz_old > 0. && cosz_new > 0.) ? cosz_new/cosz_old : 0.;
+      m_cosz_sw[icol] = cosz_new;
+   }
+   scale_host.deep_copy_to(sw_scale);
 
+   parallel_for(SimpleBounds<2>(ncol_local, nlev), YAKL_LAMBDA (int icol, int ilev) {
+     theta_tend_sw(icol,ilev) *= sw_scale(icol);
+   });
+}
+
+// run radiation model on the batch of columns in the input arrays
+void Radiation::run_chunk() {
+   // For loops over diagnostic calls
+   //bool active_calls(0:N_DIAG)
+
+   // Cloud properties needed by both the shortwave and the longwave
+   if (sw_computed || lw_computed) {
      // set cloud fraction to be 1, and snow fraction 0
      yakl::memset(cldfsnow, 0.0);
      yakl::memset(cld, 1.0);
@@ -318,61 +601,30 @@ void Radiation::run() {
 
      m2005_effradius(qc, qc, qi, qi, qt, qt, cld, pmid, tmid,
                      rel, rei, dei, lambdac, mu, des);
+   }
 
-     optics.get_cloud_optics_sw(ncol, nlev, nswbands, do_snow_optics, cld,
-                                cldfsnow, iclwp, iciwp, icswp,
-                                lambdac, mu, dei, des, rel, rei,
-                                cld_tau_bnd_sw, cld_ssa_bnd_sw, cld_asm_bnd_sw,
-                                liq_tau_bnd_sw, ice_tau_bnd_sw, snw_tau_bnd_sw);
-
-     // Now reorder bands to be consistent with RRTMGP
-     // We need to fix band ordering because the old input files assume RRTMG
-     // band ordering, but this has changed in RRTMGP.
-     // TODO: fix the input files themselves!
-     real1d cld_tau_bnd_sw_1d("cld_tau_bnd_sw_1d", nswbands);
-     real1d cld_ssa_bnd_sw_1d("cld_ssa_bnd_sw_1d", nswbands);
-     real1d cld_asm_bnd_sw_1d("cld_asm_bnd_sw_1d", nswbands);
-     real1d cld_tau_bnd_sw_o_1d("cld_tau_bnd_sw_1d", nswbands);
-     real1d cld_ssa_bnd_sw_o_1d("cld_ssa_bnd_sw_1d", nswbands);
-     real1d cld_asm_bnd_sw_o_1d("cld_asm_bnd_sw_1d", nswbands);
-
-     parallel_for(SimpleBounds<2>(ncol, nlev), YAKL_LAMBDA (int icol, int ilay) {
-        for (auto ibnd = 1; ibnd <= nswbands; ++ibnd) {
-           cld_tau_bnd_sw_1d(ibnd) = cld_tau_bnd_sw(icol,ilay,ibnd);
-           cld_ssa_bnd_sw_1d(ibnd) = cld_ssa_bnd_sw(icol,ilay,ibnd);
-           cld_asm_bnd_sw_1d(ibnd) = cld_asm_bnd_sw(icol,ilay,ibnd);
-        }
-        internal::reordered(cld_tau_bnd_sw_1d, rrtmg_to_rrtmgp, cld_tau_bnd_sw_o_1d);
-        internal::reordered(cld_ssa_bnd_sw_1d, rrtmg_to_rrtmgp, cld_ssa_bnd_sw_o_1d);
-        internal::reordered(cld_asm_bnd_sw_1d, rrtmg_to_rrtmgp, cld_asm_bnd_sw_o_1d);
-        for (auto ibnd = 1; ibnd <= nswbands; ++ibnd) {
-           cld_tau_bnd_sw(icol,ilay,ibnd) = cld_tau_bnd_sw_o_1d(ibnd);
-           cld_ssa_bnd_sw(icol,ilay,ibnd) = cld_ssa_bnd_sw_o_1d(ibnd);
-           cld_asm_bnd_sw(icol,ilay,ibnd) = cld_asm_bnd_sw_o_1d(ibnd);
-        }
-     });
+   // No shortwave heating in a batch without sunlit columns
+   if (sw_computed && nday == 0) {
+      yakl::memset(qrs, 0.);
+      yakl::memset(qrsc, 0.);
+   }
 
-     // And now do the MCICA sampling to get cloud optical properties by
-     // gpoint/cloud state
-     radiation.get_gpoint_bands_sw(gpoint_bands_sw);
-
-     optics.sample_cloud_optics_sw(
-            ncol, nlev, nswgpts, gpoint_bands_sw,
-            pmid, cld, cldfsnow,
-            cld_tau_bnd_sw, cld_ssa_bnd_sw, cld_asm_bnd_sw,
-            cld_tau_gpt_sw, cld_ssa_gpt_sw, cld_asm_gpt_sw);
-
-     // Aerosol needs night indices
-     // TODO: remove this dependency, it's just used to mask aerosol outputs
-     set_daynight_indices(coszrs, day_indices, night_indices);
-     int1d nday("nday",1);
-     int1d nnight("nnight",1);
-     yakl::memset(nday, 0);
-     yakl::memset(nnight, 0);
-     for (auto icol=1; icol<ncol; ++icol) {
-        if (day_indices(icol) > 0) nday(1)++;
-        if (night_indices(icol) > 0) nnight(1)++;
-     }
+   // Do shortwave stuff; the cosine of the solar zenith angle and the
+   // day/night indices of the batch are set by gather_chunk()
+   if (sw_computed && nday > 0) {
+     // Get albedo. This uses CAM routines internally and just provides a
+     // wrapper to improve readability of the code here.
+     set_albedo(coszrs, albedo_dir, albedo_dif);
+
+     // Cloud optical properties by g-point, including the MCICA sampling
+     // of the cloud state. The optics tables use the RRTMG band ordering,
+     // which is mapped to the RRTMGP bands in the same kernel.
+     optics.get_cloud_optics_sw(ncol, nlev, nswbands, nswgpts,
+                                gpoint_bands_sw, rrtmg_to_rrtmgp,
+                                do_snow_optics, cld, cldfsnow, iclwp, iciwp, icswp,
+                                lambdac, mu, dei, des, rel, rei,
+                                cld_tau_gpt_sw, cld_ssa_gpt_sw, cld_asm_gpt_sw,
+                                do_optics_diag, liq_tau_bnd_sw, ice_tau_bnd_sw, snw_tau_bnd_sw);
 
      // get aerosol optics
      do_aerosol_rad = false;
@@ -386,34 +638,23 @@ void Radiation::run() {
            yakl::memset(aer_ssa_bnd_sw, 0.);
            yakl::memset(aer_asm_bnd_sw, 0.);
 
-           real2d clear_rh("clear_rh",ncol, nswbands);
-           yakl::memset(clear_rh, 0.01);
-
            optics.set_aerosol_optics_sw(0, ncol, nlev, nswbands, dt, night_indices,
                              is_cmip6_volc, aer_tau_bnd_sw, aer_ssa_bnd_sw, aer_asm_bnd_sw, clear_rh);
 
-           // Now reorder bands to be consistent with RRTMGP
+           // Now reorder bands to be consistent with RRTMGP, in place with
+           // per-thread copies of the bands of a cell
            // TODO: fix the input files themselves!
-           real1d aer_tau_bnd_sw_1d("cld_tau_bnd_sw_1d", nswbands);
-           real1d aer_ssa_bnd_sw_1d("cld_ssa_bnd_sw_1d", nswbands);
-           real1d aer_asm_bnd_sw_1d("cld_asm_bnd_sw_1d", nswbands);
-           real1d aer_tau_bnd_sw_o_1d("cld_tau_bnd_sw_1d", nswbands);
-           real1d aer_ssa_bnd_sw_o_1d("cld_ssa_bnd_sw_1d", nswbands);
-           real1d aer_asm_bnd_sw_o_1d("cld_asm_bnd_sw_1d", nswbands);
-
            parallel_for(SimpleBounds<2>(ncol, nlev), YAKL_LAMBDA (int icol, int ilay) {
-             for (auto ibnd = 1; ibnd < nswbands; ++ibnd) {
-                aer_tau_bnd_sw_1d(ibnd) = aer_tau_bnd_sw(icol,ilay,ibnd);
-                aer_ssa_bnd_sw_1d(ibnd) = aer_ssa_bnd_sw(icol,ilay,ibnd);
-                aer_asm_bnd_sw_1d(ibnd) = aer_asm_bnd_sw(icol,ilay,ibnd);
+             real tau_c[RadConstants::nswbands], ssa_c[RadConstants::nswbands], asm_c[RadConstants::nswbands];
+             for (auto ibnd = 1; ibnd <= RadConstants::nswbands; ++ibnd) {
+                tau_c[ibnd-1] = aer_tau_bnd_sw(icol,ilay,ibnd);
+                ssa_c[ibnd-1] = aer_ssa_bnd_sw(icol,ilay,ibnd);
+                asm_c[ibnd-1] = aer_asm_bnd_sw(icol,ilay,ibnd);
              }
-             internal::reordered(aer_tau_bnd_sw_1d, rrtmg_to_rrtmgp, aer_tau_bnd_sw_o_1d);
-             internal::reordered(aer_ssa_bnd_sw_1d, rrtmg_to_rrtmgp, aer_ssa_bnd_sw_o_1d);
-             internal::reordered(aer_asm_bnd_sw_1d, rrtmg_to_rrtmgp, aer_asm_bnd_sw_o_1d);
-             for (auto ibnd = 1; ibnd < nswbands; ++ibnd) {
-                aer_tau_bnd_sw(icol,ilay,ibnd) = aer_tau_bnd_sw_o_1d(ibnd);
-                aer_ssa_bnd_sw(icol,ilay,ibnd) = aer_ssa_bnd_sw_o_1d(ibnd);
-                aer_asm_bnd_sw(icol,ilay,ibnd) = aer_asm_bnd_sw_o_1d(ibnd);
+             for (auto ibnd = 1; ibnd <= RadConstants::nswbands; ++ibnd) {
+                aer_tau_bnd_sw(icol,ilay,ibnd) = tau_c[rrtmg_to_rrtmgp(ibnd)-1];
+                aer_ssa_bnd_sw(icol,ilay,ibnd) = ssa_c[rrtmg_to_rrtmgp(ibnd)-1];
+                aer_asm_bnd_sw(icol,ilay,ibnd) = asm_c[rrtmg_to_rrtmgp(ibnd)-1];
              }
           });
         } else {
@@ -422,50 +663,27 @@ void Radiation::run() {
            yakl::memset(aer_asm_bnd_sw, 0.);
         }
 
-        yakl::memset(cld_tau_gpt_sw, 0.);
-        yakl::memset(cld_ssa_gpt_sw, 0.);
-        yakl::memset(cld_asm_gpt_sw, 0.);
-
         // Call the shortwave radiation driver
         radiation_driver_sw(
                   ncol, gas_vmr,
                   pmid, pint, tmid, albedo_dir, albedo_dif, coszrs,
                   cld_tau_gpt_sw, cld_ssa_gpt_sw, cld_asm_gpt_sw,
                   aer_tau_bnd_sw, aer_ssa_bnd_sw, aer_asm_bnd_sw,
-                  fluxes_allsky, fluxes_clrsky, qrs, qrsc);
-     }
-   } else {
-      // Conserve energy
-     if (conserve_energy) {
-       parallel_for(SimpleBounds<2>(ncol, nlev), YAKL_LAMBDA (int icol, int ilev) {
-           qrs(icol,ilev) = qrs(icol,ilev)/pdel(icol,ilev); });
+                  sw_fluxes_allsky, sw_fluxes_clrsky, qrs, qrsc);
      }
   }  // dosw
 
   // Do longwave stuff...
-  if (do_long_wave_rad) {
-    // Allocate longwave outputs; why is this not part of the
-    // fluxes_t object?
-    FluxesByband fluxes_allsky, fluxes_clrsky;
-    internal::initial_fluxes(ncol, nlev, nlwbands, fluxes_allsky);
-    internal::initial_fluxes(ncol, nlev, nlwbands, fluxes_clrsky);
-
+  if (lw_computed) {
     // NOTE: fluxes defined at interfaces, so initialize to have vertical
     // dimension nlev_rad+1
 
-    yakl::memset(cld_tau_gpt_lw, 0.);
-
+    // Cloud absorption optical depth by g-point, including the MCICA sampling
     optics.get_cloud_optics_lw(
-            ncol, nlev, nlwbands, do_snow_optics, cld, cldfsnow, iclwp, iciwp, icswp,
-            lambdac, mu, dei, des, rei,
-            cld_tau_bnd_lw, liq_tau_bnd_lw, ice_tau_bnd_lw, snw_tau_bnd_lw);
-
-    radiation.get_gpoint_bands_lw(gpoint_bands_lw);
-
-    optics.sample_cloud_optics_lw(
-            ncol, nlev, nlwgpts, gpoint_bands_lw,
-            pmid, cld, cldfsnow,
-            cld_tau_bnd_lw, cld_tau_gpt_lw);
+            ncol, nlev, nlwbands, nlwgpts, gpoint_bands_lw,
+            do_snow_optics, cld, cldfsnow, iclwp, iciwp, icswp,
+            lambdac, mu, dei, des, rei, cld_tau_gpt_lw,
+            do_optics_diag, liq_tau_bnd_lw, ice_tau_bnd_lw, snw_tau_bnd_lw);
 
     // Loop over diagnostic calls
     for (auto icall = ngas; /*N_DIAG;*/ icall > 0; --icall) {
@@ -482,31 +700,12 @@ void Radiation::run() {
 
        // Call the longwave radiation driver to calculate fluxes and heating rates
        radiation_driver_lw(ncol, nlev, gas_vmr, pmid, pint, tmid, tint, cld_tau_gpt_lw, aer_tau_bnd_lw,
-                           fluxes_allsky, fluxes_clrsky, qrl, qrlc);
+                           lw_fluxes_allsky, lw_fluxes_clrsky, qrl, qrlc);
     }
-  }
-  else {
-    // Conserve energy (what does this mean exactly?)
-    if (conserve_energy) {
-       parallel_for(SimpleBounds<2>(ncol, nlev), YAKL_LAMBDA (int icol, int ilev) {
-         qrl(icol,ilev) = qrl(icol,ilev)/pdel(icol,ilev);
-       });
-   }
-
- } // dolw
-
- // Compute heating rate for dtheta/dt
-  parallel_for(SimpleBounds<2>(ncol, nlev), YAKL_LAMBDA (int icol, int ilay) {
-    hr(icol,ilay) = (qrs(icol,ilay) + qrl(icol,ilay)) / Cp_d * (1.e5 / std::pow(pmid(icol,ilay), R_d/Cp_d));
- });
+  } // dolw
 
- // convert radiative heating rates to Q*dp for energy conservation
- if (conserve_energy) {
-   parallel_for(SimpleBounds<2>(ncol, nlev), YAKL_LAMBDA (int icol, int ilev) {
-      qrs(icol,ilev) = qrs(icol,ilev)*pdel(icol,ilev);
-      qrl(icol,ilev) = qrl(icol,ilev)*pdel(icol,ilev);
-   });
- }
+  // The heating rates of a band that is not computed in this call keep their
+  // previous values; on_complete() only exports the bands computed here
 }
 
 void Radiation::radiation_driver_sw(int ncol, const real3d& gas_vmr,
@@ -517,37 +716,6 @@ void Radiation::radiation_driver_sw(int ncol, const real3d& gas_vmr,
            FluxesByband& fluxes_clrsky, FluxesByband& fluxes_allsky, const real2d& qrs,
            const real2d& qrsc)
 {
-   // Incoming solar radiation, scaled for solar zenith angle
-   // and earth-sun distance
-   real2d solar_irradiance_by_gpt("solar_irradiance_by_gpt",ncol,nswgpts);
-
-   // Gathered indicies of day and night columns
-   // chunk_column_index = day_indices(daylight_column_index)
-   int1d day_indices("day_indices",ncol), night_indices("night_indices", ncol);   // Indicies of daylight coumns
-
-   real1d coszrs_day("coszrs_day", ncol);
-   real2d albedo_dir_day("albedo_dir_day", nswbands, ncol), albedo_dif_day("albedo_dif_day", nswbands, ncol);
-   real2d pmid_day("pmid_day", ncol, nlev);
-   real2d tmid_day("tmid_day", ncol, nlev);
-   real2d pint_day("pint_day", ncol, nlev+1);
-
-   real3d gas_vmr_day("gas_vmr_day", ngas, ncol, nlev);
-   real3d gas_vmr_rad("gas_vmr_rad", ngas, ncol, nlev);
-
-   real3d cld_tau_gpt_day("cld_tau_gpt_day", ncol, nlev, nswgpts);
-   real3d cld_ssa_gpt_day("cld_ssa_gpt_day", ncol, nlev, nswgpts);
-   real3d cld_asm_gpt_day("cld_asm_gpt_day", ncol, nlev, nswgpts);
-   real3d aer_tau_bnd_day("aer_tau_bnd_day", ncol, nlev, nswbands);
-   real3d aer_ssa_bnd_day("aer_ssa_bnd_day", ncol, nlev, nswbands);
-   real3d aer_asm_bnd_day("aer_asm_bnd_day", ncol, nlev, nswbands);
-
-   real3d cld_tau_gpt_rad("cld_tau_gpt_rad", ncol, nlev+1, nswgpts);
-   real3d cld_ssa_gpt_rad("cld_ssa_gpt_rad", ncol, nlev+1, nswgpts);
-   real3d cld_asm_gpt_rad("cld_asm_gpt_rad", ncol, nlev+1, nswgpts);
-   real3d aer_tau_bnd_rad("aer_tau_bnd_rad", ncol, nlev+1, nswgpts);
-   real3d aer_ssa_bnd_rad("aer_ssa_bnd_rad", ncol, nlev+1, nswgpts);
-   real3d aer_asm_bnd_rad("aer_asm_bnd_rad", ncol, nlev+1, nswgpts);
-
    // Scaling factor for total sky irradiance; used to account for orbital
    // eccentricity, and could be used to scale total sky irradiance for different
    // climates as well (i.e., paleoclimate simulations)
@@ -555,7 +723,7 @@ void Radiation::radiation_driver_sw(int ncol, const real3d& gas_vmr,
 
    if (fixed_total_solar_irradiance<0) {
       // Get orbital eccentricity factor to scale total sky irradiance
- //     tsi_scaling = get_eccentricity_factor();
+      tsi_scaling = m_eccf;
    } else {
       // For fixed TSI we divide by the default solar constant of 1360.9
       // At some point we will want to replace this with a method that
@@ -567,25 +735,13 @@ void Radiation::radiation_driver_sw(int ncol, const real3d& gas_vmr,
    // do the shortwave radiative transfer during the daytime to save
    // computational cost (and because RRTMGP will fail for cosine solar zenith
    // angles less than or equal to zero)
-   set_daynight_indices(coszrs, day_indices, night_indices);
-   int1d nday("nday",1);
-   int1d nnight("nnight", 1);
-   yakl::memset(nday, 0);
-   yakl::memset(nnight, 0);
-   parallel_for(SimpleBounds<1>(ncol), YAKL_LAMBDA (int icol) {
-     if (day_indices(icol) > 0) nday(1)++;
-     if (night_indices(icol) > 0) nnight(1)++;
-   });
-
+   // chunk_column_index = day_indices(daylight_column_index); the indices
+   // of the batch are set by gather_chunk()
    intHost1d num_day("num_day",1);
-   intHost1d num_night("num_night",1);
-   nday.deep_copy_to(num_day);
-   nnight.deep_copy_to(num_night);
+   num_day(1) = nday;
 
    // If no daytime columns in this chunk, then we return zeros
    if (num_day(1) == 0) {
-//    reset_fluxes(fluxes_allsky)
-//    reset_fluxes(fluxes_clrsky)
       yakl::memset(qrs, 0.);
       yakl::memset(qrsc, 0.);
       return;
@@ -617,48 +773,57 @@ void Radiation::radiation_driver_sw(int ncol, const real3d& gas_vmr,
    // NOTE: fluxes defined at interfaces, so initialize to have vertical
    // dimension nlev_rad+1, while we initialized the RRTMGP input variables to
    // have vertical dimension nlev_rad (defined at midpoints).
-   FluxesByband fluxes_clrsky_day, fluxes_allsky_day;
-   internal::initial_fluxes(num_day(1), nlev+1, nswbands, fluxes_allsky_day);
-   internal::initial_fluxes(num_day(1), nlev+1, nswbands, fluxes_clrsky_day);
+   // The daytime fluxes are sized by the number of daytime columns, so they
+   // are only reallocated when that number changes.
+   if (num_day(1) != nday_fluxes) {
+      internal::initial_fluxes(num_day(1), nlev+1, nswbands, sw_fluxes_allsky_day);
+      internal::initial_fluxes(num_day(1), nlev+1, nswbands, sw_fluxes_clrsky_day);
+      nday_fluxes = num_day(1);
+   }
 
    // Add an empty level above model top
    // TODO: combine with day compression above
-   yakl::memset(cld_tau_gpt_rad, 0.);
-   yakl::memset(cld_ssa_gpt_rad, 0.);
-   yakl::memset(cld_asm_gpt_rad, 0.);
+   yakl::memset(cld_tau_gpt_rad_sw, 0.);
+   yakl::memset(cld_ssa_gpt_rad_sw, 0.);
+   yakl::memset(cld_asm_gpt_rad_sw, 0.);
 
-   yakl::memset(aer_tau_bnd_rad, 0.);
-   yakl::memset(aer_ssa_bnd_rad, 0);
-   yakl::memset(aer_asm_bnd_rad, 0.);
+   yakl::memset(aer_tau_bnd_rad_sw, 0.);
+   yakl::memset(aer_ssa_bnd_rad_sw, 0);
+   yakl::memset(aer_asm_bnd_rad_sw, 0.);
 
    parallel_for(SimpleBounds<3>(num_day(1), nlev, nswgpts), YAKL_LAMBDA (int iday, int ilev, int igpt) {
-      cld_tau_gpt_rad(iday,ilev,igpt) = cld_tau_gpt_day(iday,ilev,igpt);
-      cld_ssa_gpt_rad(iday,ilev,igpt) = cld_ssa_gpt_day(iday,ilev,igpt);
-      cld_asm_gpt_rad(iday,ilev,igpt) = cld_asm_gpt_day(iday,ilev,igpt);
-      gas_vmr_rad(igpt,iday,1) = gas_vmr_day(igpt,iday,1);
-      gas_vmr_rad(igpt,iday,ilev) = gas_vmr_day(igpt,iday,ilev);
+      cld_tau_gpt_rad_sw(iday,ilev,igpt) = cld_tau_gpt_day(iday,ilev,igpt);
+      cld_ssa_gpt_rad_sw(iday,ilev,igpt) = cld_ssa_gpt_day(iday,ilev,igpt);
+      cld_asm_gpt_rad_sw(iday,ilev,igpt) = cld_asm_gpt_day(iday,ilev,igpt);
+      gas_vmr_rad_sw(igpt,iday,1) = gas_vmr_day(igpt,iday,1);
+      gas_vmr_rad_sw(igpt,iday,ilev) = gas_vmr_day(igpt,iday,ilev);
    });
 
    parallel_for(SimpleBounds<3>(num_day(1), nlev, nswbands), YAKL_LAMBDA (int iday, int ilev, int ibnd) {
-      aer_tau_bnd_rad(iday,ilev,ibnd) = aer_tau_bnd_day(iday,ilev,ibnd);
-      aer_ssa_bnd_rad(iday,ilev,ibnd) = aer_ssa_bnd_day(iday,ilev,ibnd);
-      aer_asm_bnd_rad(iday,ilev,ibnd) = aer_asm_bnd_day(iday,ilev,ibnd);
+      aer_tau_bnd_rad_sw(iday,ilev,ibnd) = aer_tau_bnd_day(iday,ilev,ibnd);
+      aer_ssa_bnd_rad_sw(iday,ilev,ibnd) = aer_ssa_bnd_day(iday,ilev,ibnd);
+      aer_asm_bnd_rad_sw(iday,ilev,ibnd) = aer_asm_bnd_day(iday,ilev,ibnd);
    });
 
    // Do shortwave radiative transfer calculations
    radiation.run_shortwave_rrtmgp( ngas, num_day(1), nlev,
-      gas_vmr_rad, pmid,
+      gas_vmr_rad_sw, pmid,
       tmid_day, pint_day, coszrs_day, albedo_dir_day, albedo_dif_day,
-      cld_tau_gpt_rad, cld_ssa_gpt_rad, cld_asm_gpt_rad, aer_tau_bnd_rad, aer_ssa_bnd_rad, aer_asm_bnd_rad,
-      fluxes_allsky_day.flux_up    , fluxes_allsky_day.flux_dn    , fluxes_allsky_day.flux_net    , fluxes_allsky_day.flux_dn_dir    ,
-      fluxes_allsky_day.bnd_flux_up, fluxes_allsky_day.bnd_flux_dn, fluxes_allsky_day.bnd_flux_net, fluxes_allsky_day.bnd_flux_dn_dir,
-      fluxes_clrsky_day.flux_up    , fluxes_clrsky_day.flux_dn    , fluxes_clrsky_day.flux_net    , fluxes_clrsky_day.flux_dn_dir    ,
-      fluxes_clrsky_day.bnd_flux_up, fluxes_clrsky_day.bnd_flux_dn, fluxes_clrsky_day.bnd_flux_net, fluxes_clrsky_day.bnd_flux_dn_dir,
+      cld_tau_gpt_rad_sw, cld_ssa_gpt_rad_sw, cld_asm_gpt_rad_sw, aer_tau_bnd_rad_sw, aer_ssa_bnd_rad_sw, aer_asm_bnd_rad_sw,
+      sw_fluxes_allsky_day.flux_up    , sw_fluxes_allsky_day.flux_dn    , sw_fluxes_allsky_day.flux_net    , sw_fluxes_allsky_day.flux_dn_dir    ,
+      sw_fluxes_allsky_day.bnd_flux_up, sw_fluxes_allsky_day.bnd_flux_dn, sw_fluxes_allsky_day.bnd_flux_net, sw_fluxes_allsky_day.bnd_flux_dn_dir,
+      sw_fluxes_clrsky_day.flux_up    , sw_fluxes_clrsky_day.flux_dn    , sw_fluxes_clrsky_day.flux_net    , sw_fluxes_clrsky_day.flux_dn_dir    ,
+      sw_fluxes_clrsky_day.bnd_flux_up, sw_fluxes_clrsky_day.bnd_flux_dn, sw_fluxes_clrsky_day.bnd_flux_net, sw_fluxes_clrsky_day.bnd_flux_dn_dir,
       tsi_scaling);
 
-   // Expand fluxes from daytime-only arrays to full chunk arrays
-   internal::expand_day_fluxes(fluxes_allsky_day, fluxes_allsky, day_indices);
-   internal::expand_day_fluxes(fluxes_clrsky_day, fluxes_clrsky, day_indices);
+   // Expand fluxes from daytime-only arrays to full chunk arrays; the night
+   // columns get zero fluxes and hence no heating
+   yakl::memset(fluxes_allsky.flux_up, 0.);
+   yakl::memset(fluxes_allsky.flux_dn, 0.);
+   yakl::memset(fluxes_clrsky.flux_up, 0.);
+   yakl::memset(fluxes_clrsky.flux_dn, 0.);
+   internal::expand_day_fluxes(sw_fluxes_allsky_day, fluxes_allsky, day_indices, num_day(1));
+   internal::expand_day_fluxes(sw_fluxes_clrsky_day, fluxes_clrsky, day_indices, num_day(1));
 
    // Calculate heating rates
    calculate_heating_rate(fluxes_allsky.flux_up,
@@ -675,41 +840,20 @@ void Radiation::radiation_driver_lw(int ncol, int nlev,
                                   const real2d& pmid, const real2d& pint, const real2d& tmid, const real2d& tint,
                                   const real3d& cld_tau_gpt, const real3d& aer_tau_bnd, FluxesByband& fluxes_clrsky,
                                   FluxesByband& fluxes_allsky, const real2d& qrl, const real2d& qrlc) {
-   real3d cld_tau_gpt_rad("cld_tau_gpt_rad", ncol, nlev+1, nlwgpts);
-   real3d aer_tau_bnd_rad("aer_tau_bnd-rad", ncol, nlev+1, nlwgpts);
-
-   // Surface emissivity needed for longwave
-   real2d surface_emissivity("surface_emissivity", nlwbands, ncol);
-
-   // Temporary heating rates on radiation vertical grid
-   real2d qrl_rad("qrl_rad", ncol, nlev);
-   real2d qrlc_rad("qrlc_rad", ncol, nlev);
-
-   int ngas;
-   real3d gas_vmr_rad("gas_vmr_rad", ngas, ncol, nlev);
-
-   // Set surface emissivity to 1 here. There is a note in the RRTMG
-   // implementation that this is treated in the land model, but the old
-   // RRTMG implementation also sets this to 1. This probably does not make
-   // a lot of difference either way, but if a more intelligent value
-   // exists or is assumed in the model we should use it here as well.
-   // TODO: set this more intelligently?
-   yakl::memset(surface_emissivity, 1.0);
-
    // Add an empty level above model top
-   yakl::memset(cld_tau_gpt_rad, 0.);
-   yakl::memset(aer_tau_bnd_rad, 0.);
+   yakl::memset(cld_tau_gpt_rad_lw, 0.);
+   yakl::memset(aer_tau_bnd_rad_lw, 0.);
 
    parallel_for(SimpleBounds<3>(ncol, nlev, nswgpts), YAKL_LAMBDA (int icol, int ilev, int igpt) {
-     cld_tau_gpt_rad(icol,ilev,igpt) = cld_tau_gpt(icol,ilev,igpt);
-     aer_tau_bnd_rad(icol,ilev,igpt) = aer_tau_bnd(icol,ilev,igpt);
-     gas_vmr_rad(igpt,icol,ilev) = gas_vmr(igpt,icol,ilev);
+     cld_tau_gpt_rad_lw(icol,ilev,igpt) = cld_tau_gpt(icol,ilev,igpt);
+     aer_tau_bnd_rad_lw(icol,ilev,igpt) = aer_tau_bnd(icol,ilev,igpt);
+     gas_vmr_rad_lw(igpt,icol,ilev) = gas_vmr(igpt,icol,ilev);
    });
 
    // Do longwave radiative transfer calculations
    radiation.run_longwave_rrtmgp(ngas, ncol, nlev,
-       gas_vmr_rad, pmid, tmid, pint, tint,
-       surface_emissivity, cld_tau_gpt_rad, aer_tau_bnd_rad,
+       gas_vmr_rad_lw, pmid, tmid, pint, tint,
+       surface_emissivity, cld_tau_gpt_rad_lw, aer_tau_bnd_rad_lw,
        fluxes_allsky.flux_up    , fluxes_allsky.flux_dn    , fluxes_allsky.flux_net    ,
        fluxes_allsky.bnd_flux_up, fluxes_allsky.bnd_flux_dn, fluxes_allsky.bnd_flux_net,
        fluxes_clrsky.flux_up    , fluxes_clrsky.flux_dn    , fluxes_clrsky.flux_net    ,
@@ -731,33 +875,33 @@ void Radiation::radiation_driver_lw(int ncol, int nlev,
    });
 }
 
-// Initialize array of daytime indices to be all zero. If any zeros exist when
-// we are done, something went wrong.
-void Radiation::set_daynight_indices(const real1d& coszrs, const int1d& day_indices, const int1d& night_indices) {
+// Compact the sunlit and the dark columns of the batch into day_indices and
+// night_indices; unused entries are zero
+int Radiation::set_daynight_indices(const realHost1d& coszrs, const int1d& day_indices, const int1d& night_indices) {
    // Loop over columns and identify daytime columns as those where the cosine
-   // solar zenith angle exceeds zero. Note that we wrap the setting of
-   // day_indices in an if-then to make sure we are not accesing day_indices out
-   // of bounds, and stopping with an informative error message if we do for some reason.
-   int1d iday("iday", 1);
-   int1d inight("inight",1);
-   yakl::memset(iday, 0);
-   yakl::memset(inight, 0);
-   yakl::memset(day_indices, 0);
-   yakl::memset(night_indices, 0);
-   parallel_for(SimpleBounds<1>(ncol), YAKL_LAMBDA (int icol) {
+   // solar zenith angle exceeds zero. The compaction is done on the host so
+   // that the columns keep their order.
+   intHost1d day_host("day_host", ncol);
+   intHost1d night_host("night_host", ncol);
+   int iday = 0;
+   int inight = 0;
+   for (int icol = 1; icol <= ncol; ++icol) {
+      day_host(icol) = 0;
+      night_host(icol) = 0;
+   }
+   for (int icol = 1; icol <= ncol; ++icol) {
       if (coszrs(icol) > 0.) {
-         iday(1) += 1;
-         day_indices(iday(1)) = icol;
+         day_host(++iday) = icol;
       } else {
-         inight(1) += 1;
-         night_indices(inight(1)) = icol;
+         night_host(++inight) = icol;
       }
-   });
+   }
+   day_host.deep_copy_to(day_indices);
+   night_host.deep_copy_to(night_indices);
+   return iday;
 }
 
 void Radiation::get_gas_vmr(const std::vector<std::string>& gas_names, const real3d& gas_vmr) {
-    // Mass mixing ratio
-    real2d mmr("mmr", ncol, nlev);
     // Gases and molecular weights. Note that we do NOT have CFCs yet (I think
     // this is coming soon in RRTMGP). RRTMGP also allows for absorption due to
     // CO and N2, which RRTMG did not have.
@@ -833,6 +977,69 @@ void Radiation::calculate_heating_rate(const real2d& flux_up, const real2d& flux
   });
 }
 
-// call back
-void Radiation::on_complete() { }
+// export the heating rates of the bands computed in the last call to run()
+void Radiation::on_complete(MultiFab& qheating_rates) {
+   const bool l_sw = sw_computed;
+   const bool l_lw = lw_computed;
+   if (!l_sw && !l_lw) return;
+
+   const int r = m_crse_ratio;
+
+   for ( MFIter mfi(qheating_rates, false); mfi.isValid(); ++mfi) {
+     auto q_arr = qheating_rates.array(mfi);
+
+     const int off = m_col_offset[mfi.LocalIndex()];
+     const auto& vbx = mfi.validbox();
+     const int klo = vbx.smallEnd(2);
 
+     if (r == 1) {
+       const int nx  = vbx.length(0);
+       const int ilo = vbx.smallEnd(0);
+       const int jlo = vbx.smallEnd(1);
+
+       // Scatter the tendencies of the packed columns back to (i,j,k)
+       amrex::ParallelFor( vbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+         auto icol = off + (j-jlo)*nx + (i-ilo) + 1;
+         auto ilev = k - klo + 1;
+         if (l_sw) q_arr(i,j,k,0) = theta_tend_sw(icol,ilev);
+         if (l_lw) q_arr(i,j,k,1) = theta_tend_lw(icol,ilev);
+       });
+     } else {
+       const auto& crse_bx = amrex::coarsen(vbx, IntVect(r,r,1));
+       const int cilo = crse_bx.smallEnd(0), cihi = crse_bx.bigEnd(0);
+       const int cjlo = crse_bx.smallEnd(1), cjhi = crse_bx.bigEnd(1);
+       const int ilo = vbx.smallEnd(0), ihi = vbx.bigEnd(0);
+       const int jlo = vbx.smallEnd(1), jhi = vbx.bigEnd(1);
+
+       // Correction that makes the mean of the interpolated tendencies over
+       // each r x r block equal to the tendency of its coarse column
+       amrex::ParallelFor( crse_bx, [=] AMREX_GPU_DEVICE (int ic, int jc, int k) {
+         const int icol = off + (jc-cjlo)*(cihi-cilo+1) + (ic-cilo) + 1;
+         const int ilev = k - klo + 1;
+         Real sum_sw = 0.0, sum_lw = 0.0;
+         int  nsum = 0;
+         for (int j = amrex::max(jc*r, jlo); j <= amrex::min(jc*r+r-1, jhi); ++j) {
+           for (int i = amrex::max(ic*r, ilo); i <= amrex::min(ic*r+r-1, ihi); ++i) {
+             if (l_sw) sum_sw += internal::interp_column(theta_tend_sw, off, cilo, cihi, cjlo, cjhi, r, i, j, ilev);
+             if (l_lw) sum_lw += internal::interp_column(theta_tend_lw, off, cilo, cihi, cjlo, cjhi, r, i, j, ilev);
+             ++nsum;
+           }
+         }
+         if (l_sw) theta_corr_sw(icol,ilev) = theta_tend_sw(icol,ilev) - sum_sw/nsum;
+         if (l_lw) theta_corr_lw(icol,ilev) = theta_tend_lw(icol,ilev) - sum_lw/nsum;
+       });
+
+       // Interpolate the coarse column tendencies to (i,j,k)
+       amrex::ParallelFor( vbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+         const int ic = (i >= 0) ? i/r : (i+1)/r - 1;
+         const int jc = (j >= 0) ? j/r : (j+1)/r - 1;
+         const int icol = off + (jc-cjlo)*(cihi-cilo+1) + (ic-cilo) + 1;
+         const int ilev = k - klo + 1;
+         if (l_sw) q_arr(i,j,k,0) = internal::interp_column(theta_tend_sw, off, cilo, cihi, cjlo, cjhi, r, i, j, ilev)
+                                  + theta_corr_sw(icol,ilev);
+         if (l_lw) q_arr(i,j,k,1) = internal::interp_column(theta_tend_lw, off, cilo, cihi, cjlo, cjhi, r, i, j, ilev)
+                                  + theta_corr_lw(icol,ilev);
+       });
+     }
+   }
+}
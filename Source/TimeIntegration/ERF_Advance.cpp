@@ -107,6 +107,11 @@ ERF::Advance (int lev, Real time, Real dt_lev, int /*iteration*/, int /*ncycle*/
     MultiFab source(ba,dm,nvars,1);
     source.setVal(0.0);
 
+#if defined(ERF_USE_RRTMGP)
+    // Radiative heating from the last radiation call
+    add_radiative_heating(lev, S_old, source);
+#endif
+
     // We don't need to call FillPatch on cons_mf because we have fillpatch'ed S_old above
     MultiFab cons_mf(ba,dm,nvars,S_old.nGrowVect());
     MultiFab::Copy(cons_mf,S_old,0,0,S_old.nComp(),S_old.nGrowVect());
@@ -17,6 +17,67 @@
 
 using namespace amrex;
 
+namespace {
+
+/**
+ * Damping factor of one sponge layer at index ii along its direction;
+ * zero outside the layer
+ */
+AMREX_GPU_DEVICE AMREX_FORCE_INLINE
+Real
+SpongeFactor (int ii, Real offset, Real dx, Real bound, Real width, bool hi, Real strength)
+{
+    const Real x = (ii + offset) * dx;
+    if (hi ? (x > bound) : (x < bound)) {
+        const Real xi = hi ? (x - bound) / width : (bound - x) / width;
+        return strength * xi * xi;
+    }
+    return 0.0;
+}
+
+/**
+ * Part of box bx that can lie in the sponge layer on side hi of direction dir.
+ * The layer test is still done pointwise, so the bound only needs to be conservative.
+ */
+Box
+SpongeBox (const Box& bx, const Box& domain, int dir, bool hi, Real bound, Real dx)
+{
+    Box sbx(bx);
+    if (hi) {
+        // (ii+1)*dx > bound for any point in the layer
+        int ilo = static_cast<int>(std::floor(bound/dx)) - 1;
+        if (ilo > domain.smallEnd(dir)) sbx.setSmall(dir, amrex::max(sbx.smallEnd(dir), ilo));
+    } else {
+        // ii*dx < bound for any point in the layer
+        int ihi = static_cast<int>(std::floor(bound/dx));
+        if (ihi < domain.bigEnd(dir)) sbx.setBig(dir, amrex::min(sbx.bigEnd(dir), ihi));
+    }
+    return sbx;
+}
+
+} // namespace
+
+/**
+ * Function for applying the sponge zone damping to the RHS of density and momentum.
+ *
+ * Each active sponge layer only loops over the part of the tile it can reach, so
+ * tiles away from all the layers do no work here.
+ *
+ * @param[in]  spongeChoice container of sponge parameters
+ * @param[in]  geom geometry of the current level
+ * @param[in]  tbx nodal x box for x-mom
+ * @param[in]  tby nodal y box for y-mom
+ * @param[in]  tbz nodal z box for z-mom
+ * @param[out] rho_u_rhs RHS for x-mom
+ * @param[out] rho_v_rhs RHS for y-mom
+ * @param[out] rho_w_rhs RHS for z-mom
+ * @param[in]  rho_u x-mom
+ * @param[in]  rho_v y-mom
+ * @param[in]  rho_w z-mom
+ * @param[in]  bx cell center box
+ * @param[out] cell_rhs RHS for cell center vars
+ * @param[in]  cell_data conserved cell center vars
+ */
 void
 ApplySpongeZoneBCs (
   const SpongeChoice& spongeChoice,
@@ -61,12 +122,6 @@ ApplySpongeZoneBCs (
 
     // Domain valid box
     const amrex::Box& domain = geom.Domain();
-    int domlo_x = domain.smallEnd(0);
-    int domhi_x = domain.bigEnd(0) + 1;
-    int domlo_y = domain.smallEnd(1);
-    int domhi_y = domain.bigEnd(1) + 1;
-    int domlo_z = domain.smallEnd(2);
-    int domhi_z = domain.bigEnd(2) + 1;
 
     if(use_xlo_sponge_damping)AMREX_ALWAYS_ASSERT(xlo_sponge_end   > ProbLoArr[0]);
     if(use_xhi_sponge_damping)AMREX_ALWAYS_ASSERT(xhi_sponge_start < ProbHiArr[0]);
@@ -75,241 +130,69 @@ ApplySpongeZoneBCs (
     if(use_zlo_sponge_damping)AMREX_ALWAYS_ASSERT(zlo_sponge_end   > ProbLoArr[2]);
     if(use_zhi_sponge_damping)AMREX_ALWAYS_ASSERT(zhi_sponge_start < ProbHiArr[2]);
 
-    ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
-    {
-        int ii = amrex::min(amrex::max(i, domlo_x), domhi_x);
-        int jj = amrex::min(amrex::max(j, domlo_y), domhi_y);
-        int kk = amrex::min(amrex::max(k, domlo_z), domhi_z);
-
-        Real x = (ii+0.5) * dx[0];
-        Real y = (jj+0.5) * dx[1];
-        Real z = (kk+0.5) * dx[2];
-
-        // x left sponge
-        if(use_xlo_sponge_damping){
-            if (x < xlo_sponge_end) {
-                Real xi = (xlo_sponge_end - x) / (xlo_sponge_end - ProbLoArr[0]);
-                cell_rhs(i, j, k, 0) -= sponge_strength * xi * xi * (cell_data(i, j, k, 0) - sponge_density);
-            }
-        }
-        // x right sponge
-        if(use_xhi_sponge_damping){
-            if (x > xhi_sponge_start) {
-                Real xi = (x - xhi_sponge_start) / (ProbHiArr[0] - xhi_sponge_start);
-                cell_rhs(i, j, k, 0) -= sponge_strength * xi * xi * (cell_data(i, j, k, 0) - sponge_density);
-            }
-        }
-
-        // y left sponge
-        if(use_ylo_sponge_damping){
-            if (y < ylo_sponge_end) {
-                Real xi = (ylo_sponge_end - y) / (ylo_sponge_end - ProbLoArr[1]);
-                cell_rhs(i, j, k, 0) -= sponge_strength * xi * xi * (cell_data(i, j, k, 0) - sponge_density);
-            }
-        }
-        // x right sponge
-        if(use_yhi_sponge_damping){
-            if (y > yhi_sponge_start) {
-                Real xi = (y - yhi_sponge_start) / (ProbHiArr[1] - yhi_sponge_start);
-                cell_rhs(i, j, k, 0) -= sponge_strength * xi * xi * (cell_data(i, j, k, 0) - sponge_density);
-            }
-        }
-
-        // x left sponge
-        if(use_zlo_sponge_damping){
-            if (z < zlo_sponge_end) {
-                Real xi = (zlo_sponge_end - z) / (zlo_sponge_end - ProbLoArr[2]);
-                cell_rhs(i, j, k, 0) -= sponge_strength * xi * xi * (cell_data(i, j, k, 0) - sponge_density);
-            }
-        }
-        // x right sponge
-        if(use_zhi_sponge_damping){
-            if (z > zhi_sponge_start) {
-                Real xi = (z - zhi_sponge_start) / (ProbHiArr[2] - zhi_sponge_start);
-                cell_rhs(i, j, k, 0) -= sponge_strength * xi * xi * (cell_data(i, j, k, 0) - sponge_density);
-            }
-        }
-    });
-
-    amrex::ParallelFor(tbx, [=] AMREX_GPU_DEVICE(int i, int j, int k)
-    {
-        int ii = amrex::min(amrex::max(i, domlo_x), domhi_x);
-        int jj = amrex::min(amrex::max(j, domlo_y), domhi_y);
-        int kk = amrex::min(amrex::max(k, domlo_z), domhi_z);
-
-        Real x = ii * dx[0];
-        Real y = (jj+0.5) * dx[1];
-        Real z = (kk+0.5) * dx[2];
-
-        // x lo sponge
-        if(use_xlo_sponge_damping){
-            if (x < xlo_sponge_end) {
-                Real xi = (xlo_sponge_end - x) / (xlo_sponge_end - ProbLoArr[0]);
-                rho_u_rhs(i, j, k) -= sponge_strength * xi * xi * (rho_u(i, j, k) - sponge_density*sponge_x_velocity);
-            }
-        }
-        // x hi sponge
-        if(use_xhi_sponge_damping){
-            if (x > xhi_sponge_start) {
-                Real xi = (x - xhi_sponge_start) / (ProbHiArr[0] - xhi_sponge_start);
-                rho_u_rhs(i, j, k) -= sponge_strength * xi * xi * (rho_u(i, j, k) - sponge_density*sponge_x_velocity);
-            }
-        }
-
-        // y lo sponge
-        if(use_ylo_sponge_damping){
-            if (y < ylo_sponge_end) {
-                Real xi = (ylo_sponge_end - y) / (ylo_sponge_end - ProbLoArr[1]);
-                rho_u_rhs(i, j, k) -= sponge_strength * xi * xi * (rho_u(i, j, k) - sponge_density*sponge_x_velocity);
-            }
-        }
-        // x right sponge
-        if(use_yhi_sponge_damping){
-            if (y > yhi_sponge_start) {
-                Real xi = (y - yhi_sponge_start) / (ProbHiArr[1] - yhi_sponge_start);
-                rho_u_rhs(i, j, k) -= sponge_strength * xi * xi * (rho_u(i, j, k) - sponge_density*sponge_x_velocity);
-            }
-        }
-
-        // z lo sponge
-        if(use_zlo_sponge_damping){
-            if (z < zlo_sponge_end) {
-                Real xi = (zlo_sponge_end - z) / (zlo_sponge_end - ProbLoArr[2]);
-                rho_u_rhs(i, j, k) -= sponge_strength * xi * xi * (rho_u(i, j, k) - sponge_density*sponge_x_velocity);
-            }
-        }
-
-
-        // z hi sponge
-        if(use_zhi_sponge_damping){
-            if (z > zhi_sponge_start) {
-                Real xi = (z - zhi_sponge_start) / (ProbHiArr[2] - zhi_sponge_start);
-                rho_u_rhs(i, j, k) -= sponge_strength * xi * xi * (rho_u(i, j, k) - sponge_density*sponge_x_velocity);
-            }
-        }
-    });
-
-
-    amrex::ParallelFor(tby, [=] AMREX_GPU_DEVICE(int i, int j, int k)
-    {
-        int ii = amrex::min(amrex::max(i, domlo_x), domhi_x);
-        int jj = amrex::min(amrex::max(j, domlo_y), domhi_y);
-        int kk = amrex::min(amrex::max(k, domlo_z), domhi_z);
-
-        Real x = (ii+0.5) * dx[0];
-        Real y = jj * dx[1];
-        Real z = (kk+0.5) * dx[2];
-
-        // x lo sponge
-        if(use_xlo_sponge_damping){
-            if (x < xlo_sponge_end) {
-                Real xi = (xlo_sponge_end - x) / (xlo_sponge_end - ProbLoArr[0]);
-                rho_v_rhs(i, j, k) -= sponge_strength * xi * xi * (rho_v(i, j, k) - sponge_density*sponge_y_velocity);
-            }
-        }
-        // x hi sponge
-        if(use_xhi_sponge_damping){
-            if (x > xhi_sponge_start) {
-                Real xi = (x - xhi_sponge_start) / (ProbHiArr[0] - xhi_sponge_start);
-                rho_v_rhs(i, j, k) -= sponge_strength * xi * xi * (rho_v(i, j, k) - sponge_density*sponge_y_velocity);
-            }
-        }
-
-        // y lo sponge
-        if(use_ylo_sponge_damping){
-            if (y < ylo_sponge_end) {
-                Real xi = (ylo_sponge_end - y) / (ylo_sponge_end - ProbLoArr[1]);
-                rho_v_rhs(i, j, k) -= sponge_strength * xi * xi * (rho_v(i, j, k) - sponge_density*sponge_y_velocity);
-            }
-        }
-        // x right sponge
-        if(use_yhi_sponge_damping){
-            if (y > yhi_sponge_start) {
-                Real xi = (y - yhi_sponge_start) / (ProbHiArr[1] - yhi_sponge_start);
-                rho_v_rhs(i, j, k) -= sponge_strength * xi * xi * (rho_v(i, j, k) - sponge_density*sponge_y_velocity);
-            }
-        }
-
-        // z lo sponge
-        if(use_zlo_sponge_damping){
-            if (z < zlo_sponge_end) {
-                Real xi = (zlo_sponge_end - z) / (zlo_sponge_end - ProbLoArr[2]);
-                rho_v_rhs(i, j, k) -= sponge_strength * xi * xi * (rho_v(i, j, k) - sponge_density*sponge_y_velocity);
-            }
-        }
-
-
-        // z hi sponge
-        if(use_zhi_sponge_damping){
-            if (z > zhi_sponge_start) {
-                Real xi = (z - zhi_sponge_start) / (ProbHiArr[2] - zhi_sponge_start);
-                rho_v_rhs(i, j, k) -= sponge_strength * xi * xi * (rho_v(i, j, k) - sponge_density*sponge_y_velocity);
-            }
-        }
-    });
-
-
-    amrex::ParallelFor(tbz, [=] AMREX_GPU_DEVICE(int i, int j, int k)
-    {
-        int ii = amrex::min(amrex::max(i, domlo_x), domhi_x);
-        int jj = amrex::min(amrex::max(j, domlo_y), domhi_y);
-        int kk = amrex::min(amrex::max(k, domlo_z), domhi_z);
-
-        Real x = (ii+0.5) * dx[0];
-        Real y = (jj+0.5) * dx[1];
-        Real z = kk * dx[2];
-
-        // x left sponge
-        if(use_xlo_sponge_damping){
-            if (x < xlo_sponge_end) {
-                Real xi = (xlo_sponge_end - x) / (xlo_sponge_end - ProbLoArr[0]);
-                rho_w_rhs(i, j, k) -= sponge_strength * xi * xi * (rho_w(i, j, k) - sponge_density*sponge_z_velocity);
-            }
-        }
-        // x right sponge
-        if(use_xhi_sponge_damping){
-            if (x > xhi_sponge_start) {
-                Real xi = (x - xhi_sponge_start) / (ProbHiArr[0] - xhi_sponge_start);
-                rho_w_rhs(i, j, k) -= sponge_strength * xi * xi * (rho_w(i, j, k) - sponge_density*sponge_z_velocity);
-            }
-        }
-
-        // y lo sponge
-        if(use_ylo_sponge_damping){
-            if (y < ylo_sponge_end) {
-                Real xi = (ylo_sponge_end - y) / (ylo_sponge_end - ProbLoArr[1]);
-                rho_w_rhs(i, j, k) -= sponge_strength * xi * xi * (rho_w(i, j, k) - sponge_density*sponge_z_velocity);
-            }
-        }
-        // x right sponge
-        if(use_yhi_sponge_damping){
-            if (y > yhi_sponge_start) {
-                Real xi = (y - yhi_sponge_start) / (ProbHiArr[1] - yhi_sponge_start);
-                rho_w_rhs(i, j, k) -= sponge_strength * xi * xi * (rho_w(i, j, k) - sponge_density*sponge_z_velocity);
-            }
-        }
-
-        // z lo sponge
-        if(use_zlo_sponge_damping){
-            if (z < zlo_sponge_end) {
-                Real xi = (zlo_sponge_end - z) / (zlo_sponge_end - ProbLoArr[2]);
-                rho_w_rhs(i, j, k) -= sponge_strength * xi * xi * (rho_w(i, j, k) - sponge_density*sponge_z_velocity);
-            }
-        }
-
-
-        // z top sponge
-        if(use_zhi_sponge_damping){
-            if (z > zhi_sponge_start) {
-                Real xi = (z - zhi_sponge_start) / (ProbHiArr[2] - zhi_sponge_start);
-                rho_w_rhs(i, j, k) -= sponge_strength * xi * xi * (rho_w(i, j, k) - sponge_density*sponge_z_velocity);
-            }
-        }
-    });
+    const GpuArray<int ,AMREX_SPACEDIM> use_lo = {use_xlo_sponge_damping, use_ylo_sponge_damping, use_zlo_sponge_damping};
+    const GpuArray<int ,AMREX_SPACEDIM> use_hi = {use_xhi_sponge_damping, use_yhi_sponge_damping, use_zhi_sponge_damping};
+    const GpuArray<Real,AMREX_SPACEDIM> lo_end   = {xlo_sponge_end  , ylo_sponge_end  , zlo_sponge_end  };
+    const GpuArray<Real,AMREX_SPACEDIM> hi_start = {xhi_sponge_start, yhi_sponge_start, zhi_sponge_start};
+
+    const Real rho_u_sponge = sponge_density*sponge_x_velocity;
+    const Real rho_v_sponge = sponge_density*sponge_y_velocity;
+    const Real rho_w_sponge = sponge_density*sponge_z_velocity;
+
+    // The layers are applied in turn: x lo/hi, y lo/hi, z lo/hi
+    for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+        for (int side = 0; side < 2; ++side) {
+            const bool hi = (side == 1);
+            if (!(hi ? use_hi[dir] : use_lo[dir])) continue;
+
+            const Real bound = hi ? hi_start[dir] : lo_end[dir];
+            const Real width = hi ? (ProbHiArr[dir] - bound) : (bound - ProbLoArr[dir]);
+            const Real dx_d  = dx[dir];
+
+            // Points are clamped onto the domain, so ghost cells get the damping of the boundary
+            const int domlo_d = domain.smallEnd(dir);
+            const int domhi_d = domain.bigEnd(dir) + 1;
+
+            // Offset of the points from the nodes along dir
+            const Real off_x = (dir == 0) ? 0.0 : 0.5;
+            const Real off_y = (dir == 1) ? 0.0 : 0.5;
+            const Real off_z = (dir == 2) ? 0.0 : 0.5;
+
+            Box sbx  = SpongeBox(bx , domain, dir, hi, bound, dx_d);
+            Box sbxx = SpongeBox(tbx, domain, dir, hi, bound, dx_d);
+            Box sbxy = SpongeBox(tby, domain, dir, hi, bound, dx_d);
+            Box sbxz = SpongeBox(tbz, domain, dir, hi, bound, dx_d);
+
+            if (sbx.ok()) {
+                ParallelFor(sbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+                {
+                    const int ii = amrex::min(amrex::max(IntVect(AMREX_D_DECL(i,j,k))[dir], domlo_d), domhi_d);
+                    const Real fac = SpongeFactor(ii, 0.5, dx_d, bound, width, hi, sponge_strength);
+                    if (fac > 0.0) cell_rhs(i, j, k, 0) -= fac * (cell_data(i, j, k, 0) - sponge_density);
+                });
+            }
+
+            if (sbxx.ok() || sbxy.ok() || sbxz.ok()) {
+                ParallelFor(sbxx, sbxy, sbxz,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+                {
+                    const int ii = amrex::min(amrex::max(IntVect(AMREX_D_DECL(i,j,k))[dir], domlo_d), domhi_d);
+                    const Real fac = SpongeFactor(ii, off_x, dx_d, bound, width, hi, sponge_strength);
+                    if (fac > 0.0) rho_u_rhs(i, j, k) -= fac * (rho_u(i, j, k) - rho_u_sponge);
+                },
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+                {
+                    const int ii = amrex::min(amrex::max(IntVect(AMREX_D_DECL(i,j,k))[dir], domlo_d), domhi_d);
+                    const Real fac = SpongeFactor(ii, off_y, dx_d, bound, width, hi, sponge_strength);
+                    if (fac > 0.0) rho_v_rhs(i, j, k) -= fac * (rho_v(i, j, k) - rho_v_sponge);
+                },
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+                {
+                    const int ii = amrex::min(amrex::max(IntVect(AMREX_D_DECL(i,j,k))[dir], domlo_d), domhi_d);
+                    const Real fac = SpongeFactor(ii, off_z, dx_d, bound, width, hi, sponge_strength);
+                    if (fac > 0.0) rho_w_rhs(i, j, k) -= fac * (rho_w(i, j, k) - rho_w_sponge);
+                });
+            }
+        }
+    }
 }
-
-
-
-
-
-
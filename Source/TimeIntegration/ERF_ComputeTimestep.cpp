@@ -148,6 +148,31 @@ ERF::estTimeStep (int level, long& dt_fast_ratio) const
          }
      }
 
+     // Explicit stability limit of the vertical eddy diffusion; this is only reported,
+     //    and is lifted altogether when the interior faces are treated implicitly
+     const TurbChoice& tc = solverChoice.turbChoice[level];
+     if (verbose && (tc.pbl_type != PBLType::None) && eddyDiffs_lev[level]) {
+         Real estdt_vdiff_inv = amrex::ReduceMax(S_new, *eddyDiffs_lev[level], 0,
+           [=] AMREX_GPU_HOST_DEVICE (Box const& b,
+                                      Array4<Real const> const& s,
+                                      Array4<Real const> const& mu) -> Real
+           {
+               Real new_vdiff_dt = -1.e100;
+               amrex::Loop(b, [=,&new_vdiff_dt] (int i, int j, int k) noexcept
+               {
+                   Real K = amrex::max(2.0*mu(i,j,k,EddyDiff::Mom_v), mu(i,j,k,EddyDiff::Theta_v));
+                   new_vdiff_dt = amrex::max(K / s(i,j,k,Rho_comp) * dzinv * dzinv, new_vdiff_dt);
+               });
+               return new_vdiff_dt;
+           });
+
+         amrex::ParallelDescriptor::ReduceRealMax(estdt_vdiff_inv);
+         if (estdt_vdiff_inv > 0.0_rt) {
+             amrex::Print() << "Vertical diffusion dt at level " << level << ":  " << 0.5/estdt_vdiff_inv
+                            << ((tc.vert_implicit_fac > 0.0) ? " (treated implicitly)" : "") << std::endl;
+         }
+     }
+
      if (fixed_dt > 0. && fixed_fast_dt > 0.) {
          dt_fast_ratio = static_cast<long>( fixed_dt / fixed_fast_dt );
      } else if (fixed_dt > 0.) {
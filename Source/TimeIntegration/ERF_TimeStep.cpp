@@ -43,10 +43,25 @@ ERF::timeStep (int lev, Real time, int iteration)
                 for (int k = old_finest+1; k <= finest_level; ++k) {
                     dt[k] = dt[k-1] / MaxRefRatio(k-1);
                 }
+
+                // rebalance the regridded levels using the costs measured on the old grids
+                if (load_balance_on_regrid) {
+                    for (int k = lev+1; k <= finest_level; ++k) {
+                        LoadBalance(k, time);
+                    }
+                }
             } // if
         } // lev
     }
 
+    // Periodically rebalance all levels using the measured costs
+    if (lev == 0 && load_balance_int > 0 && istep[0] > 0 && (istep[0] % load_balance_int == 0))
+    {
+        for (int k = 0; k <= finest_level; ++k) {
+            LoadBalance(k, time);
+        }
+    }
+
     // Update what we call "old" and "new" time
     t_old[lev] = t_new[lev];
     t_new[lev] += dt[lev];
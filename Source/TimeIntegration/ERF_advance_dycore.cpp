@@ -77,6 +77,7 @@ void ERF::advance_dycore(int level,
     Real* dptr_rayleigh_vbar     = solverChoice.use_rayleigh_damping ? d_rayleigh_vbar[level].data() : nullptr;
     Real* dptr_rayleigh_wbar     = solverChoice.use_rayleigh_damping ? d_rayleigh_wbar[level].data() : nullptr;
     Real* dptr_rayleigh_thetabar = solverChoice.use_rayleigh_damping ? d_rayleigh_thetabar[level].data() : nullptr;
+    int   rayleigh_klo_lev       = solverChoice.use_rayleigh_damping ? rayleigh_klo[level] : 0;
 
     bool l_use_terrain = solverChoice.use_terrain;
     bool l_use_diff    = ( (dc.molec_diff_type != MolecDiffType::None) ||
@@ -98,7 +99,10 @@ void ERF::advance_dycore(int level,
     MultiFab* SmnSmn    = SmnSmn_lev[level].get();
 
     // **************************************************************************************
-    // Compute strain for use in slow RHS, Smagorinsky model, and MOST
+    // Compute strain for use in the Smagorinsky model with terrain
+    //
+    // NOTE: The slow RHS computes the strain itself in every stage and, without
+    //       terrain, the Smagorinsky closure evaluates it in its own kernel.
     // **************************************************************************************
     MultiFab* Tau11 = Tau11_lev[level].get();
     MultiFab* Tau22 = Tau22_lev[level].get();
@@ -111,7 +115,7 @@ void ERF::advance_dycore(int level,
     MultiFab* Tau32 = Tau32_lev[level].get();
     {
     BL_PROFILE("erf_advance_strain");
-    if (l_use_diff) {
+    if (l_use_diff && l_use_terrain && (tc.les_type == LESType::Smagorinsky)) {
 
         const amrex::BCRec* bc_ptr_h = domain_bcs_type.data();
         const GpuArray<Real, AMREX_SPACEDIM> dxInv = fine_geom.InvCellSizeArray();
@@ -141,6 +145,7 @@ void ERF::advance_dycore(int level,
             Array4<Real> tau31  = l_use_terrain ? Tau31->array(mfi) : Array4<Real>{};
             Array4<Real> tau32  = l_use_terrain ? Tau32->array(mfi) : Array4<Real>{};
             const Array4<const Real>& z_nd = l_use_terrain ? z_phys_nd[level]->const_array(mfi) : Array4<const Real>{};
+            const TerrainMetricArrays met  = GetTerrainMetricArrays(terrain_met_lev[level], mfi);
 
             const Array4<const Real> mf_m = mapfac_m[level]->array(mfi);
             const Array4<const Real> mf_u = mapfac_u[level]->array(mfi);
@@ -153,7 +158,7 @@ void ERF::advance_dycore(int level,
                                 tau12, tau13,
                                 tau21, tau23,
                                 tau31, tau32,
-                                z_nd, bc_ptr_h, dxInv,
+                                z_nd, met, bc_ptr_h, dxInv,
                                 mf_m, mf_u, mf_v);
             } else {
                 ComputeStrain_N(bxcc, tbxxy, tbxxz, tbxyz,
@@ -213,15 +218,16 @@ void ERF::advance_dycore(int level,
     if (l_use_kturb)
     {
         // NOTE: state_new transfers to state_old for PBL (due to ptr swap in advance)
+        const amrex::BCRec* bc_ptr_h = domain_bcs_type.data();
         const amrex::BCRec* bc_ptr_d = domain_bcs_type_d.data();
-        ComputeTurbulentViscosity(xvel_old, yvel_old,
-                                  *Tau11, *Tau22, *Tau33,
-                                  *Tau12, *Tau13, *Tau23,
+        ComputeTurbulentViscosity(xvel_old, yvel_old, zvel_old,
+                                  Tau11, Tau22, Tau33,
+                                  Tau12, Tau13, Tau23,
                                   state_old[IntVar::cons],
                                   *eddyDiffs, *Hfx1, *Hfx2, *Hfx3, *Diss, // to be updated
-                                  fine_geom, *mapfac_u[level], *mapfac_v[level],
+                                  fine_geom, *mapfac_m[level], *mapfac_u[level], *mapfac_v[level],
                                   z_phys_nd[level],
-                                  tc, solverChoice.gravity, m_most, bc_ptr_d);
+                                  tc, solverChoice.gravity, m_most, level, bc_ptr_h, bc_ptr_d);
     }
 
     // ***********************************************************************************************
@@ -282,6 +288,27 @@ void ERF::advance_dycore(int level,
 
     mri_integrator.advance(state_old, state_new, old_time, dt_advance);
 
+    // ***************************************************************************************
+    // Vertical eddy diffusion through the interior faces, if treated implicitly
+    // ***************************************************************************************
+    if (l_use_kturb && (tc.vert_implicit_fac > 0.0))
+    {
+        BL_PROFILE("implicit_vert_diffusion");
+        const bool l_moving_terrain = l_use_terrain && (solverChoice.terrain_type == TerrainType::Moving);
+        const MultiFab* z_nd_impl = (!l_use_terrain) ? nullptr :
+                                    (l_moving_terrain) ? z_phys_nd_new[level].get() : z_phys_nd[level].get();
+        const MultiFab* detJ_impl = (!l_use_terrain) ? nullptr :
+                                    (l_moving_terrain) ? detJ_cc_new[level].get() : detJ_cc[level].get();
+        ImplicitVertDiffusion(dt_advance, fine_geom,
+                              state_new[IntVar::cons], state_new[IntVar::xmom], state_new[IntVar::ymom],
+                              *eddyDiffs, z_nd_impl, detJ_impl,
+                              dc, tc);
+
+        // Refill the ghost cells and bring the velocities back in sync with the momenta
+        post_update_fun(state_new, old_time + dt_advance,
+                        state_new[IntVar::cons].nGrow(), state_new[IntVar::xmom].nGrow());
+    }
+
     // Register coarse data for coarse-fine fill
     if (level<finest_level && solverChoice.coupling_type != CouplingType::TwoWay && cf_width>0) {
         FPr_c[level].RegisterCoarseData({&cons_old, &cons_new}, {old_time, old_time + dt_advance});
@@ -7,8 +7,17 @@ void ERF::advance_microphysics (int lev,
                                 const Real& dt_advance)
 {
     if (solverChoice.moisture_type != MoistureType::None) {
-        micro.Update_Micro_Vars_Lev(lev, cons);
-        micro.Advance(lev, dt_advance);
-        micro.Update_State_Vars_Lev(lev, cons);
+        Real wt = (costs[lev]) ? amrex::second() : 0.0;
+
+        // The moisture model updates cons in place; the interior and periodic ghost
+        // cells must be current before the coarse data is registered for the
+        // coarse-fine fills
+        micro.Advance(lev, cons, dt_advance);
+        cons.FillBoundary(geom[lev].periodicity());
+
+        if (costs[lev]) {
+            Gpu::streamSynchronize();
+            AddPhysicsCosts(lev, cons, amrex::second() - wt, true);
+        }
     }
 }
@@ -1,9 +1,20 @@
-
 #include <ERF.H>
 
 using namespace amrex;
 
 #if defined(ERF_USE_RRTMGP)
+/**
+ * Calls the radiation model if it is time for a shortwave or longwave call
+ * and stores the resulting potential temperature tendencies in
+ * qheating_rates[lev]. A band that is not called keeps its last tendency.
+ * Both bands are called on the first step and after every regrid. Between
+ * shortwave calls the shortwave tendency may be rescaled to the current
+ * solar zenith angle at the interval of the zenith angle refresh.
+ *
+ * @param[in] lev level of refinement
+ * @param[in] cons conserved state at the end of the step
+ * @param[in] dt_advance time step of this level
+ */
 void ERF::advance_radiation (int lev,
                              MultiFab& cons,
                              const Real& dt_advance)
@@ -14,17 +25,100 @@ void ERF::advance_radiation (int lev,
    bool do_snow_opt {true};
    bool is_cmip6_volcano {false};
 
-    // TODO: Only passing qv from the qmoist vector!!!
-    rad.initialize(cons, *(qmoist[lev][0]),
-                   grids[lev],
-                   Geom(lev),
-                   dt_advance,
-                   do_sw_rad,
-                   do_lw_rad,
-                   do_aero_rad,
-                   do_snow_opt,
-                   is_cmip6_volcano);
-    rad.run();
-    rad.on_complete();
+    if (!rad[lev]) { rad[lev] = std::make_unique<Radiation>(); }
+
+    // New grids have no heating rates yet
+    bool new_grids = !rad[lev]->is_defined_on(grids[lev], dmap[lev]);
+
+    bool compute_sw = new_grids ||
+        is_it_time_for_action(istep[lev], t_new[lev], dt_advance, rad_sw_interval, rad_sw_per);
+    bool compute_lw = new_grids ||
+        is_it_time_for_action(istep[lev], t_new[lev], dt_advance, rad_lw_interval, rad_lw_per);
+
+    bool refresh_cosz = !compute_sw &&
+        is_it_time_for_action(istep[lev], t_new[lev], dt_advance, rad_cosz_interval, rad_cosz_per);
+
+    if (!compute_sw && !compute_lw && !refresh_cosz) { return; }
+
+    Real wt = (costs[lev]) ? amrex::second() : 0.0;
+
+    // The coefficients are read and the buffers allocated only for new grids
+    if (new_grids) {
+        rad[lev]->initialize(cons,
+                             grids[lev],
+                             Geom(lev),
+                             dt_advance,
+                             do_sw_rad,
+                             do_lw_rad,
+                             do_aero_rad,
+                             do_snow_opt,
+                             is_cmip6_volcano);
+    }
+
+    if (!qheating_rates[lev] ||
+        qheating_rates[lev]->boxArray() != cons.boxArray() ||
+        qheating_rates[lev]->DistributionMap() != cons.DistributionMap())
+    {
+        qheating_rates[lev] = std::make_unique<MultiFab>(cons.boxArray(), cons.DistributionMap(), 2, 0);
+        qheating_rates[lev]->setVal(0.0);
+    }
+
+    rad[lev]->update(cons, qmoist[lev], t_new[lev]);
+    if (compute_sw || compute_lw) {
+        rad[lev]->run(compute_sw, compute_lw);
+        rad[lev]->on_complete(*qheating_rates[lev]);
+    }
+    if (refresh_cosz) {
+        rad[lev]->refresh_zenith_angle();
+        rad[lev]->on_complete(*qheating_rates[lev]);
+    }
+
+    if (costs[lev]) {
+        Gpu::streamSynchronize();
+        AddPhysicsCosts(lev, cons, amrex::second() - wt, false);
+    }
+}
+
+/**
+ * Adds rho times the stored shortwave and longwave potential temperature
+ * tendencies to the rho theta source. If the grids have changed since the
+ * last radiation call, the stored tendencies are first copied to the new
+ * grids; cells not covered by the old grids get no heating until the next
+ * radiation call.
+ *
+ * @param[in] lev level of refinement
+ * @param[in] cons conserved state at the start of the step
+ * @param[in,out] source source terms for the conserved variables
+ */
+void ERF::add_radiative_heating (int lev,
+                                 const MultiFab& cons,
+                                 MultiFab& source)
+{
+    if (!qheating_rates[lev]) { return; }
+
+    if (qheating_rates[lev]->boxArray()        != cons.boxArray() ||
+        qheating_rates[lev]->DistributionMap() != cons.DistributionMap())
+    {
+        auto q_new = std::make_unique<MultiFab>(cons.boxArray(), cons.DistributionMap(), 2, 0);
+        q_new->setVal(0.0);
+        q_new->ParallelCopy(*qheating_rates[lev], 0, 0, 2, 0, 0, Geom(lev).periodicity());
+        qheating_rates[lev] = std::move(q_new);
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(source, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        auto const& src_arr  = source.array(mfi);
+        auto const& cons_arr = cons.const_array(mfi);
+        auto const& q_arr    = qheating_rates[lev]->const_array(mfi);
+
+        ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            src_arr(i,j,k,RhoTheta_comp) += cons_arr(i,j,k,Rho_comp) * (q_arr(i,j,k,0) + q_arr(i,j,k,1));
+        });
+    }
 }
 #endif
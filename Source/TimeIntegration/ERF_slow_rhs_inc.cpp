@@ -45,7 +45,7 @@ using namespace amrex;
  * @param[in] Tau23 tau_23 component of stress tensor
  * @param[in] Tau31 tau_31 component of stress tensor
  * @param[in] Tau32 tau_32 component of stress tensor
- * @param[in] SmnSmn strain rate magnitude
+ * @param[in] SmnSmn strain rate magnitude (Deardorff with terrain only)
  * @param[in] eddyDiffs diffusion coefficients for LES turbulence models
  * @param[in] Hfx3 heat flux in z-dir
  * @param[in] Diss dissipation of turbulent kinetic energy
@@ -57,6 +57,7 @@ using namespace amrex;
  * @param[in]  domain_bcs_type     host vector for domain boundary conditions
  * @param[in] z_phys_nd height coordinate at nodes
  * @param[in] detJ Jacobian of the metric transformation (= 1 if use_terrain is false)
+ * @param[in] terrain_met cached metric terms at cell centers and edges (empty unless the terrain is static)
  * @param[in]  p0     Reference (hydrostatically stratified) pressure
  * @param[in] mapfac_m map factor at cell centers
  * @param[in] mapfac_u map factor at x-faces
@@ -95,6 +96,7 @@ void erf_slow_rhs_inc (int /*level*/, int nrk,
                        const Gpu::DeviceVector<amrex::BCRec>& domain_bcs_type_d,
                        const Vector<amrex::BCRec>& domain_bcs_type,
                        std::unique_ptr<MultiFab>& z_phys_nd, std::unique_ptr<MultiFab>& detJ,
+                       const Vector<std::unique_ptr<MultiFab>>& terrain_met,
                        const MultiFab* p0,
                        std::unique_ptr<MultiFab>& mapfac_m,
                        std::unique_ptr<MultiFab>& mapfac_u,
@@ -130,6 +132,9 @@ void erf_slow_rhs_inc (int /*level*/, int nrk,
                                     tc.pbl_type == PBLType::MYNN25      ||
                                     tc.pbl_type == PBLType::YSU );
 
+    // Vertical eddy diffusion through interior faces is done by ImplicitVertDiffusion
+    const bool l_vert_impl      = (tc.vert_implicit_fac > 0.0);
+
     const amrex::BCRec* bc_ptr   = domain_bcs_type_d.data();
     const amrex::BCRec* bc_ptr_h = domain_bcs_type.data();
 
@@ -189,6 +194,7 @@ void erf_slow_rhs_inc (int /*level*/, int nrk,
             // Terrain metrics
             const Array4<const Real>& z_nd     = l_use_terrain ? z_phys_nd->const_array(mfi) : Array4<const Real>{};
             const Array4<const Real>& detJ_arr = l_use_terrain ?      detJ->const_array(mfi) : Array4<const Real>{};
+            const TerrainMetricArrays met      = GetTerrainMetricArrays(terrain_met, mfi);
 
             //-------------------------------------------------------------------------------
             // NOTE: Tile boxes with terrain are not intuitive. The linear combination of
@@ -290,11 +296,11 @@ void erf_slow_rhs_inc (int /*level*/, int nrk,
                                 s12, s13,
                                 s21, s23,
                                 s31, s32,
-                                z_nd, bc_ptr_h, dxInv,
+                                z_nd, met, bc_ptr_h, dxInv,
                                 mf_m, mf_u, mf_v);
                 } // profile
 
-                // Populate SmnSmn if using Deardorff (used as diff src in post)
+                // Populate SmnSmn if using Deardorff with terrain (used as diff src in post)
                 // and in the first RK stage (TKE tendencies constant for nrk>0, following WRF)
                 if ((nrk==0) && (solverChoice.les_type == LESType::Deardorff)) {
                     SmnSmn_a = SmnSmn->array(mfi);
@@ -322,14 +328,14 @@ void erf_slow_rhs_inc (int /*level*/, int nrk,
                                             s12, s13,
                                             s21, s23,
                                             s31, s32,
-                                            er_arr, z_nd, dxInv);
+                                            er_arr, z_nd, met, dxInv);
                 } else {
                     ComputeStressVarVisc_T(bxcc, tbxxy, tbxxz, tbxyz, mu_eff, mu_turb,
                                            s11, s22, s33,
                                            s12, s13,
                                            s21, s23,
                                            s31, s32,
-                                           er_arr, z_nd, dxInv);
+                                           er_arr, z_nd, met, dxInv, l_vert_impl, domain);
                 }
 
                 // Remove halo cells from tau_ii but extend across valid_box bdry
@@ -391,16 +397,6 @@ void erf_slow_rhs_inc (int /*level*/, int nrk,
                                 mf_m, mf_u, mf_v);
                 } // end profile
 
-                // Populate SmnSmn if using Deardorff (used as diff src in post)
-                // and in the first RK stage (TKE tendencies constant for nrk>0, following WRF)
-                if ((nrk==0) && (solverChoice.les_type == LESType::Deardorff)) {
-                    SmnSmn_a = SmnSmn->array(mfi);
-                    amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                    {
-                        SmnSmn_a(i,j,k) = ComputeSmnSmn(i,j,k,s11,s22,s33,s12,s13,s23);
-                    });
-                }
-
                 //-----------------------------------------
                 // Stress tensor compute no terrain
                 //-----------------------------------------
@@ -422,7 +418,7 @@ void erf_slow_rhs_inc (int /*level*/, int nrk,
                     ComputeStressVarVisc_N(bxcc, tbxxy, tbxxz, tbxyz, mu_eff, mu_turb,
                                            s11, s22, s33,
                                            s12, s13, s23,
-                                           er_arr);
+                                           er_arr, l_vert_impl, domain);
                 }
 
                 // Remove halo cells from tau_ii but extend across valid_box bdry
@@ -571,9 +567,9 @@ void erf_slow_rhs_inc (int /*level*/, int nrk,
             tau21 = Array4<Real>{}; tau31 = Array4<Real>{}; tau32 = Array4<Real>{};
         }
 
-        // Strain magnitude
+        // Strain magnitude (only stored with terrain)
         Array4<Real> SmnSmn_a;
-        if (solverChoice.les_type == LESType::Deardorff) {
+        if (solverChoice.les_type == LESType::Deardorff && l_use_terrain) {
             SmnSmn_a = SmnSmn->array(mfi);
         } else {
             SmnSmn_a = Array4<Real>{};
@@ -612,14 +608,14 @@ void erf_slow_rhs_inc (int /*level*/, int nrk,
             DiffusionSrcForState_N(bx, domain, n_start, n_comp, u, v,
                                    cell_data, cell_prim, cell_rhs,
                                    diffflux_x, diffflux_y, diffflux_z,
-                                   dxInv, SmnSmn_a, mf_m, mf_u, mf_v,
+                                   dxInv, MatrixFreeStress_N{}, mf_m, mf_u, mf_v,
                                    hfx_z, diss,
                                    mu_turb, solverChoice, tm_arr, grav_gpu, bc_ptr);
         }
 
         if (l_use_ndiff) {
             NumericalDiffusion(bx, start_comp, num_comp, dt, solverChoice.NumDiffCoeff,
-                               cell_data, cell_rhs, mf_u, mf_v, false, false);
+                               cell_data, cell_rhs, mf_u, mf_v);
         }
 
         // Add source terms for (rho theta)
@@ -675,12 +671,10 @@ void erf_slow_rhs_inc (int /*level*/, int nrk,
         }
 
         if (l_use_ndiff) {
-            NumericalDiffusion(tbx, 0, 1, dt, solverChoice.NumDiffCoeff,
-                               rho_u, rho_u_rhs, mf_m, mf_v, false, true);
-            NumericalDiffusion(tby, 0, 1, dt, solverChoice.NumDiffCoeff,
-                               rho_v, rho_v_rhs, mf_u, mf_m, true, false);
-            NumericalDiffusion(tbz, 0, 1, dt, solverChoice.NumDiffCoeff,
-                               rho_w, rho_w_rhs, mf_u, mf_v, false, false);
+            NumericalDiffusionMom(tbx, tby, tbz, dt, solverChoice.NumDiffCoeff,
+                                  rho_u, rho_v, rho_w,
+                                  rho_u_rhs, rho_v_rhs, rho_w_rhs,
+                                  mf_m, mf_u, mf_v);
         }
 
         {
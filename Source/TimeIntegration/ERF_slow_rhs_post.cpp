@@ -29,8 +29,11 @@ using namespace amrex;
  * @param[in]  xvel x-component of velocity
  * @param[in]  yvel y-component of velocity
  * @param[in]  zvel z-component of velocity
+ * @param[in]  xvel_old x-component of velocity at the start of the time step
+ * @param[in]  yvel_old y-component of velocity at the start of the time step
+ * @param[in]  zvel_old z-component of velocity at the start of the time step
  * @param[in] source source terms for conserved variables
- * @param[in] SmnSmn strain rate magnitude
+ * @param[in] SmnSmn strain rate magnitude (Deardorff with terrain only)
  * @param[in] eddyDiffs diffusion coefficients for LES turbulence models
  * @param[in] Hfx3 heat flux in z-dir
  * @param[in] Diss dissipation of turbulent kinetic energy
@@ -38,6 +41,7 @@ using namespace amrex;
  * @param[in]  solverChoice  Container for solver parameters
  * @param[in]  most  Pointer to MOST class for Monin-Obukhov Similarity Theory boundary condition
  * @param[in]  domain_bcs_type_d device vector for domain boundary conditions
+ * @param[in]  domain_bcs_type   host   vector for domain boundary conditions
  * @param[in] z_phys_nd height coordinate at nodes
  * @param[in] detJ     Jacobian of the metric transformation at start of time step (= 1 if use_terrain is false)
  * @param[in] detJ_new Jacobian of the metric transformation at new RK stage time (= 1 if use_terrain is false)
@@ -60,6 +64,9 @@ void erf_slow_rhs_post (int level, int finest_level,
                         const MultiFab& xvel,
                         const MultiFab& yvel,
                         const MultiFab& /*zvel*/,
+                        const MultiFab& xvel_old,
+                        const MultiFab& yvel_old,
+                        const MultiFab& zvel_old,
                         const MultiFab& source,
                         const MultiFab* SmnSmn,
                         const MultiFab* eddyDiffs,
@@ -68,6 +75,7 @@ void erf_slow_rhs_post (int level, int finest_level,
                         const SolverChoice& solverChoice,
                         std::unique_ptr<ABLMost>& most,
                         const Gpu::DeviceVector<amrex::BCRec>& domain_bcs_type_d,
+                        const Vector<amrex::BCRec>& domain_bcs_type,
                         std::unique_ptr<MultiFab>& z_phys_nd,
                         std::unique_ptr<MultiFab>& detJ,
                         std::unique_ptr<MultiFab>& detJ_new,
@@ -97,7 +105,7 @@ void erf_slow_rhs_post (int level, int finest_level,
     TurbChoice tc = solverChoice.turbChoice[level];
 
     const MultiFab* t_mean_mf = nullptr;
-    if (most) t_mean_mf = most->get_mac_avg(0,2);
+    if (most) t_mean_mf = most->get_mac_avg(level,2);
 
     const bool l_use_terrain      = solverChoice.use_terrain;
     const bool l_reflux = (solverChoice.coupling_type != CouplingType::OneWay);
@@ -115,7 +123,8 @@ void erf_slow_rhs_post (int level, int finest_level,
                                     tc.pbl_type == PBLType::MYNN25      ||
                                     tc.pbl_type == PBLType::YSU );
 
-    const amrex::BCRec* bc_ptr = domain_bcs_type_d.data();
+    const amrex::BCRec* bc_ptr   = domain_bcs_type_d.data();
+    const amrex::BCRec* bc_ptr_h = domain_bcs_type.data();
 
     const Box& domain = geom.Domain();
 
@@ -223,8 +232,17 @@ void erf_slow_rhs_post (int level, int finest_level,
         const Array4<const Real>& mf_u = mapfac_u->const_array(mfi);
         const Array4<const Real>& mf_v = mapfac_v->const_array(mfi);
 
-        // SmnSmn for KE src with Deardorff
-        const Array4<const Real>& SmnSmn_a = l_use_deardorff ? SmnSmn->const_array(mfi) : Array4<const Real>{};
+        // SmnSmn for KE src with Deardorff and terrain
+        const Array4<const Real>& SmnSmn_a = (l_use_deardorff && l_use_terrain) ? SmnSmn->const_array(mfi) : Array4<const Real>{};
+
+        // Without terrain the KE src evaluates the strain itself, from the velocities at the
+        // start of the time step (TKE tendencies constant for nrk>0, following WRF)
+        MatrixFreeStress_N ke_strain{};
+        if (l_use_deardorff && !l_use_terrain) {
+            ke_strain = MatrixFreeStress_N{xvel_old.const_array(mfi), yvel_old.const_array(mfi), zvel_old.const_array(mfi),
+                                           mu_turb, mf_m, mf_u, mf_v, dxInv, 0.0, false};
+            ke_strain.set_bcs(bc_ptr_h, domain);
+        }
 
         // **************************************************************************
         // Here we fill the "current" data with "new" data because that is the result of the previous RK stage
@@ -336,14 +354,10 @@ void erf_slow_rhs_post (int level, int finest_level,
                     DiffusionSrcForState_N(tbx, domain, start_comp, num_comp, u, v,
                                            cur_cons, cur_prim, cell_rhs,
                                            diffflux_x, diffflux_y, diffflux_z,
-                                           dxInv, SmnSmn_a, mf_m, mf_u, mf_v,
+                                           dxInv, ke_strain, mf_m, mf_u, mf_v,
                                            hfx_z, diss,
                                            mu_turb, dc, tc, tm_arr, grav_gpu, bc_ptr);
                 }
-                if (l_use_ndiff) {
-                    NumericalDiffusion(tbx, start_comp, num_comp, dt, solverChoice.NumDiffCoeff,
-                                       new_cons, cell_rhs, mf_u, mf_v, false, false);
-                }
             }
             if (l_use_QKE) {
                 start_comp = RhoQKE_comp;
@@ -359,14 +373,10 @@ void erf_slow_rhs_post (int level, int finest_level,
                     DiffusionSrcForState_N(tbx, domain, start_comp, num_comp, u, v,
                                            cur_cons, cur_prim, cell_rhs,
                                            diffflux_x, diffflux_y, diffflux_z,
-                                           dxInv, SmnSmn_a, mf_m, mf_u, mf_v,
+                                           dxInv, ke_strain, mf_m, mf_u, mf_v,
                                            hfx_z, diss,
                                            mu_turb, dc, tc, tm_arr, grav_gpu, bc_ptr);
                 }
-                if (l_use_ndiff) {
-                    NumericalDiffusion(tbx, start_comp, num_comp, dt, solverChoice.NumDiffCoeff,
-                                       new_cons, cell_rhs, mf_u, mf_v, false, false);
-                }
             }
 
             start_comp = RhoScalar_comp;
@@ -382,13 +392,19 @@ void erf_slow_rhs_post (int level, int finest_level,
                 DiffusionSrcForState_N(tbx, domain, start_comp, num_comp, u, v,
                                        cur_cons, cur_prim, cell_rhs,
                                        diffflux_x, diffflux_y, diffflux_z,
-                                       dxInv, SmnSmn_a, mf_m, mf_u, mf_v,
+                                       dxInv, ke_strain, mf_m, mf_u, mf_v,
                                        hfx_z, diss,
                                        mu_turb, dc, tc, tm_arr, grav_gpu, bc_ptr);
             }
             if (l_use_ndiff) {
-                NumericalDiffusion(tbx, start_comp, num_comp, dt, solverChoice.NumDiffCoeff,
-                                   new_cons, cell_rhs, mf_u, mf_v, false, false);
+                // All the components diffused above in a single pass
+                GpuArray<int,NVAR_max> ndiff_comps{};
+                int n_ndiff = 0;
+                if (l_use_deardorff) ndiff_comps[n_ndiff++] = RhoKE_comp;
+                if (l_use_QKE)       ndiff_comps[n_ndiff++] = RhoQKE_comp;
+                for (int n = RhoScalar_comp; n < nvars; ++n) ndiff_comps[n_ndiff++] = n;
+                NumericalDiffusion(tbx, ndiff_comps, n_ndiff, dt, solverChoice.NumDiffCoeff,
+                                   new_cons, cell_rhs, mf_u, mf_v);
             }
         }
 #if defined(ERF_USE_NETCDF)
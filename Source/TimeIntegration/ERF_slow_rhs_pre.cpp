@@ -5,6 +5,7 @@
 #include <ERF_Constants.H>
 #include <Advection.H>
 #include <Diffusion.H>
+#include <MatrixFreeStress.H>
 #include <NumericalDiffusion.H>
 #include <TI_headers.H>
 #include <TileNoZ.H>
@@ -45,7 +46,7 @@ using namespace amrex;
  * @param[in] Tau23 tau_23 component of stress tensor
  * @param[in] Tau31 tau_31 component of stress tensor
  * @param[in] Tau32 tau_32 component of stress tensor
- * @param[in] SmnSmn strain rate magnitude
+ * @param[in] SmnSmn strain rate magnitude (Deardorff with terrain only)
  * @param[in] eddyDiffs diffusion coefficients for LES turbulence models
  * @param[in] Hfx3 heat flux in z-dir
  * @param[in] Diss dissipation of turbulent kinetic energy
@@ -57,6 +58,7 @@ using namespace amrex;
  * @param[in]  domain_bcs_type     host vector for domain boundary conditions
  * @param[in] z_phys_nd height coordinate at nodes
  * @param[in] detJ Jacobian of the metric transformation (= 1 if use_terrain is false)
+ * @param[in] terrain_met cached metric terms at cell centers and edges (empty unless the terrain is static)
  * @param[in]  p0     Reference (hydrostatically stratified) pressure
  * @param[in] mapfac_m map factor at cell centers
  * @param[in] mapfac_u map factor at x-faces
@@ -68,6 +70,8 @@ using namespace amrex;
  * @param[in] dptr_rayleigh_vbar reference value for y-velocity used to define Rayleigh damping
  * @param[in] dptr_rayleigh_wbar reference value for z-velocity used to define Rayleigh damping
  * @param[in] dptr_rayleigh_thetabar reference value for potential temperature used to define Rayleigh damping
+ * @param[in] rayleigh_klo lowest k index of the Rayleigh damping layer
+ * @param[inout] cost per-box wall time used for load balancing (only accumulated if not null)
  */
 
 void erf_slow_rhs_pre (int level, int finest_level,
@@ -96,6 +100,7 @@ void erf_slow_rhs_pre (int level, int finest_level,
                        const Gpu::DeviceVector<amrex::BCRec>& domain_bcs_type_d,
                        const Vector<amrex::BCRec>& domain_bcs_type,
                        std::unique_ptr<MultiFab>& z_phys_nd, std::unique_ptr<MultiFab>& detJ,
+                       const Vector<std::unique_ptr<MultiFab>>& terrain_met,
                        const MultiFab* p0,
                        std::unique_ptr<MultiFab>& mapfac_m,
                        std::unique_ptr<MultiFab>& mapfac_u,
@@ -104,7 +109,9 @@ void erf_slow_rhs_pre (int level, int finest_level,
                        YAFluxRegister* fr_as_fine,
                        const amrex::Real* dptr_rayleigh_tau, const amrex::Real* dptr_rayleigh_ubar,
                        const amrex::Real* dptr_rayleigh_vbar, const amrex::Real* dptr_rayleigh_wbar,
-                       const amrex::Real* dptr_rayleigh_thetabar)
+                       const amrex::Real* dptr_rayleigh_thetabar,
+                       const int rayleigh_klo,
+                       LayoutData<Real>* cost)
 {
     BL_PROFILE_REGION("erf_slow_rhs_pre()");
 
@@ -112,7 +119,7 @@ void erf_slow_rhs_pre (int level, int finest_level,
     TurbChoice tc = solverChoice.turbChoice[level];
 
     const MultiFab* t_mean_mf = nullptr;
-    if (most) t_mean_mf = most->get_mac_avg(0,2);
+    if (most) t_mean_mf = most->get_mac_avg(level,2);
 
     int start_comp = 0;
     int   num_comp = 2;
@@ -135,6 +142,13 @@ void erf_slow_rhs_pre (int level, int finest_level,
                                     tc.pbl_type == PBLType::MYNN25      ||
                                     tc.pbl_type == PBLType::YSU );
 
+    // Vertical eddy diffusion through interior faces is done by ImplicitVertDiffusion
+    const bool l_vert_impl      = (tc.vert_implicit_fac > 0.0);
+
+    // Evaluate the stress on the fly in the momentum diffusion (never with terrain)
+    const bool l_mf_stress      = dc.matrix_free_stress;
+    if (l_mf_stress) AMREX_ALWAYS_ASSERT (!l_use_terrain);
+
     const bool use_moisture = (solverChoice.moisture_type != MoistureType::None);
 
     const amrex::BCRec* bc_ptr   = domain_bcs_type_d.data();
@@ -165,7 +179,7 @@ void erf_slow_rhs_pre (int level, int finest_level,
     std::unique_ptr<MultiFab> dflux_z;
 
     if (l_use_diff) {
-        expr    = std::make_unique<MultiFab>(ba  , dm, 1, IntVect(1,1,0));
+        if (!l_mf_stress) expr = std::make_unique<MultiFab>(ba  , dm, 1, IntVect(1,1,0));
         dflux_x = std::make_unique<MultiFab>(convert(ba,IntVect(1,0,0)), dm, nvars, 0);
         dflux_y = std::make_unique<MultiFab>(convert(ba,IntVect(0,1,0)), dm, nvars, 0);
         dflux_z = std::make_unique<MultiFab>(convert(ba,IntVect(0,0,1)), dm, nvars, 0);
@@ -197,6 +211,11 @@ void erf_slow_rhs_pre (int level, int finest_level,
             // Terrain metrics
             const Array4<const Real>& z_nd     = l_use_terrain ? z_phys_nd->const_array(mfi) : Array4<const Real>{};
             const Array4<const Real>& detJ_arr = l_use_terrain ?      detJ->const_array(mfi) : Array4<const Real>{};
+            const TerrainMetricArrays met      = GetTerrainMetricArrays(terrain_met, mfi);
+
+            // Matrix-free: the momentum diffusion evaluates the stress itself, and the
+            // Deardorff shear production is evaluated in erf_slow_rhs_post
+            if (l_mf_stress) continue;
 
             //-------------------------------------------------------------------------------
             // NOTE: Tile boxes with terrain are not intuitive. The linear combination of
@@ -298,11 +317,11 @@ void erf_slow_rhs_pre (int level, int finest_level,
                                 s12, s13,
                                 s21, s23,
                                 s31, s32,
-                                z_nd, bc_ptr_h, dxInv,
+                                z_nd, met, bc_ptr_h, dxInv,
                                 mf_m, mf_u, mf_v);
                 } // profile
 
-                // Populate SmnSmn if using Deardorff (used as diff src in post)
+                // Populate SmnSmn if using Deardorff with terrain (used as diff src in post)
                 // and in the first RK stage (TKE tendencies constant for nrk>0, following WRF)
                 if ((nrk==0) && (tc.les_type == LESType::Deardorff)) {
                     SmnSmn_a = SmnSmn->array(mfi);
@@ -330,14 +349,14 @@ void erf_slow_rhs_pre (int level, int finest_level,
                                             s12, s13,
                                             s21, s23,
                                             s31, s32,
-                                            er_arr, z_nd, dxInv);
+                                            er_arr, z_nd, met, dxInv);
                 } else {
                     ComputeStressVarVisc_T(bxcc, tbxxy, tbxxz, tbxyz, mu_eff, mu_turb,
                                            s11, s22, s33,
                                            s12, s13,
                                            s21, s23,
                                            s31, s32,
-                                           er_arr, z_nd, dxInv);
+                                           er_arr, z_nd, met, dxInv, l_vert_impl, domain);
                 }
 
                 // Remove halo cells from tau_ii but extend across valid_box bdry
@@ -399,15 +418,6 @@ void erf_slow_rhs_pre (int level, int finest_level,
                                 mf_m, mf_u, mf_v);
                 } // end profile
 
-                // Populate SmnSmn if using Deardorff (used as diff src in post)
-                // and in the first RK stage (TKE tendencies constant for nrk>0, following WRF)
-                if ((nrk==0) && (tc.les_type == LESType::Deardorff)) {
-                    SmnSmn_a = SmnSmn->array(mfi);
-                    ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                    {
-                        SmnSmn_a(i,j,k) = ComputeSmnSmn(i,j,k,s11,s22,s33,s12,s13,s23);
-                    });
-                }
 
                 //-----------------------------------------
                 // Stress tensor compute no terrain
@@ -430,7 +440,7 @@ void erf_slow_rhs_pre (int level, int finest_level,
                     ComputeStressVarVisc_N(bxcc, tbxxy, tbxxz, tbxyz, mu_eff, mu_turb,
                                            s11, s22, s33,
                                            s12, s13, s23,
-                                           er_arr);
+                                           er_arr, l_vert_impl, domain);
                 }
 
                 // Remove halo cells from tau_ii but extend across valid_box bdry
@@ -473,6 +483,8 @@ void erf_slow_rhs_pre (int level, int finest_level,
 
     for ( MFIter mfi(S_data[IntVar::cons],TileNoZ()); mfi.isValid(); ++mfi)
     {
+        Real wt = (cost) ? amrex::second() : 0.0;
+
         Box bx  = mfi.tilebox();
         Box tbx = mfi.nodaltilebox(0);
         Box tby = mfi.nodaltilebox(1);
@@ -615,9 +627,9 @@ void erf_slow_rhs_pre (int level, int finest_level,
             tau21 = Array4<Real>{}; tau31 = Array4<Real>{}; tau32 = Array4<Real>{};
         }
 
-        // Strain magnitude
+        // Strain magnitude (only stored with terrain)
         Array4<Real> SmnSmn_a;
-        if (tc.les_type == LESType::Deardorff) {
+        if (tc.les_type == LESType::Deardorff && l_use_terrain) {
             SmnSmn_a = SmnSmn->array(mfi);
         } else {
             SmnSmn_a = Array4<Real>{};
@@ -663,7 +675,7 @@ void erf_slow_rhs_pre (int level, int finest_level,
                 DiffusionSrcForState_N(bx, domain, n_start, n_comp, u, v,
                                        cell_data, cell_prim, cell_rhs,
                                        diffflux_x, diffflux_y, diffflux_z,
-                                       dxInv, SmnSmn_a, mf_m, mf_u, mf_v,
+                                       dxInv, MatrixFreeStress_N{}, mf_m, mf_u, mf_v,
                                        hfx_z, diss,
                                        mu_turb, dc, tc,
                                        tm_arr, grav_gpu, bc_ptr);
@@ -672,7 +684,7 @@ void erf_slow_rhs_pre (int level, int finest_level,
 
         if (l_use_ndiff) {
             NumericalDiffusion(bx, start_comp, num_comp, dt, solverChoice.NumDiffCoeff,
-                               cell_data, cell_rhs, mf_u, mf_v, false, false);
+                               cell_data, cell_rhs, mf_u, mf_v);
        }
 
         // Add source terms for (rho theta)
@@ -691,12 +703,13 @@ void erf_slow_rhs_pre (int level, int finest_level,
             }
         }
 
-        // Add Rayleigh damping
-        if (solverChoice.use_rayleigh_damping && solverChoice.rayleigh_damp_T) {
+        // Add Rayleigh damping (only on the part of the tile inside the damping layer)
+        Box rbx(bx); rbx.setSmall(2, amrex::max(rbx.smallEnd(2), rayleigh_klo));
+        if (solverChoice.use_rayleigh_damping && solverChoice.rayleigh_damp_T && rbx.ok()) {
             int n  = RhoTheta_comp;
             int nr = Rho_comp;
             int np = PrimTheta_comp;
-            ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            ParallelFor(rbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
             {
                 Real theta = cell_prim(i,j,k,np);
                 cell_rhs(i, j, k, n) -= dptr_rayleigh_tau[k] * (theta - dptr_rayleigh_thetabar[k]) * cell_data(i,j,k,nr);
@@ -731,6 +744,13 @@ void erf_slow_rhs_pre (int level, int finest_level,
                                      tau31, tau32,
                                      cell_data, detJ_arr, dc, dxInv,
                                      mf_m, mf_u, mf_v);
+            } else if (l_mf_stress) {
+                DiffusionSrcForMomMatrixFree_N(tbx, tby, tbz,
+                                               rho_u_rhs, rho_v_rhs, rho_w_rhs,
+                                               u, v, w,
+                                               cell_data, mu_turb, dc, dxInv,
+                                               mf_m, mf_u, mf_v, l_use_turb, l_vert_impl,
+                                               domain, bc_ptr_h);
             } else {
                 DiffusionSrcForMom_N(tbx, tby, tbz,
                                      rho_u_rhs, rho_v_rhs, rho_w_rhs,
@@ -742,12 +762,10 @@ void erf_slow_rhs_pre (int level, int finest_level,
         }
 
         if (l_use_ndiff) {
-            NumericalDiffusion(tbx, 0, 1, dt, solverChoice.NumDiffCoeff,
-                               rho_u, rho_u_rhs, mf_m, mf_v, false, true);
-            NumericalDiffusion(tby, 0, 1, dt, solverChoice.NumDiffCoeff,
-                               rho_v, rho_v_rhs, mf_u, mf_m, true, false);
-            NumericalDiffusion(tbz, 0, 1, dt, solverChoice.NumDiffCoeff,
-                               rho_w, rho_w_rhs, mf_u, mf_v, false, false);
+            NumericalDiffusionMom(tbx, tby, tbz, dt, solverChoice.NumDiffCoeff,
+                                  rho_u, rho_v, rho_w,
+                                  rho_u_rhs, rho_v_rhs, rho_w_rhs,
+                                  mf_m, mf_u, mf_v);
         }
 
         auto abl_pressure_grad    = solverChoice.abl_pressure_grad;
@@ -810,7 +828,7 @@ void erf_slow_rhs_pre (int level, int finest_level,
             }
 
             // Add Rayleigh damping
-            if (use_rayleigh_damping && rayleigh_damp_U)
+            if (use_rayleigh_damping && rayleigh_damp_U && k >= rayleigh_klo)
             {
                 Real uu = rho_u(i,j,k) / rho_u_face;
                 rho_u_rhs(i, j, k) -= dptr_rayleigh_tau[k] * (uu - dptr_rayleigh_ubar[k]) * rho_u_face;
@@ -852,7 +870,7 @@ void erf_slow_rhs_pre (int level, int finest_level,
               }
 
               // Add Rayleigh damping
-              if (use_rayleigh_damping && rayleigh_damp_U)
+              if (use_rayleigh_damping && rayleigh_damp_U && k >= rayleigh_klo)
               {
                   Real uu = rho_u(i,j,k) / cell_data(i,j,k,Rho_comp);
                   rho_u_rhs(i, j, k) -= dptr_rayleigh_tau[k] * (uu - dptr_rayleigh_ubar[k]) * cell_data(i,j,k,Rho_comp);
@@ -911,7 +929,7 @@ void erf_slow_rhs_pre (int level, int finest_level,
               }
 
               // Add Rayleigh damping
-              if (use_rayleigh_damping && rayleigh_damp_V)
+              if (use_rayleigh_damping && rayleigh_damp_V && k >= rayleigh_klo)
               {
                   Real vv = rho_v(i,j,k) / rho_v_face;
                   rho_v_rhs(i, j, k) -= dptr_rayleigh_tau[k] * (vv - dptr_rayleigh_vbar[k]) * rho_v_face;
@@ -952,7 +970,7 @@ void erf_slow_rhs_pre (int level, int finest_level,
               }
 
               // Add Rayleigh damping
-              if (use_rayleigh_damping && rayleigh_damp_V)
+              if (use_rayleigh_damping && rayleigh_damp_V && k >= rayleigh_klo)
               {
                   Real vv = rho_v(i,j,k) / rho_v_face;
                   rho_v_rhs(i, j, k) -= dptr_rayleigh_tau[k] * (vv - dptr_rayleigh_vbar[k]) * rho_v_face;
@@ -1003,7 +1021,7 @@ void erf_slow_rhs_pre (int level, int finest_level,
                 }
 
                 // Add Rayleigh damping
-                if (use_rayleigh_damping && rayleigh_damp_W)
+                if (use_rayleigh_damping && rayleigh_damp_W && k >= rayleigh_klo)
                 {
                     Real ww = rho_w(i,j,k) / rho_w_face;
                     rho_w_rhs(i, j, k) -= dptr_rayleigh_tau[k] * (ww - dptr_rayleigh_wbar[k]) * rho_w_face;
@@ -1040,7 +1058,7 @@ void erf_slow_rhs_pre (int level, int finest_level,
                 }
 
                 // Add Rayleigh damping
-                if (use_rayleigh_damping && rayleigh_damp_W)
+                if (use_rayleigh_damping && rayleigh_damp_W && k >= rayleigh_klo)
                 {
                     Real ww = rho_w(i,j,k) / rho_w_face;
                     rho_w_rhs(i, j, k) -= dptr_rayleigh_tau[k] * (ww - dptr_rayleigh_wbar[k]) * rho_w_face;
@@ -1069,6 +1087,12 @@ void erf_slow_rhs_pre (int level, int finest_level,
             }
         } // two-way coupling
         } // end profile
+
+        if (cost) {
+            Gpu::streamSynchronize();
+            wt = amrex::second() - wt;
+            HostDevice::Atomic::Add(&(*cost)[mfi.index()], wt);
+        }
     } // mfi
     } // OMP
 }
@@ -455,6 +455,68 @@ make_J (const amrex::Geometry& geom,
     detJ_cc.FillBoundary(geom.periodicity());
 }
 
+/**
+ * Computation of the metric terms (h_xi, h_eta, h_zeta) at cell-centers and at the
+ * three edge families, cached per level for static terrain so that the strain and
+ * stress kernels read them instead of re-deriving them from z_phys_nd in every stage.
+ * The arrays carry one ghost cell in x and y, the halo of those kernels.
+ */
+void
+make_terrain_metrics (const amrex::Geometry& geom,
+                      amrex::MultiFab& z_phys_nd,
+                      amrex::Vector<std::unique_ptr<amrex::MultiFab>>& terrain_met)
+{
+    const auto dxInv = geom.InvCellSizeArray();
+
+    const BoxArray ba = convert(z_phys_nd.boxArray(), IntVect(0,0,0));
+    const DistributionMapping& dm = z_phys_nd.DistributionMap();
+    const IntVect ngrow(1,1,0);
+
+    terrain_met.resize(MetLoc::NumLocs);
+    terrain_met[MetLoc::CellCenter ] = std::make_unique<MultiFab>(ba                         , dm, TerrMet::NumComps, ngrow);
+    terrain_met[MetLoc::EdgeCenterK] = std::make_unique<MultiFab>(convert(ba,IntVect(1,1,0)), dm, TerrMet::NumComps, ngrow);
+    terrain_met[MetLoc::EdgeCenterJ] = std::make_unique<MultiFab>(convert(ba,IntVect(1,0,1)), dm, TerrMet::NumComps, ngrow);
+    terrain_met[MetLoc::EdgeCenterI] = std::make_unique<MultiFab>(convert(ba,IntVect(0,1,1)), dm, TerrMet::NumComps, ngrow);
+
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for ( amrex::MFIter mfi(*terrain_met[MetLoc::CellCenter], amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi )
+    {
+        amrex::Box bxcc  = mfi.growntilebox(ngrow);
+        amrex::Box bxxy  = mfi.tilebox(IntVect(1,1,0), ngrow);
+        amrex::Box bxxz  = mfi.tilebox(IntVect(1,0,1), ngrow);
+        amrex::Box bxyz  = mfi.tilebox(IntVect(0,1,1), ngrow);
+
+        amrex::Array4<amrex::Real const> z_nd = z_phys_nd.const_array(mfi);
+        amrex::Array4<amrex::Real> met_cc = terrain_met[MetLoc::CellCenter ]->array(mfi);
+        amrex::Array4<amrex::Real> met_ek = terrain_met[MetLoc::EdgeCenterK]->array(mfi);
+        amrex::Array4<amrex::Real> met_ej = terrain_met[MetLoc::EdgeCenterJ]->array(mfi);
+        amrex::Array4<amrex::Real> met_ei = terrain_met[MetLoc::EdgeCenterI]->array(mfi);
+
+        amrex::ParallelFor(bxcc, bxxy, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+            met_cc(i,j,k,TerrMet::h_xi  ) = Compute_h_xi_AtCellCenter   (i,j,k,dxInv,z_nd);
+            met_cc(i,j,k,TerrMet::h_eta ) = Compute_h_eta_AtCellCenter  (i,j,k,dxInv,z_nd);
+            met_cc(i,j,k,TerrMet::h_zeta) = Compute_h_zeta_AtCellCenter (i,j,k,dxInv,z_nd);
+        },
+        [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+            met_ek(i,j,k,TerrMet::h_xi  ) = Compute_h_xi_AtEdgeCenterK  (i,j,k,dxInv,z_nd);
+            met_ek(i,j,k,TerrMet::h_eta ) = Compute_h_eta_AtEdgeCenterK (i,j,k,dxInv,z_nd);
+            met_ek(i,j,k,TerrMet::h_zeta) = Compute_h_zeta_AtEdgeCenterK(i,j,k,dxInv,z_nd);
+        });
+        amrex::ParallelFor(bxxz, bxyz, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+            met_ej(i,j,k,TerrMet::h_xi  ) = Compute_h_xi_AtEdgeCenterJ  (i,j,k,dxInv,z_nd);
+            met_ej(i,j,k,TerrMet::h_eta ) = Compute_h_eta_AtEdgeCenterJ (i,j,k,dxInv,z_nd);
+            met_ej(i,j,k,TerrMet::h_zeta) = Compute_h_zeta_AtEdgeCenterJ(i,j,k,dxInv,z_nd);
+        },
+        [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+            met_ei(i,j,k,TerrMet::h_xi  ) = Compute_h_xi_AtEdgeCenterI  (i,j,k,dxInv,z_nd);
+            met_ei(i,j,k,TerrMet::h_eta ) = Compute_h_eta_AtEdgeCenterI (i,j,k,dxInv,z_nd);
+            met_ei(i,j,k,TerrMet::h_zeta) = Compute_h_zeta_AtEdgeCenterI(i,j,k,dxInv,z_nd);
+        });
+    }
+}
+
 /**
  * Computation of z_phys at cell-center
  */
@@ -53,6 +53,87 @@ function(add_test_r TEST_NAME TEST_EXE PLTFILE)
     )
 endfunction(add_test_r)
 
+# Regression test which must reproduce the gold file of another test exactly
+function(add_test_g TEST_NAME GOLD_NAME TEST_EXE PLTFILE)
+    setup_test()
+    set(PLOT_GOLD ${FCOMPARE_GOLD_FILES_DIRECTORY}/${GOLD_NAME})
+
+    set(TEST_EXE ${CMAKE_BINARY_DIR}/Exec/${TEST_EXE})
+    set(FCOMPARE_TOLERANCE "-r 1e-12 --abs_tol 1.0e-12")
+    set(FCOMPARE_FLAGS "-a ${FCOMPARE_TOLERANCE}")
+    set(test_command sh -c "${MPI_COMMANDS} ${TEST_EXE} ${CURRENT_TEST_BINARY_DIR}/${TEST_NAME}.i ${RUNTIME_OPTIONS} > ${TEST_NAME}.log && ${MPI_FCOMP_COMMANDS} ${FCOMPARE_EXE} ${FCOMPARE_FLAGS} ${PLOT_GOLD} ${CURRENT_TEST_BINARY_DIR}/${PLTFILE}")
+
+    add_test(${TEST_NAME} ${test_command})
+    set_tests_properties(${TEST_NAME}
+        PROPERTIES
+        TIMEOUT 5400
+        PROCESSORS ${NP}
+        WORKING_DIRECTORY "${CURRENT_TEST_BINARY_DIR}/"
+        LABELS "regression"
+        ATTACHED_FILES_ON_FAIL "${CURRENT_TEST_BINARY_DIR}/${TEST_NAME}.log"
+    )
+endfunction(add_test_g)
+
+# Consistency test -- compare with a reference run of the same inputs using REF_OPTIONS
+function(add_test_c TEST_NAME TEST_EXE PLTFILE REF_OPTIONS REF_PLTFILE)
+    setup_test()
+
+    set(TEST_EXE ${CMAKE_BINARY_DIR}/Exec/${TEST_EXE})
+    set(FCOMPARE_TOLERANCE "-r 1e-12 --abs_tol 1.0e-12")
+    set(FCOMPARE_FLAGS "-a ${FCOMPARE_TOLERANCE}")
+    set(test_command sh -c "${MPI_COMMANDS} ${TEST_EXE} ${CURRENT_TEST_BINARY_DIR}/${TEST_NAME}.i ${RUNTIME_OPTIONS} ${REF_OPTIONS} > ${TEST_NAME}_ref.log && ${MPI_COMMANDS} ${TEST_EXE} ${CURRENT_TEST_BINARY_DIR}/${TEST_NAME}.i ${RUNTIME_OPTIONS} > ${TEST_NAME}.log && ${MPI_FCOMP_COMMANDS} ${FCOMPARE_EXE} ${FCOMPARE_FLAGS} ${CURRENT_TEST_BINARY_DIR}/${REF_PLTFILE} ${CURRENT_TEST_BINARY_DIR}/${PLTFILE}")
+
+    add_test(${TEST_NAME} ${test_command})
+    set_tests_properties(${TEST_NAME}
+        PROPERTIES
+        TIMEOUT 5400
+        PROCESSORS ${NP}
+        WORKING_DIRECTORY "${CURRENT_TEST_BINARY_DIR}/"
+        LABELS "regression"
+        ATTACHED_FILES_ON_FAIL "${CURRENT_TEST_BINARY_DIR}/${TEST_NAME}.log"
+    )
+endfunction(add_test_c)
+
+# Log value test -- compare the last value printed after LOG_KEY with a reference run
+# of the same inputs using REF_OPTIONS, up to a relative tolerance REL_TOL
+function(add_test_l TEST_NAME TEST_EXE LOG_KEY REF_OPTIONS REL_TOL)
+    setup_test()
+
+    set(TEST_EXE ${CMAKE_BINARY_DIR}/Exec/${TEST_EXE})
+    set(COMPARE_LOG ${CMAKE_CURRENT_SOURCE_DIR}/compare_log_value.sh)
+    set(test_command sh -c "${MPI_COMMANDS} ${TEST_EXE} ${CURRENT_TEST_BINARY_DIR}/${TEST_NAME}.i ${RUNTIME_OPTIONS} ${REF_OPTIONS} > ${TEST_NAME}_ref.log && ${MPI_COMMANDS} ${TEST_EXE} ${CURRENT_TEST_BINARY_DIR}/${TEST_NAME}.i ${RUNTIME_OPTIONS} > ${TEST_NAME}.log && sh ${COMPARE_LOG} '${LOG_KEY}' ${TEST_NAME}_ref.log ${TEST_NAME}.log ${REL_TOL}")
+
+    add_test(${TEST_NAME} ${test_command})
+    set_tests_properties(${TEST_NAME}
+        PROPERTIES
+        TIMEOUT 5400
+        PROCESSORS ${NP}
+        WORKING_DIRECTORY "${CURRENT_TEST_BINARY_DIR}/"
+        LABELS "regression"
+        ATTACHED_FILES_ON_FAIL "${CURRENT_TEST_BINARY_DIR}/${TEST_NAME}.log"
+    )
+endfunction(add_test_l)
+
+# PBL profile test -- check the logged PBL height and eddy diffusivities against a reference
+# column computed by COMPARE_SCRIPT from the logged mean state, up to a tolerance REL_TOL
+function(add_test_p TEST_NAME TEST_EXE COMPARE_SCRIPT PBL_LOG SURF_LOG REL_TOL)
+    setup_test()
+
+    set(TEST_EXE ${CMAKE_BINARY_DIR}/Exec/${TEST_EXE})
+    set(COMPARE_PBL ${CMAKE_CURRENT_SOURCE_DIR}/${COMPARE_SCRIPT})
+    set(test_command sh -c "${MPI_COMMANDS} ${TEST_EXE} ${CURRENT_TEST_BINARY_DIR}/${TEST_NAME}.i ${RUNTIME_OPTIONS} > ${TEST_NAME}.log && sh ${COMPARE_PBL} ${PBL_LOG} ${SURF_LOG} ${REL_TOL}")
+
+    add_test(${TEST_NAME} ${test_command})
+    set_tests_properties(${TEST_NAME}
+        PROPERTIES
+        TIMEOUT 5400
+        PROCESSORS ${NP}
+        WORKING_DIRECTORY "${CURRENT_TEST_BINARY_DIR}/"
+        LABELS "regression"
+        ATTACHED_FILES_ON_FAIL "${CURRENT_TEST_BINARY_DIR}/${TEST_NAME}.log"
+    )
+endfunction(add_test_p)
+
 # Stationary test -- compare with time 0
 function(add_test_0 TEST_NAME TEST_EXE PLTFILE)
     setup_test()
@@ -123,11 +204,27 @@ add_test_r(ScalarDiffusionGaussian           "RegTests/ScalarAdvDiff/erf_scalar_
 add_test_r(ScalarDiffusionSine               "RegTests/ScalarAdvDiff/erf_scalar_advdiff" "plt00020")
 add_test_r(TaylorGreenAdvecting              "RegTests/TaylorGreenVortex/taylor_green" "plt00010")
 add_test_r(TaylorGreenAdvectingDiffusing     "RegTests/TaylorGreenVortex/taylor_green" "plt00010")
+add_test_r(SquallLine_2D                     "SquallLine_2D/squallline_2d" "plt00020")
+add_test_r(SuperCell                         "SuperCell/super_cell" "plt00020")
+add_test_g(SquallLine_2D_ActiveColumns       "SquallLine_2D" "SquallLine_2D/squallline_2d" "plt00020")
+add_test_g(SuperCell_ActiveColumns           "SuperCell" "SuperCell/super_cell" "plt00020")
+add_test_c(TaylorGreen_MatrixFreeStress     "RegTests/TaylorGreenVortex/taylor_green" "plt00010" "erf.matrix_free_stress=0 erf.plot_file_1=ref" "ref00010")
 add_test_r(MSF_NoSub_IsentropicVortexAdv     "RegTests/IsentropicVortex/erf_isentropic_vortex" "plt00010")
 add_test_r(MSF_Sub_IsentropicVortexAdv       "RegTests/IsentropicVortex/erf_isentropic_vortex" "plt00010")
 
 add_test_0(Deardorff_stationary              "ABL/erf_abl" "plt00010")
 
+add_test_p(YSU_SingleColumn                  "ABL/erf_abl" "compare_ysu_profile.sh" "pbl_profiles" "surf_hist" 1.0e-4)
+
+# LoadBalance does nothing on a single rank
+if(ERF_ENABLE_MPI AND ERF_TEST_NRANKS GREATER 1)
+  add_test_g(DensityCurrent_LoadBalance      DensityCurrent "RegTests/DensityCurrent/density_current" "plt00010")
+endif()
+
+if(ERF_ENABLE_RRTMGP)
+  add_test_l(Radiation_CoarseColumns         "Radiation/radiation" "RAD HEATING" "erf.rad_coarsening_ratio=1" 0.05)
+endif()
+
 #=============================================================================
 # Performance tests
 #=============================================================================
@@ -0,0 +1,28 @@
+#!/bin/sh
+#
+# Compares the last value printed on lines containing KEY in two run logs
+# and fails if their relative difference exceeds TOL.
+#
+# Usage: compare_log_value.sh KEY REF_LOG LOG TOL
+#
+key="$1"
+ref_log="$2"
+log="$3"
+tol="$4"
+
+ref=$(grep "$key" "$ref_log" | tail -n 1 | awk '{print $NF}')
+val=$(grep "$key" "$log"     | tail -n 1 | awk '{print $NF}')
+
+if [ -z "$ref" ] || [ -z "$val" ]; then
+    echo "compare_log_value: no line containing '$key' found"
+    exit 1
+fi
+
+awk -v ref="$ref" -v val="$val" -v tol="$tol" -v key="$key" 'BEGIN {
+    den = (ref < 0) ? -ref : ref
+    if (den == 0) den = 1
+    d = (val - ref) / den
+    if (d < 0) d = -d
+    printf "%s: reference %g, test %g, relative difference %g (tolerance %g)\n", key, ref, val, d, tol
+    exit (d > tol) ? 1 : 0
+}'
@@ -0,0 +1,159 @@
+#!/bin/sh
+#
+# Checks the PBL height and the vertical eddy diffusivities of the YSU scheme
+# against a reference single-column evaluation of Hong, Noh & Dudhia (2006).
+#
+# PBL_LOG is the fifth erf.data_log file (time z u v theta rho Kmv Khv pblh per
+# level, written every step with erf.profile_int = 1) and SURF_LOG the first
+# one (time u_star t_star olen). The diffusivities of the last output were
+# computed from the mean state of the output before it, so the reference is
+# evaluated on that state with the surface scales of the last output. The
+# PBL height must agree to within TOL relative, and the diffusivities to within
+# TOL of their column maximum. Cells of the local closure at the bottom and the
+# top of the column are skipped, their vertical derivatives use the boundary
+# ghost cells.
+#
+# Usage: compare_ysu_profile.sh PBL_LOG SURF_LOG TOL [RIC_STABLE RIC_UNSTABLE]
+#
+pbl_log="$1"
+surf_log="$2"
+tol="$3"
+ric_stable="${4:-0.25}"
+ric_unstable="${5:-0.0}"
+
+surf=$(grep -v "[a-df-z_]" "$surf_log" | tail -n 1)
+if [ -z "$surf" ]; then
+    echo "compare_ysu_profile: no surface scales found in $surf_log"
+    exit 1
+fi
+
+awk -v surf="$surf" -v tol="$tol" -v ric_s="$ric_stable" -v ric_u="$ric_unstable" '
+function max(a,b) { return (a > b) ? a : b }
+function min(a,b) { return (a < b) ? a : b }
+function absv(a)  { return (a < 0) ? -a : a }
+
+# Bulk Richardson PBL height of a parcel with potential temperature theta_s
+function pbl_height(theta_s,    k, rib, rib_m, z_m) {
+    rib_m = 0.0; z_m = z[0]
+    for (k = 0; k < nz; k++) {
+        rib = g * (th[k] - theta_s) * z[k] / (th[0] * max(u[k]*u[k] + v[k]*v[k], 1.0))
+        if (rib >= ric) {
+            k_h = k
+            return (k == 0) ? z[k] : z_m + (ric - rib_m) / (rib - rib_m) * (z[k] - z_m)
+        }
+        rib_m = rib; z_m = z[k]
+    }
+    k_h = nz - 1
+    return z[nz-1]
+}
+
+{
+    if (NF < 9) next
+    t = $1
+    if (t != t_last) {
+        if (nlev_last > 0) {
+            # The previous output becomes the state the diffusivities were computed from
+            for (k = 0; k < nlev_last; k++) {
+                z[k] = lz[k]; u[k] = lu[k]; v[k] = lv[k]; th[k] = lth[k]; rho[k] = lrho[k]
+            }
+            nz = nlev_last; have_prev = 1
+        }
+        t_last = t; nlev_last = 0
+    }
+    k = nlev_last++
+    lz[k] = $2; lu[k] = $3; lv[k] = $4; lth[k] = $5; lrho[k] = $6
+    kmv[k] = $7; khv[k] = $8; pblh[k] = $9
+}
+
+END {
+    if (!have_prev || nz != nlev_last) {
+        print "compare_ysu_profile: need two complete outputs of the PBL profiles"
+        exit 1
+    }
+
+    g = 9.81; kappa = 0.41; eps = 2.220446049250313e-16
+    split(surf, s)
+    u_star = s[2]; t_star = s[3]; olen = s[4]
+    dz = 2.0 * z[0]
+
+    hfx      = -u_star * t_star
+    unstable = (hfx > eps)
+    ric      = (unstable) ? ric_u : ric_s
+    theta0   = th[0]
+
+    h   = pbl_height(th[0])
+    pr0 = 1.0
+    if (unstable) {
+        phi_fac = 1.0 - 16.0 * 0.1 * h / olen
+        ws0     = max(u_star * phi_fac^0.25, 1.0e-3)
+        excess  = min(7.8 * hfx / ws0, 3.0)
+        h       = pbl_height(th[0] + excess)
+        pr0     = phi_fac^(-0.25) + 7.8 * kappa * 0.1
+        pr0     = min(max(pr0, 0.25), 4.0)
+    }
+
+    k_ent = 0.0; delta = 1.0
+    if (unstable) {
+        wm3      = g / theta0 * hfx * h + 5.0 * u_star^3
+        wtheta_h = -0.15 * (theta0 / g) * wm3 / h
+        dthdz_h  = 1.0e-4
+        dtheta   = 1.0e-4 * h
+        if (k_h > 0) {
+            dtheta  = max(th[k_h] - th[k_h-1], dtheta)
+            dthdz_h = max(dtheta / (z[k_h] - z[k_h-1]), 1.0e-4)
+        }
+        ri_conv = g / theta0 * dtheta * h / wm3^(2.0/3.0)
+        delta   = min(h * (0.02 + 0.05 / ri_conv), h)
+        k_ent   = -wtheta_h / dthdz_h
+    }
+
+    kmax_m = 0.0; kmax_h = 0.0
+    for (k = 0; k < nz - 1; k++) {
+        zk = z[k]
+        skip[k] = (zk >= h && k == 0)
+        if (skip[k]) continue
+        if (zk < h) {
+            zs    = min(zk, 0.1 * h)
+            phi_m = (unstable) ? (1.0 - 16.0 * zs / olen)^(-0.25) : 1.0 + 5.0 * zs / olen
+            ws    = max(u_star / phi_m, 1.0e-3)
+            km    = kappa * ws * zk * (1.0 - zk / h)^2
+            pr    = pr0
+            if (zk > 0.1 * h) pr = 1.0 + (pr0 - 1.0) * exp(-3.0 * (zk - 0.1 * h)^2 / (h * h))
+            kh    = km / pr
+        } else {
+            dthdz  = 0.5 * (th[k+1] - th[k-1]) / dz
+            dudz   = 0.5 * (u[k+1] - u[k-1]) / dz
+            dvdz   = 0.5 * (v[k+1] - v[k-1]) / dz
+            shear2 = dudz * dudz + dvdz * dvdz
+            ri     = (g / theta0) * dthdz / max(shear2, eps)
+            l_mix  = 1.0 / (1.0 / (kappa * zk) + 1.0 / 30.0)
+            f_ri   = (ri > 0.0) ? 1.0 / ((1.0 + 5.0 * ri)^2) : sqrt(1.0 - 8.0 * ri)
+            km     = l_mix * l_mix * sqrt(shear2) * f_ri
+            kh     = km
+        }
+        if (unstable) {
+            ke = k_ent * exp(-(zk - h)^2 / (delta * delta))
+            km = max(km, ke); kh = max(kh, ke)
+        }
+        ref_m[k] = rho[k] * km * 0.5
+        ref_h[k] = rho[k] * kh
+        kmax_m = max(kmax_m, ref_m[k]); kmax_h = max(kmax_h, ref_h[k])
+    }
+
+    fail = 0
+    d = absv(pblh[0] - h) / h
+    printf "PBL height: reference %g, test %g, relative difference %g (tolerance %g)\n", h, pblh[0], d, tol
+    if (d > tol) fail = 1
+
+    dm = 0.0; dh = 0.0
+    for (k = 0; k < nz - 1; k++) {
+        if (skip[k]) continue
+        dm = max(dm, absv(kmv[k] - ref_m[k]) / max(kmax_m, eps))
+        dh = max(dh, absv(khv[k] - ref_h[k]) / max(kmax_h, eps))
+    }
+    printf "Kmv: maximum difference %g of the column maximum %g (tolerance %g)\n", dm, kmax_m, tol
+    printf "Khv: maximum difference %g of the column maximum %g (tolerance %g)\n", dh, kmax_h, tol
+    if (dm > tol || dh > tol) fail = 1
+
+    exit fail
+}' "$pbl_log"
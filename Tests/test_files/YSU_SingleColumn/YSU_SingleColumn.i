@@ -0,0 +1,57 @@
+# ------------------  INPUTS TO MAIN PROGRAM  -------------------
+stop_time = 999.9
+max_step = 10
+
+amrex.fpe_trap_invalid = 1
+
+fabarray.mfiter_tile_size = 1024 1024 1024
+
+# PROBLEM SIZE & GEOMETRY
+# (horizontally homogeneous, so every column reproduces the same single-column profile)
+geometry.prob_extent =  4000    4000    2048
+amr.n_cell           =     4       4      64
+
+geometry.is_periodic = 1 1 0
+
+# MOST BOUNDARY WITH A PRESCRIBED (CONVECTIVE) SURFACE HEAT FLUX
+zlo.type                = "Most"
+erf.most.z0             = 0.1
+erf.most.zref           = 16.0
+erf.most.surf_temp_flux = 0.1
+
+zhi.type = "SlipWall"
+
+# TIME STEP CONTROL
+erf.fixed_dt           = 1.0
+
+# DIAGNOSTICS & VERBOSITY
+erf.sum_interval   = 1       # timesteps between computing mass
+erf.profile_int    = 1       # timesteps between writing the mean profiles
+erf.data_log       = surf_hist mean_profiles flux_profiles stress_profiles pbl_profiles
+erf.v              = 1       # verbosity in ERF.cpp
+amr.v              = 1       # verbosity in Amr.cpp
+
+# REFINEMENT / REGRIDDING
+amr.max_level       = 0       # maximum level number allowed
+
+# CHECKPOINT FILES
+erf.check_file      = chk        # root name of checkpoint file
+erf.check_int       = -1         # number of timesteps between checkpoints
+
+# PLOTFILES
+erf.plot_file_1     = plt       # prefix of plotfile name
+erf.plot_int_1      = 10        # number of timesteps between plotfiles
+erf.plot_vars_1     = density x_velocity y_velocity z_velocity pressure theta
+
+# SOLVER CHOICE
+erf.use_gravity = true
+erf.use_coriolis = false
+erf.use_rayleigh_damping = false
+
+erf.molec_diff_type = "None"
+erf.les_type        = "None"
+erf.pbl_type        = "YSU"
+
+# INITIAL PROFILES
+erf.init_type = "input_sounding"
+erf.input_sounding_file = "input_sounding" # mixed layer capped by an inversion at 600 m